@@ -35,15 +35,19 @@ SOURCES += \
 	base64/cencode.cpp \
 	column.cpp \
 	columns.cpp \
-	datablock.cpp \
+	columnstorage.cpp \
 	dataset.cpp \
 	dirs.cpp \
 	filereader.cpp \
+	filterevaluator.cpp \
 	ipcchannel.cpp \
+	jsonserializer.cpp \
 	label.cpp \
 	labels.cpp \
+	numericparser.cpp \
 	processinfo.cpp \
 	sharedmemory.cpp \
+	stringpool.cpp \
 	tempfiles.cpp \
 	utils.cpp \
 	version.cpp \
@@ -70,18 +74,23 @@ HEADERS += \
 	boost/nowide/windows.hpp \
 	column.h \
 	columns.h \
+	columnstorage.h \
 	common.h \
-	datablock.h \
 	dataset.h \
 	dirs.h \
 	filereader.h \
+	filterevaluator.h \
 	ipcchannel.h \
+	jsonserializer.h \
 	label.h \
 	labels.h \
+	numericparser.h \
+	parallelutils.h \
 	libzip/archive.h \
 	libzip/archive_entry.h \
 	processinfo.h \
 	sharedmemory.h \
+	stringpool.h \
 	tempfiles.h \
 	utils.h \
 	version.h \
@@ -25,6 +25,7 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 
 using namespace boost::interprocess;
@@ -42,8 +43,9 @@ Column &Column::operator=(const Column &column)
 		this->_name = column._name;
 		this->_rowCount = column._rowCount;
 		this->_columnType = column._columnType;
-		this->_blocks = column._blocks;
+		this->_storage = column._storage;
 		this->_labels = column._labels;
+		this->_revision++;
 	}
 
 	return *this;
@@ -412,12 +414,18 @@ bool Column::_resetEmptyValuesForNominalText(std::map<int, string> &emptyValuesM
 
 bool Column::resetEmptyValues(std::map<int, string> &emptyValuesMap)
 {
+	bool changed;
+
 	if (_columnType == Column::ColumnTypeOrdinal || _columnType == Column::ColumnTypeNominal)
-		return _resetEmptyValuesForNominal(emptyValuesMap);
+		changed = _resetEmptyValuesForNominal(emptyValuesMap);
 	else if (_columnType == Column::ColumnTypeScale)
-		return _resetEmptyValuesForScale(emptyValuesMap);
+		changed = _resetEmptyValuesForScale(emptyValuesMap);
 	else
-		return _resetEmptyValuesForNominalText(emptyValuesMap);
+		changed = _resetEmptyValuesForNominalText(emptyValuesMap);
+
+	_revision++;
+
+	return changed;
 }
 
 void Column::setSharedMemory(managed_shared_memory *mem)
@@ -589,6 +597,8 @@ bool Column::changeColumnType(Column::ColumnType newColumnType)
 	else
 		success = _changeColumnToNominalOrOrdinal(newColumnType);
 
+	_revision++;
+
 	return success;
 }
 
@@ -721,31 +731,20 @@ bool Column::setColumnAsNominalOrOrdinal(const vector<int> &values, const set<in
 
 bool Column::_setColumnAsNominalOrOrdinal(const vector<int> &values, bool is_ordinal)
 {
-	Ints::iterator	intInputItr			= AsInts.begin();
-	size_t			nb_values			= 0;
-	bool			changedSomething	= false;
+	if(values.size() > _rowCount)
+		throw std::runtime_error("Column::_setColumnAsNominalOrOrdinal ran out of Ints in assigning..");
 
-	for(int value : values)
-	{
-		if(intInputItr == AsInts.end())
-			throw std::runtime_error("Column::_setColumnAsNominalOrOrdinal ran out of Ints in assigning..");
-
-		if(*intInputItr != value)
-			changedSomething = true;
+	int		* ints				= AsInts.data();
+	bool	changedSomething	= _columnType == Column::ColumnTypeScale || !std::equal(values.begin(), values.end(), ints);
 
-		*intInputItr = value;
-		intInputItr++;
-		nb_values++;
-	}
+	setValues(0, values.size(), values.data());
 
-	while (nb_values < _rowCount)
+	for (size_t row = values.size(); row < _rowCount; row++)
 	{
-		if(*intInputItr != INT_MIN)
+		if(ints[row] != INT_MIN)
 			changedSomething = true;
 
-		*intInputItr = INT_MIN;
-		intInputItr++;
-		nb_values++;
+		ints[row] = INT_MIN;
 	}
 
 	setColumnType(is_ordinal ? Column::ColumnTypeOrdinal : Column::ColumnTypeNominal);
@@ -756,22 +755,15 @@ bool Column::_setColumnAsNominalOrOrdinal(const vector<int> &values, bool is_ord
 
 bool Column::setColumnAsScale(const std::vector<double> &values)
 {
-	bool changedSomething = false;
-	_labels.clear();
-	Doubles::iterator doubleInputItr = AsDoubles.begin();
+	if(values.size() > _rowCount)
+		throw std::runtime_error("Column::setColumnAsScale ran out of Doubles in assigning..");
 
-	for(double value : values)
-	{
-		if(doubleInputItr == AsDoubles.end())
-			throw std::runtime_error("Column::setColumnAsScale ran out of Doubles in assigning..");
-
-		if(*doubleInputItr != value) //clang warns us this is unsafe but what does IT know?! If it changes it changes!
-			changedSomething = true;
+	_labels.clear();
 
-		*doubleInputItr = value;
-		doubleInputItr++;
-	}
+	//bitwise comparison, so that a NaN that stays a NaN does not count as a change.
+	bool changedSomething = _columnType != Column::ColumnTypeScale || (!values.empty() && std::memcmp(AsDoubles.data(), values.data(), values.size() * sizeof(double)) != 0);
 
+	setValues(0, values.size(), values.data());
 	setColumnType(Column::ColumnTypeScale);
 
 	return changedSomething;
@@ -841,6 +833,51 @@ std::map<int, std::string> Column::setColumnAsNominalText(const std::vector<std:
 	return emptyValuesMap;
 }
 
+std::map<int, std::string> Column::setColumnAsNominalText(const std::vector<std::string> &dictionary, const std::vector<int> &indices)
+{
+	// Same as setColumnAsNominalText(values) for values[row] == dictionary[indices[row]], but every distinct text is only looked at once
+	std::vector<std::string>	sortedCases;
+	std::vector<bool>			isEmpty(dictionary.size());
+
+	for (size_t i = 0; i < dictionary.size(); i++)
+	{
+		isEmpty[i] = isEmptyValue(dictionary[i]);
+		if (!isEmpty[i])
+			sortedCases.push_back(dictionary[i]);
+	}
+
+	std::sort(sortedCases.begin(), sortedCases.end());
+	sortedCases.erase(std::unique(sortedCases.begin(), sortedCases.end()), sortedCases.end());
+
+	std::map<std::string, int>	map = _labels.syncStrings(sortedCases, std::map<std::string, std::string>(), NULL);
+	std::vector<int>			keys(dictionary.size(), INT_MIN);
+
+	for (size_t i = 0; i < dictionary.size(); i++)
+		if (!isEmpty[i])
+			keys[i] = map[dictionary[i]];
+
+	if (indices.size() > _rowCount)
+		throw std::runtime_error("Column::setColumnAsNominalText ran out of Ints in assigning..");
+
+	std::map<int, std::string>	emptyValuesMap;
+	int							*ints = AsInts.data();
+
+	for (size_t row = 0; row < indices.size(); row++)
+	{
+		int index	= indices[row];
+		ints[row]	= keys[index];
+
+		if (isEmpty[index] && !dictionary[index].empty())
+			emptyValuesMap.insert(make_pair(int(row), dictionary[index]));
+	}
+
+	std::fill(ints + indices.size(), ints + _rowCount, INT_MIN);
+
+	setColumnType(Column::ColumnTypeNominalText);
+
+	return emptyValuesMap;
+}
+
 string Column::_getLabelFromKey(int key) const
 {
 	if (key == INT_MIN)
@@ -872,36 +909,26 @@ void Column::setName(string name)
 
 void Column::setValue(int row, int value)
 {
-	BlockMap::iterator itr = _blocks.upper_bound(row);
-
-	if (itr == _blocks.end())
+	if (row < 0 || size_t(row) >= _rowCount)
 	{
 		//qDebug() << "Column::setValue(), bad rowIndex";
 		return;
 	}
 
-	int blockId = itr->first;
-	DataBlock *block = itr->second.get();
-
-	int blockIndex = row - blockId + DataBlock::capacity();
-	block->Data[blockIndex].i = value;
+	AsInts[row] = value;
+	_revision++;
 }
 
 void Column::setValue(int row, double value)
 {
-	BlockMap::iterator itr = _blocks.upper_bound(row);
-
-	if (itr == _blocks.end())
+	if (row < 0 || size_t(row) >= _rowCount)
 	{
 		//qDebug() << "Column::setValue(), bad rowIndex";
 		return;
 	}
 
-	int blockId = itr->first;
-	DataBlock *block = itr->second.get();
-
-	int blockIndex = row - blockId + DataBlock::capacity();
-	block->Data[blockIndex].d = value;
+	AsDoubles[row] = value;
+	_revision++;
 }
 
 bool Column::isValueEqual(int row, double value)
@@ -990,7 +1017,7 @@ bool Column::isValueEqual(int row, const string &value)
 			}
 			else
 			{
-				result = (value.substr(0, 128) == _labels.getValueFromKey(key));
+				result = (value == _labels.getValueFromKey(key));
 			}
 		}
 
@@ -1019,7 +1046,8 @@ string Column::_getScaleValue(int row)
 	}
 	else
 	{
-		stringstream s;
+		static thread_local stringstream s; //Setting up a stream costs more than the formatting itself, and the dataviewer does this for every cell it shows
+		s.str("");
 		s << v;
 		return s.str();
 	}
@@ -1071,107 +1099,107 @@ string Column::operator [](int row)
 
 void Column::append(int rows)
 {
-	if (rows == 0)
+	if (rows <= 0)
 		return;
 
-	BlockMap::reverse_iterator itr = _blocks.rbegin();
-
-	if (itr == _blocks.rend()) // no blocks
+	try
 	{
-		ull firstId = DataBlock::capacity();
-		DataBlock *firstBlock = _mem->construct<DataBlock>(anonymous_instance)();
-
-		_blocks.insert(BlockEntry(firstId, firstBlock));
-		itr = _blocks.rbegin();
+		_storage.reserve(_mem, _rowCount + rows);
+	}
+	catch (boost::interprocess::bad_alloc &e)
+	{
+		cout << e.what() << " ";
+		cout << "append column " << name() << ", append: " << rows << ", rowCount: " << _rowCount << std::endl;
+		throw e;
 	}
 
-	BlockEntry entry = *itr;
-	DataBlock *block = entry.second.get();
-	ull id = entry.first;
+	_rowCount += rows;
+	_revision++;
+}
+
+void Column::truncate(int rows)
+{
+	if (rows <= 0) return;
 
-	int room = DataBlock::capacity() - block->rowCount();
-	int rowsLeft = rows - room;
-	if (rowsLeft <= 0)
+	if (size_t(rows) > _rowCount)
 	{
-		block->insert(rows);
-		_rowCount += rows;
-		return;
+		std::cout << "Try to erase more rows than existing!!" << std::endl;
+		std::cout.flush();
+		rows = _rowCount;
 	}
 
-	block->insert(room);
-	_rowCount += room;
+	//The storage keeps its capacity, so growing the column back again does not need a reallocation.
+	_rowCount -= rows;
+	_revision++;
+}
 
-	int newBlocksRequired = rowsLeft / DataBlock::capacity();
-	if (rowsLeft % DataBlock::capacity())
-		newBlocksRequired++;
+size_t Column::getValues(size_t firstRow, size_t count, int * values) const
+{
+	if (count == 0 || firstRow >= _rowCount)
+		return 0;
 
-	for (int i = 0; i < newBlocksRequired; i++)
-	{
-		try {
+	count = std::min(count, _rowCount - firstRow);
+	std::memcpy(values, _storage.ints() + firstRow, count * sizeof(int));
 
-		DataBlock *newBlock = _mem->construct<DataBlock>(anonymous_instance)();
+	return count;
+}
 
-		int toInsert = min(rowsLeft, DataBlock::capacity());
-		newBlock->insert(toInsert);
-		rowsLeft -= toInsert;
+size_t Column::getValues(size_t firstRow, size_t count, double * values) const
+{
+	if (count == 0 || firstRow >= _rowCount)
+		return 0;
 
-		id += DataBlock::capacity();
-		_blocks.insert(BlockEntry(id, newBlock));
+	count = std::min(count, _rowCount - firstRow);
+	std::memcpy(values, _storage.doubles() + firstRow, count * sizeof(double));
 
-		_rowCount += toInsert;
+	return count;
+}
 
-		}
-		catch (boost::interprocess::bad_alloc &e)
-		{
-			cout << e.what() << " ";
-			cout << "append column " << name() << ", append: " << rows << ", rowCount: " << _rowCount << std::endl;
-			throw e;
-		}
-	}
+size_t Column::setValues(size_t firstRow, size_t count, const int * values)
+{
+	if (count == 0 || firstRow >= _rowCount)
+		return 0;
+
+	count = std::min(count, _rowCount - firstRow);
+	std::memcpy(_storage.ints() + firstRow, values, count * sizeof(int));
+	_revision++;
+
+	return count;
 }
 
-void Column::truncate(int rows)
+size_t Column::setValues(size_t firstRow, size_t count, const double * values)
 {
-	if (rows <= 0) return;
+	if (count == 0 || firstRow >= _rowCount)
+		return 0;
+
+	count = std::min(count, _rowCount - firstRow);
+	std::memcpy(_storage.doubles() + firstRow, values, count * sizeof(double));
+	_revision++;
 
-	BlockMap::reverse_iterator itr = _blocks.rbegin();
-	DataBlock *block = itr->second.get();
+	return count;
+}
 
-	int rowsToDelete = rows;
+void Column::visitChunks(ChunkVisitor visitor, size_t rowsPerChunk) const
+{
+	if (rowsPerChunk == 0)
+		rowsPerChunk = _rowCount;
 
-	if (rowsToDelete > _rowCount)
-		rowsToDelete = _rowCount;
+	const char	* data		= _columnType == ColumnTypeScale ? reinterpret_cast<const char*>(_storage.doubles()) : reinterpret_cast<const char*>(_storage.ints());
+	size_t		valueBytes	= valueSize();
 
-	while (rowsToDelete > 0)
+	for (size_t firstRow = 0; firstRow < _rowCount; firstRow += rowsPerChunk)
 	{
-		if (block->rowCount() >= rowsToDelete)
-		{
-			block->erase(rowsToDelete);
-			_rowCount -= rowsToDelete;
-			rowsToDelete = 0;
-		}
-		else
-		{
-			rowsToDelete -= block->rowCount();
-			_rowCount -= block->rowCount();
-			block->erase(block->rowCount());
-			//_mem->destroy_ptr<DataBlock>(block);
-			itr++;
-			if (itr == _blocks.rend())
-			{
-				std::cout << "Try to erase more blocks than existing!!" << std::endl;
-				std::cout.flush();
-				rowsToDelete = 0;
-				_rowCount = 0;
-			}
-			else
-			{
-				block = itr->second.get();
-			}
-		}
+		size_t rows = std::min(rowsPerChunk, _rowCount - firstRow);
+		visitor(data + firstRow * valueBytes, rows * valueBytes, firstRow, rows);
 	}
 }
 
+void Column::_releaseStorage()
+{
+	_storage.release(_mem);
+	_rowCount = 0;
+}
+
 
 
 string Column::columnTypeToString(ColumnType type)
@@ -1198,6 +1226,7 @@ Column::ColumnType Column::columnTypeFromString(std::string type)
 void Column::setColumnType(Column::ColumnType columnType)
 {
 	_columnType = columnType;
+	_revision++;
 }
 
 void Column::_setRowCount(int rowCount)
@@ -1226,83 +1255,36 @@ int& Column::IntsStruct::operator [](int rowIndex)
 {
 	Column* parent = getParent();
 
-	BlockMap::iterator itr = parent->_blocks.upper_bound(rowIndex);
-
-	if (itr == parent->_blocks.end())
+	if (rowIndex < 0 || size_t(rowIndex) >= parent->_rowCount)
 	{
 		std::cout << "Column::Ints[], bad rowIndex: " << rowIndex << std::endl;
-		std::cout << "Nb of blocks: " << parent->_blocks.size() << std::endl;
+		std::cout << "Nb of rows: " << parent->_rowCount << std::endl;
 		std::cout.flush();
 	}
 
-	int blockId = itr->first;
-	DataBlock *block = itr->second.get();
-
-	int pos = rowIndex - blockId + DataBlock::capacity();
-	return block->Data[pos].i;
+	return parent->_storage.ints()[rowIndex];
 }
 
-Column::Ints::iterator Column::Ints::begin()
+int *Column::Ints::data()
 {
-	Column *parent = getParent();
-	BlockMap::iterator itr = parent->_blocks.begin();
-	return iterator(itr, 0);
+	return getParent()->_storage.ints();
 }
 
-Column::Ints::iterator Column::Ints::end()
+size_t Column::Ints::size() const
 {
-	BlockMap::iterator itr = getParent()->_blocks.end();
-	return iterator(itr, 0);
+	return getParent()->_rowCount;
 }
 
-Column::Ints::iterator::iterator(BlockMap::iterator blockItr, int pos)
-{
-	_blockItr = blockItr;
-	_currentPos = pos;
-}
-
-void Column::Ints::iterator::increment()
-{
-	_currentPos++;
-
-	if (_currentPos >= _blockItr->second->rowCount())
-	{
-		_blockItr++;
-		_currentPos = 0;
-	}
-}
-
-bool Column::Ints::iterator::equal(iterator const& other) const
-{
-	return this->_currentPos == other._currentPos && this->_blockItr == other._blockItr;
-}
-
-int& Column::Ints::iterator::dereference() const
-{
-	return _blockItr->second->Data[_currentPos].i;
-}
-
-Column::Doubles::iterator Column::Doubles::begin()
-{
-	Column *parent = getParent();
-	BlockMap::iterator itr = parent->_blocks.begin();
-	return iterator(itr, 0);
-}
-
-Column::Doubles::iterator Column::Doubles::end()
+Column::Ints::iterator Column::Ints::begin()
 {
-	Column *parent = getParent();
-	BlockMap::iterator itr = parent->_blocks.end();
-	return iterator(itr, 0);
+	return data();
 }
 
-Column::Doubles::iterator::iterator(BlockMap::iterator blockItr, int pos)
+Column::Ints::iterator Column::Ints::end()
 {
-	_blockItr = blockItr;
-	_currentPos = pos;
+	return data() + size();
 }
 
-
 Column *Column::DoublesStruct::getParent() const
 {
 	// This code seems quite weird... but this is a technique to get the address of the parent object from
@@ -1322,39 +1304,32 @@ double& Column::DoublesStruct::operator [](int rowIndex)
 {
 	Column *parent = getParent();
 
-	BlockMap::iterator itr = parent->_blocks.upper_bound(rowIndex);
-
-	if (itr == parent->_blocks.end())
+	if (rowIndex < 0 || size_t(rowIndex) >= parent->_rowCount)
 	{
-		//qDebug() << "Column::Ints[], bad rowIndex";
+		//qDebug() << "Column::Doubles[], bad rowIndex";
 	}
 
-	int blockId = itr->first;
-	DataBlock *block = itr->second.get();
-
-	int pos = rowIndex - blockId + DataBlock::capacity();
-	return block->Data[pos].d;
+	return parent->_storage.doubles()[rowIndex];
 }
 
-void Column::Doubles::iterator::increment()
+double *Column::Doubles::data()
 {
-	_currentPos++;
+	return getParent()->_storage.doubles();
+}
 
-	if (_currentPos >= _blockItr->second->rowCount())
-	{
-		_blockItr++;
-		_currentPos = 0;
-	}
+size_t Column::Doubles::size() const
+{
+	return getParent()->_rowCount;
 }
 
-bool Column::Doubles::iterator::equal(iterator const& other) const
+Column::Doubles::iterator Column::Doubles::begin()
 {
-	return this->_currentPos == other._currentPos && this->_blockItr == other._blockItr;
+	return data();
 }
 
-double& Column::Doubles::iterator::dereference() const
+Column::Doubles::iterator Column::Doubles::end()
 {
-	return _blockItr->second->Data[_currentPos].d;
+	return data() + size();
 }
 
 bool Column::allLabelsPassFilter() const
@@ -24,8 +24,9 @@
 #include <boost/container/map.hpp>
 #include <boost/container/string.hpp>
 #include <boost/container/vector.hpp>
+#include <boost/function.hpp>
 
-#include "datablock.h"
+#include "columnstorage.h"
 #include "labels.h"
 
 
@@ -38,12 +39,6 @@ class Column
 	friend class DataSetLoader;
 	friend class boost::iterator_core_access;
 
-	typedef unsigned long long ull;
-	typedef boost::interprocess::allocator<boost::interprocess::offset_ptr<DataBlock>, boost::interprocess::managed_shared_memory::segment_manager> BlockAllocator;
-	typedef boost::container::map<ull, boost::interprocess::offset_ptr<DataBlock>, BlockAllocator>::value_type BlockEntry;
-	typedef boost::interprocess::allocator<BlockEntry, boost::interprocess::managed_shared_memory::segment_manager> BlockEntryAllocator;
-	typedef boost::container::map<ull, boost::interprocess::offset_ptr<DataBlock>, std::less<ull>, BlockEntryAllocator> BlockMap;
-
 	typedef boost::interprocess::allocator<char, boost::interprocess::managed_shared_memory::segment_manager> CharAllocator;
 	typedef boost::container::basic_string<char, std::char_traits<char>, CharAllocator> String;
 	typedef boost::interprocess::allocator<String, boost::interprocess::managed_shared_memory::segment_manager> StringAllocator;
@@ -70,30 +65,16 @@ public:
 	{
 		friend class Column;
 
-		class iterator : public boost::iterator_facade<
-				iterator, int, boost::forward_traversal_tag>
-		{
-			friend class boost::iterator_core_access;
-
-		public:
-
-			explicit iterator(BlockMap::iterator blockItr, int currentPos);
-
-		private:
-
-			void increment();
-			bool equal(iterator const& other) const;
-			int& dereference() const;
-
-			BlockMap::iterator _blockItr;
-			int _currentPos;
-		};
+		typedef int * iterator;
 
 		int& operator[](int index);
 
 		iterator begin();
 		iterator end();
 
+		int		*data();
+		size_t	size() const;
+
 		IntsStruct();
 
 	private:
@@ -106,32 +87,16 @@ public:
 	{
 		friend class Column;
 
-		class iterator : public boost::iterator_facade<
-				iterator, double, boost::forward_traversal_tag>
-		{
-
-			friend class boost::iterator_core_access;
-
-		public:
-
-			explicit iterator(BlockMap::iterator blockItr, int currentPos);
-
-		private:
-
-			void increment();
-			bool equal(iterator const& other) const;
-			double& dereference() const;
-
-			BlockMap::iterator _blockItr;
-			int _currentPos;
-
-		};
+		typedef double * iterator;
 
 		double& operator[](int index);
 
 		iterator begin();
 		iterator end();
 
+		double	*data();
+		size_t	size() const;
+
 	private:
 		DoublesStruct() {}
 
@@ -139,12 +104,12 @@ public:
 
 	} Doubles;
 
-	Column(boost::interprocess::managed_shared_memory *mem)  : _mem(mem), _name(mem->get_segment_manager()), _columnType(Column::ColumnTypeNominal), _rowCount(0), _blocks(std::less<ull>(), mem->get_segment_manager()), _labels(mem)
+	Column(boost::interprocess::managed_shared_memory *mem)  : _mem(mem), _name(mem->get_segment_manager()), _columnType(Column::ColumnTypeNominal), _rowCount(0), _labels(mem)
 	{
 		_id = ++count;
 	}
 
-	Column(const Column& col) : _mem(col._mem), _name(col._name), _columnType(col._columnType), _rowCount(col._rowCount), _blocks(col._blocks), _labels(col._labels)
+	Column(const Column& col) : _mem(col._mem), _name(col._name), _columnType(col._columnType), _rowCount(col._rowCount), _storage(col._storage), _labels(col._labels), _revision(col._revision)
 	{
 		_id = ++count;
 	}
@@ -168,6 +133,19 @@ public:
 	void append(int rows);
 	void truncate(int rows);
 
+	// Bulk access to the stored values: a whole range of rows is copied in one go instead of row by row.
+	// Ranges are clipped to rowCount() and the number of rows actually copied is returned.
+	size_t getValues(size_t firstRow, size_t count, int		* values) const;
+	size_t getValues(size_t firstRow, size_t count, double	* values) const;
+	size_t setValues(size_t firstRow, size_t count, const int		* values);
+	size_t setValues(size_t firstRow, size_t count, const double	* values);
+
+	// Calls visitor for consecutive chunks of at most rowsPerChunk rows (0 means all rows at once) with the raw stored values,
+	// ints for Nominal, NominalText & Ordinal and doubles for Scale. valueSize() gives the size of one such value.
+	typedef boost::function<void(const char * data, size_t bytes, size_t firstRow, size_t rows)> ChunkVisitor;
+	void	visitChunks(ChunkVisitor visitor, size_t rowsPerChunk = 0) const;
+	size_t	valueSize() const { return _columnType == ColumnTypeScale ? sizeof(double) : sizeof(int); }
+
 	// If the column is a scale, it uses the AsDoubles which is a mapping between the row numbers and the double values.
 	// Scale columns do not have labels.
 	// It the column is Nominal. NominalText or Ordinal, it uses the AsInts structure
@@ -178,7 +156,7 @@ public:
 	// The AsInts is then a mapping between the row numbers and these keys. In this case, if the label of one value
 	// is modified, the new value is in the label object, and the original string value is kept in another mapping
 	// structure (cf. labels.h).
-	// Both AsDoubles & AsInts get their space from the BlockMap _blocks which is a mapping of DataBlock.
+	// Both AsDoubles & AsInts are views on the same contiguous ColumnStorage _storage, so indexing is O(1) and data() gives a plain array of rowCount() values.
 	Doubles AsDoubles;
 	Ints AsInts;
 
@@ -194,6 +172,9 @@ public:
 
 	size_t rowCount() const { return _rowCount; }
 
+	// Goes up whenever the values, type or labels of this column change, the Engine uses it to see whether the columns it handed to R before are still valid.
+	unsigned int revision() const { return _revision + _labels.revision(); }
+
 	Labels& labels();
 
 	Column &operator=(const Column &columns);
@@ -204,6 +185,7 @@ public:
 
 	std::map<int, std::string>	setColumnAsNominalText(const std::vector<std::string> &values,	const std::map<std::string, std::string> &labels, bool * changedSomething = NULL);
 	std::map<int, std::string>	setColumnAsNominalText(const std::vector<std::string> &values, bool * changedSomething = NULL);
+	std::map<int, std::string>	setColumnAsNominalText(const std::vector<std::string> &dictionary, const std::vector<int> &indices);
 
 	bool						setColumnAsNominalOrOrdinal(const std::vector<int> &values,		const std::set<int> &uniqueValues,			bool is_ordinal = false);
 	bool						setColumnAsNominalOrOrdinal(const std::vector<int> &values,		std::map<int, std::string> &uniqueValues,	bool is_ordinal = false);
@@ -225,13 +207,15 @@ private:
 	ColumnType _columnType;
 	size_t _rowCount;
 
-	BlockMap _blocks;
+	ColumnStorage _storage;
 	Labels _labels;
+	unsigned int _revision = 0;
 
 	int _id;
 	static int count;
 
 	void _setRowCount(int rowCount);
+	void _releaseStorage();
 	std::string _getLabelFromKey(int key) const;
 	std::string _getScaleValue(int row);
 
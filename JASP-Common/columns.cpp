@@ -74,6 +74,7 @@ void Columns::removeColumn(size_t index)
 	for (ColumnVector::iterator it = _columnStore.begin(); it != _columnStore.end(); ++it, --index)
 		if (index == 0)
 		{
+			it->_releaseStorage();
 			_columnStore.erase(it);
 			return;
 		}
@@ -84,6 +85,7 @@ void Columns::removeColumn(std::string name)
 	for (ColumnVector::iterator it = _columnStore.begin(); it != _columnStore.end(); ++it)
 		if((*it).name() == name)
 		{
+			it->_releaseStorage();
 			_columnStore.erase(it);
 			return;
 		}
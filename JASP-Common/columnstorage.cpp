@@ -0,0 +1,51 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "columnstorage.h"
+
+#include <algorithm>
+#include <cstring>
+
+void ColumnStorage::reserve(boost::interprocess::managed_shared_memory *mem, size_t rows)
+{
+	if (rows <= _capacity)
+		return;
+
+	// The first reservation is exact (importers know their rowcount up front), after that we grow geometrically so appending rows one by one stays cheap.
+	size_t newCapacity = _capacity == 0 ? rows : std::max(rows, _capacity + _capacity / 2);
+
+	// allocate before touching anything, so that a bad_alloc leaves the storage as it was and the caller can enlarge the shared memory and retry.
+	char *newData = static_cast<char*>(mem->allocate(newCapacity * bytesPerRow()));
+
+	if (_data)
+	{
+		std::memcpy(newData, _data.get(), _capacity * bytesPerRow());
+		mem->deallocate(_data.get());
+	}
+
+	_data		= newData;
+	_capacity	= newCapacity;
+}
+
+void ColumnStorage::release(boost::interprocess::managed_shared_memory *mem)
+{
+	if (_data)
+		mem->deallocate(_data.get());
+
+	_data		= NULL;
+	_capacity	= 0;
+}
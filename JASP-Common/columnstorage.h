@@ -0,0 +1,53 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef COLUMNSTORAGE_H
+#define COLUMNSTORAGE_H
+
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/offset_ptr.hpp>
+
+/*********
+ * ColumnStorage holds the values of one column as a single contiguous array in shared memory.
+ * The array is reserved with room for a double per row, so a column can be seen either as a packed
+ * array of ints (Nominal, NominalText & Ordinal) or as an array of doubles (Scale) and can change its
+ * type in place without having to reallocate.
+ * Growing the storage reallocates the array and copies the existing values, so pointers obtained
+ * from ints() or doubles() are only valid until the next call to reserve().
+ * Because it lives in the shared memory it only stores an offset_ptr, the segment is passed in where needed.
+ *********/
+
+class ColumnStorage
+{
+public:
+	ColumnStorage() {}
+
+	int		*ints()		const	{ return reinterpret_cast<int*>(_data.get());		}
+	double	*doubles()	const	{ return reinterpret_cast<double*>(_data.get());	}
+	size_t	capacity()	const	{ return _capacity;									}
+
+	void reserve(boost::interprocess::managed_shared_memory *mem, size_t rows);
+	void release(boost::interprocess::managed_shared_memory *mem);
+
+	static size_t bytesPerRow() { return sizeof(double); }
+
+private:
+	boost::interprocess::offset_ptr<char>	_data;
+	size_t									_capacity = 0;
+};
+
+#endif // COLUMNSTORAGE_H
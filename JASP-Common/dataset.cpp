@@ -16,6 +16,7 @@
 //
 
 #include "dataset.h"
+#include <bitset>
 
 using namespace std;
 /* DataSet is implemented as a set of columns */
@@ -27,9 +28,11 @@ void DataSet::setRowCount(size_t newRowCount)
 	{
 		_columns.setRowCount(newRowCount);
 
-		_filterVector.clear();
-		for(size_t i=0; i<newRowCount; i++)
-			_filterVector.push_back(true);
+		_filterVector.reset(newRowCount);
+		_pendingFilter.reset(newRowCount);
+		_filteredRowCount			= int(newRowCount);
+		_pendingFilterGeneration	= -1;
+		_filterRevision++;
 	}
 }
 
@@ -42,14 +45,25 @@ void DataSet::setColumnCount(size_t newColumnCount)
 	}
 }
 
+DataSet::~DataSet()
+{
+	_mem->destroy<StringPool>(boost::interprocess::unique_instance); //The label texts belong to this DataSet
+}
+
 void DataSet::setSharedMemory(boost::interprocess::managed_shared_memory *mem)
 {
 	_mem = mem;
 	_columns.setSharedMemory(mem);
 
-	_filterVector = BoolVector(mem->get_segment_manager());
-	for(size_t i=0; i<maxRowCount(); i++)
-		_filterVector.push_back(true);
+	if(_filterVector.size() != maxRowCount())
+	{
+		_filterVector.reset(maxRowCount());
+		_filteredRowCount = int(maxRowCount());
+		_filterRevision++;
+	}
+
+	if(_pendingFilter.size() != maxRowCount())
+		_pendingFilter.reset(maxRowCount());
 }
 
 
@@ -95,10 +109,88 @@ vector<string> DataSet::resetEmptyValues(map<string, map<int, string> > emptyVal
 
 void DataSet::setFilterVector(std::vector<bool> filterResult)
 {
-	_filteredRowCount = 0;
-	for(size_t i=0; i<filterResult.size(); i++)
-		if((_filterVector[i] = filterResult[i])) //economy
-			_filteredRowCount++;
+	filterResult.resize(_filterVector.size(), false);
+	_filteredRowCount = int(_filterVector.pack(filterResult));
+	_filterRevision++;
+}
+
+bool DataSet::setPendingFilter(std::vector<bool> filterResult, int generation)
+{
+	if(filterResult.size() > _pendingFilter.size() || _pendingFilter.size() != _filterVector.size())
+		return false;
+
+	filterResult.resize(_pendingFilter.size(), false);
+	_pendingFilteredRowCount = int(_pendingFilter.pack(filterResult));
+	_pendingFilterGeneration = generation;
+
+	return true;
+}
+
+bool DataSet::applyPendingFilter(int generation)
+{
+	if(_pendingFilterGeneration != generation || _pendingFilter.size() != _filterVector.size())
+		return false;
+
+	_filterVector.swap(_pendingFilter);
+	_filteredRowCount			= _pendingFilteredRowCount;
+	_pendingFilterGeneration	= -1;
+	_filterRevision++;
+
+	return true;
+}
+
+void FilterBits::reset(size_t rows, bool pass)
+{
+	_words.assign((rows + 63) / 64, pass ? ~uint64_t(0) : uint64_t(0));
+	_rows = rows;
+
+	if(pass && rows % 64 != 0) //Keep the bits past the end at zero so count() stays right
+		_words.back() = (uint64_t(1) << (rows % 64)) - 1;
+}
+
+size_t FilterBits::pack(const std::vector<bool> & rows)
+{
+	size_t passed = 0;
+
+	for(size_t word = 0; word < _words.size(); word++)
+	{
+		uint64_t	bits	= 0;
+		size_t		first	= word * 64,
+					last	= std::min(first + 64, _rows);
+
+		for(size_t row = first; row < last; row++)
+			if(rows[row])
+			{
+				bits |= uint64_t(1) << (row - first);
+				passed++;
+			}
+
+		_words[word] = bits;
+	}
+
+	return passed;
+}
+
+size_t FilterBits::count() const
+{
+	size_t passed = 0;
+
+	for(uint64_t word : _words)
+		passed += std::bitset<64>(word).count();
+
+	return passed;
+}
+
+size_t FilterBits::rowNumbers(size_t rowCount, int * out, size_t outRows) const
+{
+	size_t written = 0;
+
+	//Every row is looked at until out is full, rows that are filtered away don't take up any of it
+	for(size_t row = 0; row < rowCount && written < outRows; row++)
+		if(row < _rows && (*this)[row])
+			out[written++] = int(row + 1);
+
+	return written;
 }
 
 bool DataSet::allColumnsPassFilter() const
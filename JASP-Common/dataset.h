@@ -22,8 +22,30 @@
 #include <iostream>
 #include "columns.h"
 
-typedef boost::interprocess::allocator<bool, boost::interprocess::managed_shared_memory::segment_manager> BoolAllocator;
-typedef boost::container::vector<bool, BoolAllocator> BoolVector;
+typedef boost::interprocess::allocator<uint64_t, boost::interprocess::managed_shared_memory::segment_manager> FilterWordAllocator;
+typedef boost::container::vector<uint64_t, FilterWordAllocator> FilterWords;
+
+///Which rows pass the filter, packed as one bit per row.
+class FilterBits
+{
+public:
+	FilterBits(boost::interprocess::managed_shared_memory::segment_manager * manager) : _words(manager) {}
+
+	size_t				size()					const	{ return _rows; }
+	bool				operator[](size_t row)	const	{ return (_words[row >> 6] >> (row & 63)) & 1; }
+	const uint64_t *	words()					const	{ return _words.data(); }
+	size_t				wordCount()				const	{ return _words.size(); }
+
+	void				reset(size_t rows, bool pass = true);
+	size_t				pack(const std::vector<bool> & rows);	///< Returns how many rows passed, rows must have size() elements
+	size_t				count() const;
+	size_t				rowNumbers(size_t rowCount, int * out, size_t outRows) const;	///< Writes the 1-based numbers of the rows below rowCount that pass, for R, and returns how many were written
+	void				swap(FilterBits & other)				{ _words.swap(other._words); std::swap(_rows, other._rows); }
+
+private:
+	FilterWords			_words;
+	size_t				_rows = 0;
+};
 
 class DataSet
 {
@@ -31,8 +53,8 @@ class DataSet
 
 public:
 
-	DataSet(boost::interprocess::managed_shared_memory *mem) : _columns(mem), _filterVector(mem->get_segment_manager()), _mem(mem) { }
-	~DataSet() {}
+	DataSet(boost::interprocess::managed_shared_memory *mem) : _columns(mem), _filterVector(mem->get_segment_manager()), _pendingFilter(mem->get_segment_manager()), _mem(mem) { }
+	~DataSet();
 
 	size_t minRowCount()	const { return _columns.minRowCount(); }
 	size_t maxRowCount()	const { return _columns.maxRowCount(); }
@@ -54,8 +76,15 @@ public:
 	std::vector<std::string> resetEmptyValues(emptyValsType emptyValuesMap);
 
 	void				setFilterVector(std::vector<bool> filterResult);
-	const BoolVector&	filterVector()		const	{ return _filterVector; }
+	const FilterBits&	filterVector()		const	{ return _filterVector; }
 	int					filteredRowCount()	const	{ return _filteredRowCount; }
+	unsigned int		filterRevision()	const	{ return _filterRevision; } ///< Goes up whenever the filterVector changes, like Column::revision()
+	unsigned int		generation()		const	{ return _generation; } ///< Different for every DataSet SharedMemory::createDataSet makes, so a new one at the address of a deleted one can be told apart
+	void				setGeneration(unsigned int generation)	{ _generation = generation; }
+
+	//The engine writes its filter result here without allocating anything, the desktop then applies it if it is still the one it wants
+	bool				setPendingFilter(std::vector<bool> filterResult, int generation);
+	bool				applyPendingFilter(int generation);
 
 	bool allColumnsPassFilter()				const;
 	bool synchingData()						const	{ return _synchingData; }
@@ -63,8 +92,13 @@ public:
 
 private:
 	Columns			_columns;
-	int				_filteredRowCount = 0;
-	BoolVector		_filterVector;
+	int				_filteredRowCount			= 0,
+					_pendingFilteredRowCount	= 0,
+					_pendingFilterGeneration	= -1;
+	unsigned int	_filterRevision				= 0,
+					_generation					= 0;
+	FilterBits		_filterVector,
+					_pendingFilter;
 	bool			_synchingData;
 
 	boost::interprocess::managed_shared_memory *_mem;
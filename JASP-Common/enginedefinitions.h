@@ -3,9 +3,10 @@
 
 #include "enumutilities.h"
 
-DECLARE_ENUM(engineState,			idle, analysis, filter, rCode, computeColumn, moduleRequest, paused, resuming);
+DECLARE_ENUM(engineState,			idle, analysis, filter, rCode, computeColumn, moduleRequest, paused, resuming, tablePage);
 DECLARE_ENUM(performType,			init, run, abort, saveImg, editImg);
 DECLARE_ENUM(analysisResultStatus,	error, exception, imageSaved, imageEdited, complete, inited, running, changed, waiting);
 DECLARE_ENUM(moduleStatus,			installNeeded, loadingNeeded, readyForUse, error);
+DECLARE_ENUM(messageFormat,			json, messagePack);
 
 #endif // ENGINEDEFINITIONS_H
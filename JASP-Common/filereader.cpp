@@ -317,3 +317,115 @@ vector<string> FileReader::getEntryPaths(const string &archivePath, const string
 	}
 	return files;
 }
+
+
+namespace
+{
+	uint16_t zipRead16(const unsigned char *p) { return uint16_t(p[0] | (p[1] << 8)); }
+	uint32_t zipRead32(const unsigned char *p) { return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24); }
+	uint64_t zipRead64(const unsigned char *p) { return uint64_t(zipRead32(p)) | (uint64_t(zipRead32(p + 4)) << 32); }
+}
+
+bool FileReader::findStoredEntry(const string &archivePath, const string &entryPath, uint64_t &offset, uint64_t &size)
+{
+	const uint32_t	endOfCentralDirSignature	= 0x06054b50,
+					zip64LocatorSignature		= 0x07064b50,
+					zip64EndSignature			= 0x06064b50,
+					centralHeaderSignature		= 0x02014b50,
+					localHeaderSignature		= 0x04034b50,
+					sizeUnknown					= 0xFFFFFFFF;
+
+	boost::nowide::ifstream file(archivePath.c_str(), ios::in | ios::binary);
+	if (!file.is_open())
+		return false;
+
+	file.seekg(0, ios::end);
+	uint64_t fileSize = uint64_t(file.tellg());
+
+	// The end of central directory record is at the end of the file, followed by at most 64K of comment.
+	uint64_t		tailSize = std::min<uint64_t>(fileSize, 22 + 0xFFFF);
+	vector<unsigned char> tail(tailSize);
+	file.seekg(fileSize - tailSize);
+	file.read(reinterpret_cast<char*>(tail.data()), tailSize);
+
+	if (tailSize < 22 || !file)
+		return false;
+
+	size_t eocd = tailSize - 22;
+	while (zipRead32(&tail[eocd]) != endOfCentralDirSignature)
+		if (eocd-- == 0)
+			return false;
+
+	uint64_t	entries				= zipRead16(&tail[eocd + 10]),
+				centralDirOffset	= zipRead32(&tail[eocd + 16]);
+
+	if (centralDirOffset == sizeUnknown)
+	{
+		if (eocd < 20 || zipRead32(&tail[eocd - 20]) != zip64LocatorSignature)
+			return false;
+
+		unsigned char zip64End[56];
+		file.seekg(zipRead64(&tail[eocd - 20 + 8]));
+		file.read(reinterpret_cast<char*>(zip64End), sizeof(zip64End));
+
+		if (!file || zipRead32(zip64End) != zip64EndSignature)
+			return false;
+
+		entries				= zipRead64(zip64End + 32);
+		centralDirOffset	= zipRead64(zip64End + 48);
+	}
+
+	file.seekg(centralDirOffset);
+
+	for (uint64_t entry = 0; entry < entries; entry++)
+	{
+		unsigned char header[46];
+		file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+		if (!file || zipRead32(header) != centralHeaderSignature)
+			return false;
+
+		uint16_t	method			= zipRead16(header + 10),
+					nameLength		= zipRead16(header + 28),
+					extraLength		= zipRead16(header + 30),
+					commentLength	= zipRead16(header + 32);
+		uint64_t	compressedSize	= zipRead32(header + 20),
+					localHeader		= zipRead32(header + 42);
+
+		string name(nameLength, '\0');
+		vector<unsigned char> extra(extraLength);
+		file.read(&name[0], nameLength);
+		file.read(reinterpret_cast<char*>(extra.data()), extraLength);
+		file.seekg(commentLength, ios::cur);
+
+		if (name != entryPath)
+			continue;
+
+		if (method != 0) // not stored
+			return false;
+
+		// Sizes and offset that do not fit in 32 bits are in the zip64 extra field, in this order, and only if their 32 bit field is maxed out.
+		for (size_t pos = 0; pos + 4 <= extra.size(); pos += 4 + zipRead16(&extra[pos + 2]))
+			if (zipRead16(&extra[pos]) == 0x0001)
+			{
+				size_t field = pos + 4;
+				if (zipRead32(header + 24) == sizeUnknown)									field += 8; // uncompressed size
+				if (compressedSize == sizeUnknown	&& field + 8 <= extra.size())	{	compressedSize	= zipRead64(&extra[field]); field += 8; }
+				if (localHeader == sizeUnknown		&& field + 8 <= extra.size())		localHeader		= zipRead64(&extra[field]);
+			}
+
+		unsigned char local[30];
+		file.seekg(localHeader);
+		file.read(reinterpret_cast<char*>(local), sizeof(local));
+
+		if (!file || zipRead32(local) != localHeaderSignature)
+			return false;
+
+		offset	= localHeader + sizeof(local) + zipRead16(local + 26) + zipRead16(local + 28);
+		size	= compressedSize;
+
+		return offset + size <= fileSize;
+	}
+
+	return false;
+}
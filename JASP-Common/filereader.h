@@ -22,6 +22,7 @@
 #include <vector>
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <boost/nowide/fstream.hpp>
 
 #include "libzip/archive.h"
@@ -140,6 +141,16 @@ public:
 
 	static std::vector<std::string> getEntryPaths(const std::string &archivePath, const std::string &entryBaseDirectory = std::string());
 
+	/**
+	 * @brief findStoredEntry Looks up where the data of an uncompressed (stored) entry lies in a zip archive, so it can be memory mapped instead of read through readData.
+	 * @param archivePath - Path to archive file.
+	 * @param entryPath - Path to entry in archive.
+	 * @param offset - Set to the offset of the entry data from the start of the archive file.
+	 * @param size - Set to the size of the entry data.
+	 * @return false if the entry is not found, is compressed or the archive is not a zip this understands.
+	 */
+	static bool findStoredEntry(const std::string &archivePath, const std::string &entryPath, uint64_t &offset, uint64_t &size);
+
 private:
 
 	struct archive *_archive;
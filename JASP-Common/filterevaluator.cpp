@@ -0,0 +1,1097 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "filterevaluator.h"
+#include "dataset.h"
+#include "parallelutils.h"
+#include "numericparser.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <map>
+#include <sstream>
+
+const size_t FilterEvaluator::rowsPerChunk = 65536;
+
+static const signed char	naLogical	= -1;
+static const double			naNumber	= std::numeric_limits<double>::quiet_NaN();
+
+struct FilterEvaluator::Node
+{
+	enum class kind { number, string, logical, column, unary, binary, call };
+
+	kind					type;
+	std::string				text;			///< Operator, function name or the string itself
+	double					number		= 0;
+	signed char				logical		= 0;
+	Column				*	column		= NULL;
+	std::vector<NodePtr>	args;
+
+	//Comparisons of a factor with constants are worked out once per label key, the first chunk fills these before the other chunks run in parallel
+	mutable bool						keyResultReady	= false;
+	mutable int							keyOffset		= 0;
+	mutable signed char					keyNAResult		= naLogical;
+	mutable std::vector<signed char>	keyResult;
+
+	Node(kind type) : type(type) {}
+};
+
+struct FilterEvaluator::Value
+{
+	enum class kind { logical, number, factor, string };
+
+	kind						type		= kind::logical;
+	bool						scalar		= true;		///< Recycled over all rows
+	bool						constants	= false;	///< Made by c(), only usable on the right of %in%
+	std::vector<double>			numbers;
+	std::vector<signed char>	logicals;
+	std::vector<int>			keys;
+	const Column			*	column		= NULL;
+	std::vector<std::string>	texts;
+
+	double		number(size_t row)	const { return numbers[scalar ? 0 : row];	}
+	signed char	logical(size_t row)	const { return logicals[scalar ? 0 : row];	}
+};
+
+typedef FilterEvaluator::Value	Value;
+typedef FilterEvaluator::Node	Node;
+typedef FilterEvaluator::NodePtr NodePtr;
+
+namespace
+{
+	bool isNameChar(char kar) { return kar == '.' || kar == '_' || (kar >= 'a' && kar <= 'z') || (kar >= 'A' && kar <= 'Z') || (kar >= '0' && kar <= '9'); }
+
+	///Same boundaries as rbridge_encodeColumnNamesToBase64 uses to find column names in a filter
+	bool isFreeChar(char kar) { return !(kar == '.' || (kar >= 'a' && kar <= 'z') || (kar >= 'A' && kar <= 'Z') || (kar >= '0' && kar <= '9')); }
+
+	bool isComparison(const std::string & op) { return op == "==" || op == "!=" || op == "<" || op == "<=" || op == ">" || op == ">="; }
+
+	struct Token
+	{
+		enum class kind { number, string, identifier, column, op, newline, end };
+
+		kind		type;
+		std::string	text;
+		double		number = 0;
+	};
+
+	class FilterParser
+	{
+	public:
+		FilterParser(const std::string & code, DataSet * dataSet, const std::vector<std::string> & columnNames, size_t rowCount)
+			: _dataSet(dataSet), _rowCount(rowCount)
+		{
+			tokenize(code, columnNames);
+		}
+
+		NodePtr parseProgram()
+		{
+			NodePtr last;
+
+			for(;;)
+			{
+				while(_tokens[_pos].type == Token::kind::newline)
+					_pos++;
+
+				if(_tokens[_pos].type == Token::kind::end)
+					break;
+
+				last = parseAssign();
+
+				if(peek().type != Token::kind::newline && peek().type != Token::kind::end)
+					throw FilterEvaluator::unsupported("Unexpected \"" + peek().text + "\"");
+			}
+
+			if(!last)
+				throw FilterEvaluator::unsupported("Empty filter");
+
+			return last;
+		}
+
+	private:
+		void tokenize(const std::string & code, const std::vector<std::string> & columnNames)
+		{
+			size_t i = 0;
+
+			while(i < code.size())
+			{
+				char kar = code[i];
+
+				if(kar == ' ' || kar == '\t' || kar == '\r')	{ i++; continue; }
+				if(kar == '\n' || kar == ';')					{ push(Token::kind::newline, "\n"); i++; continue; }
+				if(kar == '#')									{ while(i < code.size() && code[i] != '\n') i++; continue; }
+
+				if(kar == '"' || kar == '\'')
+				{
+					std::string text;
+
+					for(i++; i < code.size() && code[i] != kar; i++)
+						if(code[i] != '\\')
+							text += code[i];
+						else if(++i < code.size())
+							switch(code[i])
+							{
+							case 'n':	text += '\n';	break;
+							case 't':	text += '\t';	break;
+							case '\\':
+							case '"':
+							case '\'':	text += code[i];	break;
+							default:	throw FilterEvaluator::unsupported("Escape in string");
+							}
+
+					if(i >= code.size())
+						throw FilterEvaluator::unsupported("Unterminated string");
+
+					push(Token::kind::string, text);
+					i++;
+					continue;
+				}
+
+				if(i == 0 || isFreeChar(code[i - 1]))
+				{
+					const std::string * found = NULL;
+
+					for(const std::string & name : columnNames)
+						if(name.size() > 0 && code.compare(i, name.size(), name) == 0)
+						{
+							size_t end = i + name.size();
+
+							if(end == code.size() || (isFreeChar(code[end]) && code[end] != '('))
+							{
+								found = &name;
+								break;
+							}
+						}
+
+					if(found != NULL)
+					{
+						push(Token::kind::column, *found);
+						i += found->size();
+						continue;
+					}
+				}
+
+				if((kar >= '0' && kar <= '9') || (kar == '.' && i + 1 < code.size() && code[i + 1] >= '0' && code[i + 1] <= '9'))
+				{
+					// strtod would follow LC_NUMERIC, which Qt sets from the environment, so the literal is delimited here and parsed in the classic way
+					const char	* start		= code.c_str() + i;
+					size_t		  numEnd	= i;
+					double		  number;
+
+					if(kar == '0' && i + 1 < code.size() && (code[i + 1] == 'x' || code[i + 1] == 'X'))
+						throw FilterEvaluator::unsupported("Hexadecimal number");
+
+					auto skipDigits = [&]() { while(numEnd < code.size() && code[numEnd] >= '0' && code[numEnd] <= '9') numEnd++; };
+
+					skipDigits();
+
+					if(numEnd < code.size() && code[numEnd] == '.')
+					{
+						numEnd++;
+						skipDigits();
+					}
+
+					if(numEnd < code.size() && (code[numEnd] == 'e' || code[numEnd] == 'E'))
+					{
+						size_t exponent = numEnd + 1;
+
+						if(exponent < code.size() && (code[exponent] == '+' || code[exponent] == '-'))
+							exponent++;
+
+						if(exponent < code.size() && code[exponent] >= '0' && code[exponent] <= '9')
+						{
+							numEnd = exponent;
+							skipDigits();
+						}
+					}
+
+					if(!NumericParser::parseDouble(boost::string_view(start, numEnd - i), number))
+						throw FilterEvaluator::unsupported("Odd number");
+
+					i = numEnd;
+
+					if(i < code.size() && code[i] == 'L')
+						i++;
+
+					if(i < code.size() && isNameChar(code[i]))
+						throw FilterEvaluator::unsupported("Odd number");
+
+					push(Token::kind::number, code.substr(start - code.c_str(), i - (start - code.c_str())));
+					_tokens.back().number = number;
+					continue;
+				}
+
+				if(isNameChar(kar))
+				{
+					size_t start = i;
+					while(i < code.size() && isNameChar(code[i]))
+						i++;
+
+					push(Token::kind::identifier, code.substr(start, i - start));
+					continue;
+				}
+
+				if(kar == '%')
+				{
+					size_t end = code.find('%', i + 1);
+
+					if(end == std::string::npos || (end - i != 1 && code.compare(i, 4, "%in%") != 0))
+						throw FilterEvaluator::unsupported("Unknown special operator");
+
+					push(Token::kind::op, code.substr(i, end - i + 1));
+					i = end + 1;
+					continue;
+				}
+
+				static const char * twoCharOps[] = { "<-", "<=", ">=", "==", "!=", "**" };
+				bool twoChar = false;
+
+				for(const char * op : twoCharOps)
+					if(code.compare(i, 2, op) == 0)
+					{
+						push(Token::kind::op, std::string(op) == "**" ? "^" : op);
+						i += 2;
+						twoChar = true;
+						break;
+					}
+
+				if(twoChar)
+					continue;
+
+				if(code.compare(i, 2, "&&") == 0 || code.compare(i, 2, "||") == 0 || code.compare(i, 2, "->") == 0)
+					throw FilterEvaluator::unsupported("Unsupported operator");
+
+				if(std::string("&|!<>+-*/^(),=").find(kar) == std::string::npos)
+					throw FilterEvaluator::unsupported(std::string("Unsupported character ") + kar);
+
+				push(Token::kind::op, std::string(1, kar));
+				i++;
+			}
+
+			push(Token::kind::end, "");
+		}
+
+		void push(Token::kind type, const std::string & text)
+		{
+			Token token;
+			token.type = type;
+			token.text = text;
+			_tokens.push_back(token);
+		}
+
+		///Inside parentheses R ignores newlines
+		const Token & peek()
+		{
+			if(_depth > 0)
+				while(_tokens[_pos].type == Token::kind::newline)
+					_pos++;
+
+			return _tokens[_pos];
+		}
+
+		bool peekOp(const char * op)	{ return peek().type == Token::kind::op && peek().text == op; }
+
+		void expectOp(const char * op)
+		{
+			if(!peekOp(op))
+				throw FilterEvaluator::unsupported(std::string("Expected ") + op);
+			_pos++;
+		}
+
+		///Before an operand a newline just continues the expression
+		void skipNewlines()
+		{
+			while(_tokens[_pos].type == Token::kind::newline)
+				_pos++;
+		}
+
+		static NodePtr makeNode(Node::kind type, const std::string & text, NodePtr left, NodePtr right = NodePtr())
+		{
+			NodePtr node(new Node(type));
+			node->text = text;
+			node->args.push_back(left);
+			if(right)
+				node->args.push_back(right);
+			return node;
+		}
+
+		NodePtr parseAssign()
+		{
+			size_t	start	= _pos;
+			NodePtr	left	= parseOr();
+
+			if(!peekOp("<-"))
+				return left;
+
+			if(_tokens[start].type != Token::kind::identifier || _pos != start + 1)
+				throw FilterEvaluator::unsupported("Only assignments to plain names are understood");
+
+			_pos++;
+			NodePtr right = parseAssign();
+			_variables[_tokens[start].text] = right;
+
+			return right;
+		}
+
+		NodePtr parseOr()
+		{
+			NodePtr left = parseAnd();
+
+			while(peekOp("|"))
+			{
+				_pos++;
+				left = makeNode(Node::kind::binary, "|", left, parseAnd());
+			}
+
+			return left;
+		}
+
+		NodePtr parseAnd()
+		{
+			NodePtr left = parseNot();
+
+			while(peekOp("&"))
+			{
+				_pos++;
+				left = makeNode(Node::kind::binary, "&", left, parseNot());
+			}
+
+			return left;
+		}
+
+		NodePtr parseNot()
+		{
+			skipNewlines();
+
+			if(peekOp("!"))
+			{
+				_pos++;
+				return makeNode(Node::kind::unary, "!", parseNot());
+			}
+
+			return parseComparison();
+		}
+
+		NodePtr parseComparison()
+		{
+			NodePtr left = parseAdditive();
+
+			for(const char * op : { "==", "!=", "<", "<=", ">", ">=" })
+				if(peekOp(op))
+				{
+					_pos++;
+					left = makeNode(Node::kind::binary, op, left, parseAdditive());
+
+					if(peek().type == Token::kind::op && isComparison(peek().text))
+						throw FilterEvaluator::unsupported("Comparisons do not chain");
+
+					break;
+				}
+
+			return left;
+		}
+
+		NodePtr parseAdditive()
+		{
+			NodePtr left = parseMultiplicative();
+
+			while(peekOp("+") || peekOp("-"))
+			{
+				std::string op = peek().text;
+				_pos++;
+				left = makeNode(Node::kind::binary, op, left, parseMultiplicative());
+			}
+
+			return left;
+		}
+
+		NodePtr parseMultiplicative()
+		{
+			NodePtr left = parseSpecial();
+
+			while(peekOp("*") || peekOp("/"))
+			{
+				std::string op = peek().text;
+				_pos++;
+				left = makeNode(Node::kind::binary, op, left, parseSpecial());
+			}
+
+			return left;
+		}
+
+		NodePtr parseSpecial()
+		{
+			NodePtr left = parseUnaryMinus();
+
+			while(peekOp("%%") || peekOp("%in%"))
+			{
+				std::string op = peek().text;
+				_pos++;
+				left = makeNode(Node::kind::binary, op, left, parseUnaryMinus());
+			}
+
+			return left;
+		}
+
+		NodePtr parseUnaryMinus()
+		{
+			skipNewlines();
+
+			if(peekOp("-") || peekOp("+"))
+			{
+				std::string op = peek().text;
+				_pos++;
+				return makeNode(Node::kind::unary, op, parseUnaryMinus());
+			}
+
+			return parsePower();
+		}
+
+		NodePtr parsePower()
+		{
+			NodePtr left = parsePrimary();
+
+			if(peekOp("^"))
+			{
+				_pos++;
+				return makeNode(Node::kind::binary, "^", left, parseUnaryMinus()); //right associative and the exponent may be negative
+			}
+
+			return left;
+		}
+
+		NodePtr parsePrimary()
+		{
+			skipNewlines();
+
+			const Token token = _tokens[_pos++];
+
+			switch(token.type)
+			{
+			case Token::kind::number:
+			{
+				NodePtr node(new Node(Node::kind::number));
+				node->number = token.number;
+				return node;
+			}
+
+			case Token::kind::string:
+			{
+				NodePtr node(new Node(Node::kind::string));
+				node->text = token.text;
+				return node;
+			}
+
+			case Token::kind::column:
+			{
+				NodePtr node(new Node(Node::kind::column));
+				node->text		= token.text;
+				node->column	= &_dataSet->column(token.text);
+
+				if(node->column->columnType() == Column::ColumnTypeUnknown)
+					throw FilterEvaluator::unsupported("Column of unknown type");
+
+				return node;
+			}
+
+			case Token::kind::identifier:
+				if(peekOp("("))
+					return parseCall(token.text);
+
+				if(_variables.count(token.text) > 0)
+					return _variables[token.text];
+
+				if(token.text == "TRUE"	|| token.text == "T")	return logicalNode(1);
+				if(token.text == "FALSE"	|| token.text == "F")	return logicalNode(0);
+				if(token.text == "NA")							return logicalNode(naLogical);
+
+				if(token.text == "Inf" || token.text == "NaN")
+				{
+					NodePtr node(new Node(Node::kind::number));
+					node->number = token.text == "Inf" ? std::numeric_limits<double>::infinity() : naNumber;
+					return node;
+				}
+
+				if(peekOp("<-")) //It is about to be assigned, parseAssign takes it from here
+					return NodePtr(new Node(Node::kind::logical));
+
+				throw FilterEvaluator::unsupported("Unknown name " + token.text);
+
+			case Token::kind::op:
+				if(token.text == "(")
+				{
+					_depth++;
+					NodePtr inner = parseAssign();
+					expectOp(")");
+					_depth--;
+					return inner;
+				}
+				break;
+
+			default:
+				break;
+			}
+
+			throw FilterEvaluator::unsupported("Unexpected \"" + token.text + "\"");
+		}
+
+		NodePtr logicalNode(signed char logical)
+		{
+			NodePtr node(new Node(Node::kind::logical));
+			node->logical = logical;
+			return node;
+		}
+
+		NodePtr parseCall(const std::string & name)
+		{
+			static const std::map<std::string, std::pair<size_t, size_t>> functions = { //minimum and maximum arguments
+				{ "c",		{ 1, 1000 }	},
+				{ "is.na",	{ 1, 1 }	},
+				{ "rep",	{ 2, 2 }	},
+				{ "abs",	{ 1, 1 }	},
+				{ "sqrt",	{ 1, 1 }	}
+			};
+
+			if(functions.count(name) == 0)
+				throw FilterEvaluator::unsupported("Unknown function " + name);
+
+			NodePtr call(new Node(Node::kind::call));
+			call->text = name;
+
+			expectOp("(");
+			_depth++;
+
+			while(!peekOp(")"))
+			{
+				if(call->args.size() > 0)
+					expectOp(",");
+
+				if(peek().type == Token::kind::identifier && _tokens[_pos + 1].type == Token::kind::op && _tokens[_pos + 1].text == "=")
+				{
+					if(name != "rep" || peek().text != "times" || call->args.size() != 1)
+						throw FilterEvaluator::unsupported("Named argument");
+					_pos += 2;
+				}
+
+				call->args.push_back(parseAssign());
+			}
+
+			_depth--;
+			_pos++;
+
+			if(call->args.size() < functions.at(name).first || call->args.size() > functions.at(name).second)
+				throw FilterEvaluator::unsupported("Wrong number of arguments for " + name);
+
+			if(name == "rep" && (call->args[1]->type != Node::kind::number || call->args[1]->number != double(_rowCount)))
+				throw FilterEvaluator::unsupported("rep only for a whole column");
+
+			return call;
+		}
+
+		DataSet						*	_dataSet;
+		size_t							_rowCount;
+		std::vector<Token>				_tokens;
+		size_t							_pos	= 0;
+		int								_depth	= 0;
+		std::map<std::string, NodePtr>	_variables;
+	};
+
+	void toNumbers(Value & value)
+	{
+		switch(value.type)
+		{
+		case Value::kind::number:
+			return;
+
+		case Value::kind::logical:
+			value.numbers.resize(value.logicals.size());
+			for(size_t i=0; i<value.logicals.size(); i++)
+				value.numbers[i] = value.logicals[i] == naLogical ? naNumber : double(value.logicals[i]);
+			value.type = Value::kind::number;
+			return;
+
+		default:
+			throw FilterEvaluator::unsupported("Arithmetic on text");
+		}
+	}
+
+	void toLogicals(Value & value)
+	{
+		switch(value.type)
+		{
+		case Value::kind::logical:
+			return;
+
+		case Value::kind::number:
+			value.logicals.resize(value.numbers.size());
+			for(size_t i=0; i<value.numbers.size(); i++)
+				value.logicals[i] = std::isnan(value.numbers[i]) ? naLogical : value.numbers[i] != 0;
+			value.type = Value::kind::logical;
+			return;
+
+		default:
+			throw FilterEvaluator::unsupported("Logic on text");
+		}
+	}
+
+	///Swaps the sides of a comparison so that the factor ends up on the left
+	std::string mirror(const std::string & op)
+	{
+		if(op == "<")	return ">";
+		if(op == "<=")	return ">=";
+		if(op == ">")	return "<";
+		if(op == ">=")	return "<=";
+		return op;
+	}
+
+	template<typename T> signed char compare(const std::string & op, T left, T right)
+	{
+		if(op == "==")	return left == right;
+		if(op == "!=")	return left != right;
+		if(op == "<")	return left <	right;
+		if(op == "<=")	return left <=	right;
+		if(op == ">")	return left >	right;
+		return left >= right;
+	}
+
+	///Applies compare to every row, NA on either side gives NA
+	template<typename Compare> void compareNumbers(const Value & left, const Value & right, std::vector<signed char> & out, Compare compare)
+	{
+		for(size_t row=0; row<out.size(); row++)
+		{
+			double a = left.number(row), b = right.number(row);
+			out[row] = std::isnan(a) || std::isnan(b) ? naLogical : compare(a, b);
+		}
+	}
+
+	template<typename Operation> void calculateNumbers(const Value & left, const Value & right, std::vector<double> & out, Operation operation)
+	{
+		for(size_t row=0; row<out.size(); row++)
+			out[row] = operation(left.number(row), right.number(row));
+	}
+
+	///R turns a number into text like this when it compares it with a factor, only the simple cases are done here
+	std::string numberAsLevel(double number)
+	{
+		if(std::isnan(number) || number != std::floor(number) || std::fabs(number) >= 1e5)
+			throw FilterEvaluator::unsupported("Comparing a factor with a number");
+
+		std::stringstream out;
+		out << (long)number;
+		return out.str();
+	}
+}
+
+FilterEvaluator::FilterEvaluator(DataSet * dataSet) : _dataSet(dataSet), _rowCount(dataSet == NULL ? 0 : dataSet->rowCount())
+{
+	if(_dataSet != NULL)
+		for(Column & column : _dataSet->columns())
+			_columnNames.push_back(column.name());
+
+	std::sort(_columnNames.begin(), _columnNames.end(), [](const std::string & a, const std::string & b) { return a.size() > b.size(); });
+}
+
+FilterEvaluator::~FilterEvaluator() {}
+
+FilterEvaluator::NodePtr FilterEvaluator::_parse(const std::string & code)
+{
+	return FilterParser(code, _dataSet, _columnNames, _rowCount).parseProgram();
+}
+
+bool FilterEvaluator::evaluate(const std::string & generatedFilter, const std::string & rFilter, std::vector<bool> & result)
+{
+	if(_dataSet == NULL || _rowCount == 0)
+		return false;
+
+	if(rFilter == "*" || rFilter == "")
+	{
+		result = std::vector<bool>(_rowCount, true);
+		return true;
+	}
+
+	try
+	{
+		NodePtr					filter	= _parse(generatedFilter + "\n" + rFilter);
+		std::vector<char>		passes(_rowCount, 0);
+		size_t					chunks	= (_rowCount + rowsPerChunk - 1) / rowsPerChunk;
+
+		auto evaluateChunk = [&](size_t chunk)
+		{
+			size_t	firstRow	= chunk * rowsPerChunk,
+					rows		= std::min(rowsPerChunk, _rowCount - firstRow);
+			Value	value;
+
+			_evaluate(*filter, firstRow, rows, value);
+
+			if(value.scalar || value.constants)
+				throw unsupported("Filter does not give a value per row");
+
+			//The engine lets a row through if the result is TRUE or exactly 1, NA never passes
+			if(value.type == Value::kind::logical)		for(size_t row=0; row<rows; row++) passes[firstRow + row] = value.logicals[row] == 1;
+			else if(value.type == Value::kind::number)	for(size_t row=0; row<rows; row++) passes[firstRow + row] = value.numbers[row] == 1;
+			else										throw unsupported("Filter does not give logicals");
+		};
+
+		evaluateChunk(0); //Runs every node once so that the per label results are ready before going parallel
+		parallelUtils::forEach(chunks - 1, [&](size_t chunk) { evaluateChunk(chunk + 1); });
+
+		if(std::find(passes.begin(), passes.end(), 1) == passes.end())
+			return false; //Let R explain that everything was filtered out
+
+		result.assign(passes.begin(), passes.end());
+		return true;
+	}
+	catch(std::exception &)
+	{
+		return false;
+	}
+}
+
+void FilterEvaluator::_evaluate(const Node & node, size_t firstRow, size_t rows, Value & out) const
+{
+	switch(node.type)
+	{
+	case Node::kind::number:
+		out.type	= Value::kind::number;
+		out.scalar	= true;
+		out.numbers	= { node.number };
+		return;
+
+	case Node::kind::string:
+		out.type	= Value::kind::string;
+		out.scalar	= true;
+		out.texts	= { node.text };
+		return;
+
+	case Node::kind::logical:
+		out.type		= Value::kind::logical;
+		out.scalar		= true;
+		out.logicals	= { node.logical };
+		return;
+
+	case Node::kind::column:
+	{
+		size_t available = firstRow < node.column->rowCount() ? std::min(rows, node.column->rowCount() - firstRow) : 0;
+
+		out.scalar = false;
+		out.column = node.column;
+
+		if(node.column->columnType() == Column::ColumnTypeScale)
+		{
+			out.type = Value::kind::number;
+			out.numbers.assign(rows, naNumber);
+			node.column->getValues(firstRow, available, out.numbers.data());
+		}
+		else
+		{
+			out.type = Value::kind::factor;
+			out.keys.assign(rows, INT_MIN);
+			node.column->getValues(firstRow, available, out.keys.data());
+		}
+		return;
+	}
+
+	case Node::kind::unary:
+		_evaluate(*node.args[0], firstRow, rows, out);
+
+		if(out.constants)
+			throw unsupported("Vector constant in unary operator");
+
+		if(node.text == "!")
+		{
+			toLogicals(out);
+			for(signed char & logical : out.logicals)
+				if(logical != naLogical)
+					logical = !logical;
+		}
+		else
+		{
+			toNumbers(out);
+			if(node.text == "-")
+				for(double & number : out.numbers)
+					number = -number;
+		}
+		return;
+
+	case Node::kind::binary:
+		_evaluateBinary(node, firstRow, rows, out);
+		return;
+
+	case Node::kind::call:
+		_evaluateCall(node, firstRow, rows, out);
+		return;
+	}
+}
+
+void FilterEvaluator::_evaluateCall(const Node & node, size_t firstRow, size_t rows, Value & out) const
+{
+	if(node.text == "c")
+	{
+		Value element;
+		out = Value();
+
+		for(const NodePtr & arg : node.args)
+		{
+			element = Value();
+			_evaluate(*arg, firstRow, rows, element);
+
+			if(!element.scalar || element.constants)
+				throw unsupported("c() of something other than constants");
+
+			if(element.type == Value::kind::logical)
+				toNumbers(element);
+
+			if(arg == node.args[0])
+				out.type = element.type;
+			else if(element.type != out.type)
+				throw unsupported("c() of mixed types");
+
+			if(element.type == Value::kind::string)	out.texts.push_back(element.texts[0]);
+			else									out.numbers.push_back(element.numbers[0]);
+		}
+
+		out.constants = node.args.size() > 1;
+		return;
+	}
+
+	_evaluate(*node.args[0], firstRow, rows, out);
+
+	if(out.constants)
+		throw unsupported("Vector constant as argument of " + node.text);
+
+	if(node.text == "is.na")
+	{
+		std::vector<signed char> isNA;
+
+		switch(out.type)
+		{
+		case Value::kind::logical:	for(signed char logical : out.logicals)	isNA.push_back(logical == naLogical);	break;
+		case Value::kind::number:	for(double number : out.numbers)		isNA.push_back(std::isnan(number));		break;
+		case Value::kind::factor:	for(int key : out.keys)					isNA.push_back(key == INT_MIN);			break;
+		case Value::kind::string:	isNA.push_back(0);																break;
+		}
+
+		out.type		= Value::kind::logical;
+		out.logicals	= isNA;
+		out.keys.clear();
+		return;
+	}
+
+	if(node.text == "rep")
+	{
+		if(!out.scalar)
+			throw unsupported("rep of more than one value");
+
+		if(out.type == Value::kind::number)			out.numbers.assign(rows, out.numbers[0]);
+		else if(out.type == Value::kind::logical)	out.logicals.assign(rows, out.logicals[0]);
+		else										throw unsupported("rep of text");
+
+		out.scalar = false;
+		return;
+	}
+
+	toNumbers(out);
+
+	for(double & number : out.numbers)
+		number = node.text == "abs" ? std::fabs(number) : std::sqrt(number);
+}
+
+void FilterEvaluator::_evaluateBinary(const Node & node, size_t firstRow, size_t rows, Value & out) const
+{
+	const std::string & op = node.text;
+
+	Value left, right;
+	_evaluate(*node.args[0], firstRow, rows, left);
+	_evaluate(*node.args[1], firstRow, rows, right);
+
+	if(left.constants || (right.constants && op != "%in%"))
+		throw unsupported("Vector constant in " + op);
+
+	bool	scalar	= left.scalar && right.scalar;
+	size_t	length	= scalar ? 1 : rows;
+
+	out				= Value();
+	out.scalar		= scalar;
+
+	if(left.type == Value::kind::factor || right.type == Value::kind::factor)
+	{
+		std::string	factorOp	= op;
+		Value	*	factor		= &left,
+				*	constant	= &right;
+
+		if(right.type == Value::kind::factor)
+		{
+			if(left.type == Value::kind::factor || op == "%in%")
+				throw unsupported("Factor on both sides or on the right of %in%");
+
+			std::swap(factor, constant);
+			factorOp = mirror(op);
+		}
+
+		if(!isComparison(factorOp) && factorOp != "%in%")
+			throw unsupported("Arithmetic on a factor");
+
+		if(constant->type == Value::kind::logical)
+			throw unsupported("Comparing a factor with a logical");
+
+		if(!node.keyResultReady)
+		{
+			std::vector<std::string> levels;
+			if(constant->type == Value::kind::string)	levels = constant->texts;
+			else										for(double number : constant->numbers) levels.push_back(numberAsLevel(number));
+
+			if(factorOp != "%in%" && levels.size() != 1)
+				throw unsupported("Comparing a factor with several values");
+
+			bool			ordered = factor->column->columnType() == Column::ColumnTypeOrdinal,
+							ordering = factorOp != "==" && factorOp != "!=" && factorOp != "%in%";
+			const Labels &	labels	= const_cast<Column*>(factor->column)->labels();
+
+			if(ordering && !ordered)
+				throw unsupported("Ordering an unordered factor");
+
+			int minKey = INT_MAX, maxKey = INT_MIN, levelOfConstant = -1, level = 0;
+
+			for(const Label & label : labels)
+			{
+				minKey = std::min(minKey, label.value());
+				maxKey = std::max(maxKey, label.value());
+
+				if(ordering && label.text() == levels[0])
+				{
+					if(levelOfConstant != -1)
+						throw unsupported("Level occurs twice");
+					levelOfConstant = level;
+				}
+				level++;
+			}
+
+			if(ordering && levelOfConstant == -1)
+				throw unsupported("Ordering against something that is not a level");
+
+			if(labels.size() > 0 && double(maxKey) - double(minKey) > 1 << 22)
+				throw unsupported("Label keys too spread out");
+
+			node.keyOffset = minKey;
+			node.keyResult.assign(labels.size() == 0 ? 0 : size_t(maxKey - minKey + 1), naLogical);
+			node.keyNAResult = factorOp == "%in%" ? 0 : naLogical;
+
+			level = 0;
+			for(const Label & label : labels)
+			{
+				std::string		text	= label.text();
+				signed char &	result	= node.keyResult[label.value() - minKey];
+
+				if(factorOp == "%in%")		result = std::find(levels.begin(), levels.end(), text) != levels.end();
+				else if(ordering)			result = compare(factorOp, level, levelOfConstant);
+				else						result = compare(factorOp, text, levels[0]);
+
+				level++;
+			}
+
+			node.keyResultReady = true;
+		}
+
+		out.type = Value::kind::logical;
+		out.logicals.resize(length);
+
+		for(size_t row=0; row<length; row++)
+		{
+			int key = factor->keys[factor->scalar ? 0 : row];
+
+			if(key == INT_MIN)	out.logicals[row] = node.keyNAResult;
+			else
+			{
+				size_t index = size_t(key - node.keyOffset);
+				out.logicals[row] = key < node.keyOffset || index >= node.keyResult.size() ? naLogical : node.keyResult[index];
+			}
+		}
+
+		return;
+	}
+
+	if(left.type == Value::kind::string || right.type == Value::kind::string)
+		throw unsupported("Operator on text");
+
+	if(op == "&" || op == "|")
+	{
+		toLogicals(left);
+		toLogicals(right);
+
+		out.type = Value::kind::logical;
+		out.logicals.resize(length);
+
+		bool isAnd = op == "&";
+
+		for(size_t row=0; row<length; row++)
+		{
+			signed char a = left.logical(row), b = right.logical(row);
+
+			if(isAnd)	out.logicals[row] = a == 0 || b == 0 ? 0 : (a == naLogical || b == naLogical ? naLogical : 1);
+			else		out.logicals[row] = a == 1 || b == 1 ? 1 : (a == naLogical || b == naLogical ? naLogical : 0);
+		}
+
+		return;
+	}
+
+	toNumbers(left);
+	toNumbers(right);
+
+	if(op == "%in%")
+	{
+		if(std::find_if(right.numbers.begin(), right.numbers.end(), [](double number) { return std::isnan(number); }) != right.numbers.end())
+			throw unsupported("NA in %in%");
+
+		out.type = Value::kind::logical;
+		out.logicals.resize(length);
+
+		for(size_t row=0; row<length; row++)
+			out.logicals[row] = std::find(right.numbers.begin(), right.numbers.end(), left.number(row)) != right.numbers.end();
+
+		return;
+	}
+
+	if(isComparison(op))
+	{
+		out.type = Value::kind::logical;
+		out.logicals.resize(length);
+
+		if(op == "==")		compareNumbers(left, right, out.logicals, std::equal_to<double>());
+		else if(op == "!=")	compareNumbers(left, right, out.logicals, std::not_equal_to<double>());
+		else if(op == "<")	compareNumbers(left, right, out.logicals, std::less<double>());
+		else if(op == "<=")	compareNumbers(left, right, out.logicals, std::less_equal<double>());
+		else if(op == ">")	compareNumbers(left, right, out.logicals, std::greater<double>());
+		else				compareNumbers(left, right, out.logicals, std::greater_equal<double>());
+
+		return;
+	}
+
+	out.type = Value::kind::number;
+	out.numbers.resize(length);
+
+	if(op == "+")		calculateNumbers(left, right, out.numbers, std::plus<double>());
+	else if(op == "-")	calculateNumbers(left, right, out.numbers, std::minus<double>());
+	else if(op == "*")	calculateNumbers(left, right, out.numbers, std::multiplies<double>());
+	else if(op == "/")	calculateNumbers(left, right, out.numbers, std::divides<double>());
+	else if(op == "^")	calculateNumbers(left, right, out.numbers, [](double a, double b) { return std::pow(a, b); });
+	else if(op == "%%")	calculateNumbers(left, right, out.numbers, [](double a, double b) { return b == 0 ? naNumber : a - std::floor(a / b) * b; });
+	else				throw unsupported("Unknown operator " + op);
+}
@@ -0,0 +1,74 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef FILTEREVALUATOR_H
+#define FILTEREVALUATOR_H
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class DataSet;
+class Column;
+
+/**
+ * @brief The FilterEvaluator class - Evaluates simple R filters directly on the columns of a DataSet.
+ *
+ * Understands the subset of R that the label filters and the drag and drop filter constructor write: numbers, strings, TRUE, FALSE, NA,
+ * arithmetic, comparisons, & | !, %in%, is.na, c, rep, abs, sqrt and assignments to variables such as generatedFilter.
+ * Large datasets are evaluated in chunks spread over several threads.
+ * Anything else is left to R, evaluate() then returns false without having changed anything.
+ */
+class FilterEvaluator
+{
+public:
+	FilterEvaluator(DataSet * dataSet);
+	~FilterEvaluator();
+
+	/**
+	 * @brief evaluate Runs generatedFilter followed by rFilter, rFilter should already be stripped of comments.
+	 * @param result - Receives one entry per row, set only when true is returned.
+	 * @return false if the code is not understood or lets no row through, R will produce the right result or error message.
+	 */
+	bool evaluate(const std::string & generatedFilter, const std::string & rFilter, std::vector<bool> & result);
+
+	struct Node;
+	struct Value;
+	typedef std::shared_ptr<Node> NodePtr;
+
+	/// Thrown for anything that R should evaluate instead.
+	class unsupported : public std::runtime_error
+	{
+	public:
+		unsupported(const std::string & what) : std::runtime_error(what) {}
+	};
+
+	static const size_t rowsPerChunk;
+
+private:
+	NodePtr	_parse(const std::string & code);
+	void	_evaluate(const Node & node, size_t firstRow, size_t rows, Value & out) const;
+	void	_evaluateCall(const Node & node, size_t firstRow, size_t rows, Value & out) const;
+	void	_evaluateBinary(const Node & node, size_t firstRow, size_t rows, Value & out) const;
+
+	DataSet						*	_dataSet;
+	size_t							_rowCount;
+	std::vector<std::string>		_columnNames; //Longest first, just like rbridge_encodeColumnNamesToBase64 matches them
+};
+
+#endif // FILTEREVALUATOR_H
@@ -20,45 +20,49 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include "boost/nowide/convert.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
 
 using namespace std;
 using namespace boost;
 using namespace boost::posix_time;
 
-IPCChannel::IPCChannel(std::string name, int channelNumber, bool isSlave) : _baseName(name + "#" + std::to_string(channelNumber)), _nameControl(name + "_control"), _nameMtS(name + "_MasterToSlave"), _nameStM(name + "_SlaveToMaster"), _channelNumber(channelNumber), _isSlave(isSlave)
-{
-	_memoryControl			= new interprocess::managed_shared_memory(interprocess::open_or_create, _baseName.c_str(), 4096);
+const uint64_t	IPCChannel::_ringCapacity;
+const uint64_t	IPCChannel::_minimumChunk;
+const int		IPCChannel::_streamTimeout;
 
-	_sizeMtoS				= _memoryControl->find_or_construct<size_t>("sizeMasterToSlave")(1024 * 1024 * 8);
-	_sizeStoM				= _memoryControl->find_or_construct<size_t>("sizeSlaveToMaster")(1024 * 1024 * 8);
+IPCChannel::IPCChannel(std::string name, int channelNumber, bool isSlave) : _baseName(name + "#" + std::to_string(channelNumber)), _nameMtS(_baseName + "_MasterToSlave"), _nameStM(_baseName + "_SlaveToMaster"), _channelNumber(channelNumber), _isSlave(isSlave)
+{
+	const size_t memorySize = _ringCapacity + 1024 * 64; //some room for the bookkeeping of managed_shared_memory
 
-	_memoryMasterToSlave	= new interprocess::managed_shared_memory(interprocess::open_or_create, _nameMtS.c_str(), *_sizeMtoS);
-	_memorySlaveToMaster	= new interprocess::managed_shared_memory(interprocess::open_or_create, _nameStM.c_str(), *_sizeStoM);
+	_memoryMasterToSlave	= new interprocess::managed_shared_memory(interprocess::open_or_create, _nameMtS.c_str(), memorySize);
+	_memorySlaveToMaster	= new interprocess::managed_shared_memory(interprocess::open_or_create, _nameStM.c_str(), memorySize);
 
-	TempFiles::addShmemFileName(_baseName);
 	TempFiles::addShmemFileName(_nameMtS);
 	TempFiles::addShmemFileName(_nameStM);
 
 	generateNames();
 
-	_mutexIn  = _memoryControl->find_or_construct<interprocess::interprocess_mutex>(_mutexInName.c_str())();
-	_mutexOut = _memoryControl->find_or_construct<interprocess::interprocess_mutex>(_mutexOutName.c_str())();
-
-	_memoryIn  = _isSlave ? _memoryMasterToSlave : _memorySlaveToMaster;
-	_memoryOut = _isSlave ? _memorySlaveToMaster : _memoryMasterToSlave;
+	interprocess::managed_shared_memory	*memoryIn  = _isSlave ? _memoryMasterToSlave : _memorySlaveToMaster,
+										*memoryOut = _isSlave ? _memorySlaveToMaster : _memoryMasterToSlave;
 
-	_sizeIn  = _isSlave ? _sizeMtoS : _sizeStoM;
-	_sizeOut = _isSlave ? _sizeStoM : _sizeMtoS;
+	_ringIn		= memoryIn->find_or_construct<IPCRing>	((_dataInName	+ "r").c_str())				(_ringCapacity);
+	_ringOut	= memoryOut->find_or_construct<IPCRing>	((_dataOutName	+ "r").c_str())				(_ringCapacity);
+	_dataIn		= memoryIn->find_or_construct<char>		(_dataInName.c_str())		[_ringCapacity]	(0);
+	_dataOut	= memoryOut->find_or_construct<char>	(_dataOutName.c_str())		[_ringCapacity]	(0);
 
-	_previousSizeIn = *_sizeIn;
-	_previousSizeOut = *_sizeOut;
-
-	_dataIn		= _memoryIn->find_or_construct<String>(_dataInName.c_str())		(_memoryIn->get_segment_manager());
-	_dataOut	= _memoryOut->find_or_construct<String>(_dataOutName.c_str())	(_memoryOut->get_segment_manager());
+	if (_isSlave == false)
+	{
+		// A previous engine on this channel might have left something behind
+		_ringIn->head	= _ringIn->tail		= 0;
+		_ringOut->head	= _ringOut->tail	= 0;
+	}
 
 #ifdef __APPLE__
-	_semaphoreIn  = sem_open(_mutexInName.c_str(), O_CREAT, S_IWUSR | S_IRGRP | S_IROTH, 0);
-	_semaphoreOut = sem_open(_mutexOutName.c_str(), O_CREAT, S_IWUSR | S_IRGRP | S_IROTH, 0);
+	_semaphoreIn  = sem_open(_semaphoreInName.c_str(),	O_CREAT, S_IWUSR | S_IRGRP | S_IROTH, 0);
+	_semaphoreOut = sem_open(_semaphoreOutName.c_str(),	O_CREAT, S_IWUSR | S_IRGRP | S_IROTH, 0);
 
 	if (isSlave == false)
 	{
@@ -93,182 +97,286 @@ IPCChannel::IPCChannel(std::string name, int channelNumber, bool isSlave) : _bas
 
 	if (_isSlave == false)
 	{
-		interprocess::named_semaphore::remove(_mutexInName.c_str());
-		interprocess::named_semaphore::remove(_mutexOutName.c_str());
+		interprocess::named_semaphore::remove(_semaphoreInName.c_str());
+		interprocess::named_semaphore::remove(_semaphoreOutName.c_str());
 
-		_semaphoreIn  = new interprocess::named_semaphore(interprocess::create_only, _mutexInName.c_str(), 0);
-		_semaphoreOut = new interprocess::named_semaphore(interprocess::create_only, _mutexOutName.c_str(), 0);
+		_semaphoreIn  = new interprocess::named_semaphore(interprocess::create_only, _semaphoreInName.c_str(), 0);
+		_semaphoreOut = new interprocess::named_semaphore(interprocess::create_only, _semaphoreOutName.c_str(), 0);
 	}
 	else
 	{
-		_semaphoreIn  = new interprocess::named_semaphore(interprocess::open_only, _mutexInName.c_str());
-		_semaphoreOut = new interprocess::named_semaphore(interprocess::open_only, _mutexOutName.c_str());
+		_semaphoreIn  = new interprocess::named_semaphore(interprocess::open_only, _semaphoreInName.c_str());
+		_semaphoreOut = new interprocess::named_semaphore(interprocess::open_only, _semaphoreOutName.c_str());
 	}
 
 
 #endif
 }
 
+IPCChannel::~IPCChannel()
+{
+#ifdef __APPLE__
+	sem_close(_semaphoreIn);
+	sem_close(_semaphoreOut);
+#elif defined __WIN32__
+	CloseHandle(_semaphoreIn);
+	CloseHandle(_semaphoreOut);
+#else
+	delete _semaphoreIn;
+	delete _semaphoreOut;
+#endif
+
+	delete _memoryMasterToSlave;
+	delete _memorySlaveToMaster;
+}
+
 void IPCChannel::generateNames()
 {
-	stringstream mutexInName, mutexOutName, dataInName, dataOutName, semaphoreInName, semaphoreOutName;
+	stringstream dataInName, dataOutName, semaphoreInName, semaphoreOutName;
 
 	std::string in  = _isSlave ? "-s" : "-m";
 	std::string out = _isSlave ? "-m" : "-s";
 
 	dataInName			<< _baseName << in  << 'd' << _channelNumber;
 	dataOutName			<< _baseName << out << 'd' << _channelNumber;
-	mutexInName			<< _baseName << in  << 'm' << _channelNumber;
-	mutexOutName		<< _baseName << out << 'm' << _channelNumber;
 	semaphoreInName		<< _baseName << in  << 's' << _channelNumber;
 	semaphoreOutName	<< _baseName << out << 's' << _channelNumber;
 
 	_semaphoreOutName	= semaphoreOutName.str();
 	_semaphoreInName	= semaphoreInName.str();
-	_mutexOutName		= mutexOutName.str();
-	_mutexInName		= mutexInName.str();
 	_dataOutName		= dataOutName.str();
 	_dataInName			= dataInName.str();
 }
 
-void IPCChannel::rebindMemoryInIfSizeChanged()
+void IPCChannel::writeRing(uint64_t position, const char * from, size_t size)
+{
+	size_t	offset	= position % _ringCapacity,
+			first	= std::min(size, size_t(_ringCapacity - offset));
+
+	memcpy(_dataOut + offset,	from,			first);
+	memcpy(_dataOut,			from + first,	size - first);
+}
+
+void IPCChannel::readRing(uint64_t position, char * to, size_t size) const
+{
+	size_t	offset	= position % _ringCapacity,
+			first	= std::min(size, size_t(_ringCapacity - offset));
+
+	memcpy(to,			_dataIn + offset,	first);
+	memcpy(to + first,	_dataIn,			size - first);
+}
+
+void IPCChannel::waitForSpace(uint64_t needed)
 {
-	if(_previousSizeIn < *_sizeIn)
+	auto started		= std::chrono::steady_clock::now();
+	bool wokeReceiver	= false;
+
+	while(_ringCapacity - (_ringOut->head.load(std::memory_order_relaxed) - _ringOut->tail.load(std::memory_order_acquire)) < needed)
 	{
-#ifdef JASP_DEBUG
-		std::cout << "rebindMemoryInIfSizeChanged! Size changed!\n" << std::flush;
-#endif
+		if(std::chrono::steady_clock::now() - started > std::chrono::milliseconds(_streamTimeout))
+			throw std::runtime_error("IPCChannel::send waited too long for the receiver to make room");
 
-		delete _memoryIn;
-		_previousSizeIn = *_sizeIn;
-		_memoryIn		= new interprocess::managed_shared_memory(interprocess::open_only, _isSlave ? _nameMtS.c_str() : _nameStM.c_str());
+		if(!wokeReceiver)
+		{
+			postOut(); //Make sure it knows it should be reading
+			wokeReceiver = true;
+		}
 
-		if(_isSlave)	_memoryMasterToSlave	= _memoryIn;
-		else			_memorySlaveToMaster	= _memoryIn;
+		stashIncoming(); //The other side might be waiting for room to send to us just as well
 
-		_dataIn = _memoryIn->find<String>(_dataInName.c_str()).first;
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
 	}
 }
 
-void IPCChannel::doubleMemoryOut()
+void IPCChannel::send(const std::string &data)
 {
-#ifdef JASP_DEBUG
-	std::cout << "IPCChannel::doubleMemoryOut is called and new memsize: ";
-#endif
+	send(data.data(), data.size());
+}
 
-	std::string memOutName = _isSlave ? _nameStM : _nameMtS;
+void IPCChannel::send(const char * data, size_t size)
+{
+	const uint64_t headerSize = sizeof(IPCFrameHeader);
 
-	_memoryOut->destroy<String>(_dataOutName.c_str());
+	size_t written = 0;
 
-	if(!interprocess::managed_shared_memory::grow(memOutName.c_str(), *_sizeOut))
-		throw std::runtime_error("Growing IPCChannel failed!");
+	do
+	{
+		size_t remaining = size - written;
 
-	_memoryOut = new interprocess::managed_shared_memory(interprocess::open_only, memOutName.c_str());
+		// Either the rest of the message or a decent chunk of it must fit before we write anything
+		waitForSpace(headerSize + std::min(remaining, size_t(_minimumChunk)));
 
-	if(_isSlave)	_memorySlaveToMaster = _memoryOut;
-	else			_memoryMasterToSlave = _memoryOut;
+		uint64_t		head	= _ringOut->head.load(std::memory_order_relaxed),
+						space	= _ringCapacity - (head - _ringOut->tail.load(std::memory_order_acquire)) - headerSize;
+		IPCFrameHeader	header;
 
-	_dataOut	= _memoryOut->construct<String>(_dataOutName.c_str())(_memoryOut->get_segment_manager());
-	*_sizeOut	= _memoryOut->get_size();
+		header.size = uint32_t(std::min(uint64_t(remaining), space));
+		header.last = written + header.size == size;
 
-#ifdef JASP_DEBUG
-	std::cout << *_sizeOut << "\n" << std::flush;
-#endif
+		writeRing(head,					reinterpret_cast<const char*>(&header),	headerSize);
+		writeRing(head + headerSize,	data + written,							header.size);
+
+		_ringOut->head.store(head + headerSize + header.size, std::memory_order_release);
+		postOut();
+
+		written += header.size;
+	}
+	while(written < size);
 }
 
-void IPCChannel::send(string &&data, bool alreadyLockedMutex)
+bool IPCChannel::waitForData(int timeout)
 {
-	send(data, alreadyLockedMutex);
+	if(messageWaiting())
+		return true;
+
+	tryWait(timeout);
+
+	return messageWaiting();
 }
 
+bool IPCChannel::waitForMessage(int timeout)
+{
+	return waitForData(timeout);
+}
 
-void IPCChannel::send(string &data, bool alreadyLockedMutex)
+bool IPCChannel::receive(string &data, int timeout)
 {
-	if(!alreadyLockedMutex)
-		_mutexOut->lock();
+	return receive([&](const char * message, size_t size) { data.assign(message, size); }, timeout);
+}
+
+bool IPCChannel::receive(MessageHandler handler, int timeout)
+{
+	if (!waitForData(timeout))
+		return false;
+
+	const uint64_t	headerSize	= sizeof(IPCFrameHeader);
+	IPCFrameHeader	header;
 
-	try
+	if(_stashed.empty())
 	{
-		_dataOut->assign(data.begin(), data.end());
+		uint64_t tail = _ringIn->tail.load(std::memory_order_relaxed);
+
+		readRing(tail, reinterpret_cast<char*>(&header), headerSize);
+
+		size_t offset = (tail + headerSize) % _ringCapacity;
+
+		if(header.last && offset + header.size <= _ringCapacity)
+		{
+			// The whole message lies in one piece in shared memory, no need to copy it
+			_handlingInPlace = true;
+
+			try
+			{
+				handler(_dataIn + offset, header.size);
+			}
+			catch(...)
+			{
+				_handlingInPlace = false;
+				_ringIn->tail.store(tail + headerSize + header.size, std::memory_order_release);
+				throw;
+			}
+
+			_handlingInPlace = false;
+			_ringIn->tail.store(tail + headerSize + header.size, std::memory_order_release);
+			return true;
+		}
 	}
-	catch (boost::interprocess::bad_alloc &e)	{ goto retryAfterDoublingMemory; }
-	catch (std::length_error &e)				{ goto retryAfterDoublingMemory; }
-	catch(std::exception & e)
+
+	_assembled.clear();
+
+	for(;;)
 	{
-#ifdef JASP_DEBUG
-		std::cout << "IPCChannel::send encountered an exception: " << e.what() << std::endl << std::flush;
-#endif
-		throw e; //no need to unlock because this will crash stuff
+		takeFrame(header, _assembled);
+
+		if(header.last)
+			break;
+
+		// The sender is still busy with the rest of the message
+		auto started = std::chrono::steady_clock::now();
+
+		while(!waitForData(100))
+			if(std::chrono::steady_clock::now() - started > std::chrono::milliseconds(_streamTimeout))
+				throw std::runtime_error("IPCChannel::receive did not get the rest of a message in time");
 	}
 
-#ifdef __APPLE__
-	sem_post(_semaphoreOut);
-#elif defined __WIN32__
-	ReleaseSemaphore(_semaphoreOut, 1, NULL);
-#else
-	_semaphoreOut->post();
-#endif
+	handler(_assembled.data(), _assembled.size());
 
+	return true;
+}
 
-	_mutexOut->unlock();
-	return; // return here to avoid going to retryAfterDoublingMemory
+void IPCChannel::takeFrame(IPCFrameHeader & header, std::string & into)
+{
+	if(_stashed.empty())
+	{
+		takeRingFrame(header, into);
+		return;
+	}
 
-retryAfterDoublingMemory:
-#ifdef JASP_DEBUG
-		std::cout << "IPCChannel::send out buffer is too small!\n" << std::flush;
-#endif
-		doubleMemoryOut();
+	header = _stashed.front().header;
+	into.append(_stashed.front().data);
 
-		send(data, true); //try again!
+	_stashed.pop_front();
+	_stashedCount.fetch_sub(1, std::memory_order_release);
 }
 
-bool IPCChannel::receive(string &data, int timeout)
+void IPCChannel::takeRingFrame(IPCFrameHeader & header, std::string & into)
 {
+	const uint64_t	headerSize	= sizeof(IPCFrameHeader);
+	uint64_t		tail		= _ringIn->tail.load(std::memory_order_relaxed);
 
-	if (tryWait(timeout))
-	{
-		_mutexIn->lock();
+	readRing(tail, reinterpret_cast<char*>(&header), headerSize);
 
-		while (tryWait()); // clear it completely
+	size_t soFar = into.size();
+	into.resize(soFar + header.size);
+	readRing(tail + headerSize, &into[soFar], header.size);
 
-		try
-		{
-			rebindMemoryInIfSizeChanged();
-			data.assign(_dataIn->c_str(), _dataIn->size());
-		}
-		catch(std::exception & e)
-		{
-			std::cout << "IPCChannel::receive encountered an exception: " << e.what() << std::endl << std::flush;
-			throw e;
-		}
+	_ringIn->tail.store(tail + headerSize + header.size, std::memory_order_release);
+}
 
-		_mutexIn->unlock();
+void IPCChannel::stashIncoming()
+{
+	if(_handlingInPlace)
+		return;
 
-		return true;
-	}
+	while(ringFrameWaiting())
+	{
+		IPCFrame frame;
+		takeRingFrame(frame.header, frame.data);
 
-	return false;
+		_stashed.push_back(std::move(frame));
+		_stashedCount.fetch_add(1, std::memory_order_release);
+	}
 }
 
+void IPCChannel::postOut()
+{
+#ifdef __APPLE__
+	sem_post(_semaphoreOut);
+#elif defined __WIN32__
+	ReleaseSemaphore(_semaphoreOut, 1, NULL);
+#else
+	_semaphoreOut->post();
+#endif
+}
 
 bool IPCChannel::tryWait(int timeout)
 {
-	bool messageWaiting;
+	bool posted;
 
 #ifdef __APPLE__
 
-	messageWaiting = sem_trywait(_semaphoreIn) == 0;
+	posted = sem_trywait(_semaphoreIn) == 0;
 
-	while (timeout > 0 && messageWaiting == false)
+	while (timeout > 0 && posted == false)
 	{
-		usleep(100000);
+		usleep(10000);
 		timeout -= 10;
-		messageWaiting = sem_trywait(_semaphoreIn) == 0;
+		posted = sem_trywait(_semaphoreIn) == 0;
 	}
 
 #elif defined __WIN32__
 
-	messageWaiting = (WaitForSingleObject(_semaphoreIn, timeout) == WAIT_OBJECT_0);
+	posted = (WaitForSingleObject(_semaphoreIn, timeout) == WAIT_OBJECT_0);
 
 #else
 
@@ -277,14 +385,14 @@ bool IPCChannel::tryWait(int timeout)
 		ptime now(microsec_clock::universal_time());
 		ptime then = now + microseconds(1000 * timeout);
 
-		messageWaiting = _semaphoreIn->timed_wait(then);
+		posted = _semaphoreIn->timed_wait(then);
 	}
 	else
 	{
-		messageWaiting = _semaphoreIn->try_wait();
+		posted = _semaphoreIn->try_wait();
 	}
 #endif
 
-	return messageWaiting;
+	return posted;
 
 }
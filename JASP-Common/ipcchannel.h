@@ -35,52 +35,104 @@
 #endif
 
 #include <boost/interprocess/managed_shared_memory.hpp>
-#include <boost/container/string.hpp>
+#include <boost/function.hpp>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+/* Every direction of an IPCChannel is a single-producer/single-consumer ring
+ * buffer in shared memory. Messages are written as frames, each prefixed by
+ * an IPCFrameHeader. A message that does not fit in the free space is
+ * streamed as several frames, and only the last one has last set. The
+ * semaphores only wake up the other side, the ring itself says whether
+ * something is waiting. That means several messages can be queued.
+ * A sender waiting for room moves whatever arrived in its own incoming ring
+ * aside, so two sides streaming large messages to each other at the same
+ * time both keep going.
+ */
+struct IPCRing
+{
+	IPCRing(uint64_t capacity) : head(0), tail(0), capacity(capacity) {}
 
-typedef boost::interprocess::allocator<char, boost::interprocess::managed_shared_memory::segment_manager> CharAllocator;
-typedef boost::container::basic_string<char, std::char_traits<char>, CharAllocator> String;
-typedef boost::interprocess::allocator<String, boost::interprocess::managed_shared_memory::segment_manager> StringAllocator;
+	std::atomic<uint64_t>	head,		///< Bytes ever written, only moved by the sender
+							tail;		///< Bytes ever read, only moved by the receiver
+	const uint64_t			capacity;
+};
+
+struct IPCFrameHeader
+{
+	uint32_t	size,
+				last;
+};
 
 class IPCChannel
 {
 public:
+	typedef boost::function<void(const char * message, size_t size)> MessageHandler;
+
 	IPCChannel(std::string name, int channelNumber, bool isSlave = false);
+	~IPCChannel();
+
+	void send(const std::string &data);
+	void send(const char * data, size_t size);
 
-	void send(std::string &data,	bool alreadyLockedMutex = false);
-	void send(std::string &&data,	bool alreadyLockedMutex = false);
-	bool receive(std::string &data, int timeout = 0);
+	///The message is passed straight from shared memory when it arrived in one piece, so handler shouldn't keep the pointer
+	bool receive(MessageHandler handler,	int timeout = 0);
+	bool receive(std::string &data,			int timeout = 0);
+	bool waitForMessage(int timeout);	///< Blocks until a message is waiting or timeout (ms) passes, without consuming it.
 
 	int channelNumber() { return _channelNumber; }
 
 private:
-
 	bool tryWait(int timeout = 0);
+	void postOut();
+
+	bool ringFrameWaiting()	const { return _ringIn->head.load(std::memory_order_acquire) != _ringIn->tail.load(std::memory_order_relaxed); }
+	bool messageWaiting()	const { return _stashedCount.load(std::memory_order_acquire) > 0 || ringFrameWaiting(); }
+	bool waitForData(int timeout);
+	void waitForSpace(uint64_t needed);
+
+	void takeFrame(		IPCFrameHeader & header, std::string & into);	///< Appends the payload of the next incoming frame, stashed ones first
+	void takeRingFrame(	IPCFrameHeader & header, std::string & into);
+	void stashIncoming();
 
-	std::string _baseName, _nameControl, _nameMtS, _nameStM;
+	void writeRing(uint64_t position, const char * from, size_t size);
+	void readRing(uint64_t position, char * to, size_t size) const;
+
+	std::string _baseName, _nameMtS, _nameStM;
 	int _channelNumber;
 	bool _isSlave;
 
-	void doubleMemoryOut();
-	void rebindMemoryInIfSizeChanged();
-
-	boost::interprocess::managed_shared_memory *_memoryControl, *_memoryMasterToSlave, *_memorySlaveToMaster, *_memoryIn, *_memoryOut;
+	boost::interprocess::managed_shared_memory *_memoryMasterToSlave, *_memorySlaveToMaster;
 
-	boost::interprocess::interprocess_mutex *_mutexOut;
-	boost::interprocess::interprocess_mutex *_mutexIn;
+	IPCRing	*_ringIn,
+			*_ringOut;
+	char	*_dataIn,
+			*_dataOut;
 
-	String *_dataOut, * _dataIn;
+	std::string _assembled; ///< Where messages that came in several frames are put together
 
+	struct IPCFrame
+	{
+		IPCFrameHeader	header;
+		std::string		data;
+	};
 
-	size_t *_sizeMtoS, *_sizeStoM, *_sizeIn, *_sizeOut, _previousSizeIn, _previousSizeOut;
+	std::deque<IPCFrame>	_stashed;				///< Incoming frames taken out of the ring by waitForSpace, they come before anything still in the ring
+	std::atomic<size_t>		_stashedCount{0};		///< _stashed.size() for the thread that only watches for messages
+	bool					_handlingInPlace = false;	///< A handler is reading the current frame straight from the ring so it may not be stashed
 
 	void generateNames();
-	std::string _mutexInName,
-				_mutexOutName,
-				_dataInName,
+	std::string _dataInName,
 				_dataOutName,
 				_semaphoreInName,
 				_semaphoreOutName;
 
+	static const uint64_t	_ringCapacity		= 1024 * 1024 * 8;
+	static const uint64_t	_minimumChunk		= 1024 * 64;
+	static const int		_streamTimeout		= 30000; ///< ms to wait for the rest of a message before giving up on the sender
+
 #ifdef __APPLE__
 	sem_t* _semaphoreOut;
 	sem_t* _semaphoreIn;
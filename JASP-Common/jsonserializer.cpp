@@ -0,0 +1,481 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "jsonserializer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+
+std::string JsonSerializer::compact(const Json::Value & value)
+{
+	std::string out;
+	appendCompact(value, out);
+	return out;
+}
+
+std::string JsonSerializer::messagePack(const Json::Value & value)
+{
+	std::string out;
+	appendMessagePack(value, out);
+	return out;
+}
+
+static void appendInteger(int64_t value, std::string & out)
+{
+	char	buffer[24],
+		*	end		= buffer + sizeof(buffer),
+		*	start	= end;
+	bool	negative	= value < 0;
+	uint64_t magnitude	= negative ? uint64_t(0) - uint64_t(value) : uint64_t(value);
+
+	do		{ *--start = char('0' + magnitude % 10); magnitude /= 10; }
+	while	(magnitude > 0);
+
+	if(negative)
+		*--start = '-';
+
+	out.append(start, end - start);
+}
+
+void JsonSerializer::appendDouble(double value, std::string & out)
+{
+	if(!std::isfinite(value)) //Would not be valid JSON
+	{
+		out += "null";
+		return;
+	}
+
+	char	buffer[32];
+	int		length		= std::snprintf(buffer, sizeof(buffer), "%.16g", value); //The precision toStyledString() uses
+	bool	looksReal	= false;
+
+	for(int i=0; i<length; i++)
+		switch(buffer[i])
+		{
+		case ',':	buffer[i] = '.';	looksReal = true;	break; //Some locales write a comma
+		case '.':
+		case 'e':						looksReal = true;	break;
+		default:											break;
+		}
+
+	out.append(buffer, length);
+
+	if(!looksReal) //Otherwise it would come back as an int
+		out += ".0";
+}
+
+void JsonSerializer::appendQuoted(const char * text, std::string & out)
+{
+	static const char hex[] = "0123456789ABCDEF";
+
+	out += '"';
+
+	const char * from = text;
+
+	for(const char * c = text; *c != '\0'; c++)
+	{
+		unsigned char kar = *c;
+
+		if(kar >= 0x20 && kar != '"' && kar != '\\')
+			continue;
+
+		out.append(from, c - from);
+		from = c + 1;
+
+		switch(kar)
+		{
+		case '"':	out += "\\\"";	break;
+		case '\\':	out += "\\\\";	break;
+		case '\b':	out += "\\b";	break;
+		case '\f':	out += "\\f";	break;
+		case '\n':	out += "\\n";	break;
+		case '\r':	out += "\\r";	break;
+		case '\t':	out += "\\t";	break;
+		default:
+			out += "\\u00";
+			out += hex[kar >> 4];
+			out += hex[kar & 0xF];
+			break;
+		}
+	}
+
+	out.append(from);
+	out += '"';
+}
+
+void JsonSerializer::appendCompact(const Json::Value & value, std::string & out)
+{
+	switch(value.type())
+	{
+	case Json::nullValue:		out += "null";									break;
+	case Json::intValue:		appendInteger(value.asInt(), out);				break;
+	case Json::uintValue:		appendInteger(value.asUInt(), out);				break;
+	case Json::realValue:		appendDouble(value.asDouble(), out);			break;
+	case Json::stringValue:		appendQuoted(value.asCString(), out);			break;
+	case Json::booleanValue:	out += value.asBool() ? "true" : "false";		break;
+
+	case Json::arrayValue:
+	{
+		out += '[';
+
+		for(Json::UInt i=0; i<value.size(); i++)
+		{
+			if(i > 0)
+				out += ',';
+			appendCompact(value[i], out);
+		}
+
+		out += ']';
+		break;
+	}
+
+	case Json::objectValue:
+	{
+		out += '{';
+
+		bool first = true;
+		for(Json::Value::const_iterator member = value.begin(); member != value.end(); member++)
+		{
+			if(!first)
+				out += ',';
+			first = false;
+
+			appendQuoted(member.memberName(), out);
+			out += ':';
+			appendCompact(*member, out);
+		}
+
+		out += '}';
+		break;
+	}
+	}
+}
+
+//MessagePack keeps its numbers big endian
+static void appendBigEndian(uint64_t value, int bytes, std::string & out)
+{
+	for(int byte = bytes - 1; byte >= 0; byte--)
+		out += char((value >> (8 * byte)) & 0xFF);
+}
+
+static void appendHeader(unsigned char small, unsigned char medium, unsigned char large, size_t count, std::string & out)
+{
+	if(count < 16)				out += char(small | count);
+	else if(count <= 0xFFFF)	{ out += char(medium);	appendBigEndian(count, 2, out); }
+	else						{ out += char(large);	appendBigEndian(count, 4, out); }
+}
+
+static void appendMessagePackInteger(int64_t value, std::string & out)
+{
+	if(value >= 0)
+	{
+		if(value <= 0x7F)			out += char(value);
+		else if(value <= 0xFF)		{ out += char(0xcc); appendBigEndian(value, 1, out); }
+		else if(value <= 0xFFFF)	{ out += char(0xcd); appendBigEndian(value, 2, out); }
+		else						{ out += char(0xce); appendBigEndian(value, 4, out); }
+	}
+	else
+	{
+		if(value >= -32)			out += char(value);
+		else if(value >= INT8_MIN)	{ out += char(0xd0); appendBigEndian(uint64_t(value), 1, out); }
+		else if(value >= INT16_MIN)	{ out += char(0xd1); appendBigEndian(uint64_t(value), 2, out); }
+		else						{ out += char(0xd2); appendBigEndian(uint64_t(value), 4, out); }
+	}
+}
+
+static void appendMessagePackString(const char * text, std::string & out)
+{
+	size_t length = std::strlen(text);
+
+	if(length < 32)				out += char(0xa0 | length);
+	else if(length <= 0xFF)		{ out += char(0xd9); appendBigEndian(length, 1, out); }
+	else if(length <= 0xFFFF)	{ out += char(0xda); appendBigEndian(length, 2, out); }
+	else						{ out += char(0xdb); appendBigEndian(length, 4, out); }
+
+	out.append(text, length);
+}
+
+static bool isDoubleArray(const Json::Value & value)
+{
+	if(value.size() < JsonSerializer::doubleArrayMinimum)
+		return false;
+
+	for(Json::UInt i=0; i<value.size(); i++)
+		if(value[i].type() != Json::realValue || !std::isfinite(value[i].asDouble())) //Those are written as nil one by one
+			return false;
+
+	return true;
+}
+
+void JsonSerializer::appendMessagePack(const Json::Value & value, std::string & out)
+{
+	switch(value.type())
+	{
+	case Json::nullValue:		out += char(0xc0);										break;
+	case Json::intValue:		appendMessagePackInteger(value.asInt(), out);			break;
+	case Json::uintValue:		appendMessagePackInteger(value.asUInt(), out);			break;
+	case Json::stringValue:		appendMessagePackString(value.asCString(), out);		break;
+	case Json::booleanValue:	out += char(value.asBool() ? 0xc3 : 0xc2);				break;
+
+	case Json::realValue:
+	{
+		double		real = value.asDouble();
+
+		if(!std::isfinite(real)) //JSON has no NaN or Inf, so compact() writes null for them and here it is nil
+		{
+			out += char(0xc0);
+			break;
+		}
+
+		uint64_t	bits;
+		std::memcpy(&bits, &real, sizeof(double));
+
+		out += char(0xcb);
+		appendBigEndian(bits, 8, out);
+		break;
+	}
+
+	case Json::arrayValue:
+		if(isDoubleArray(value))
+		{
+			size_t bytes = value.size() * sizeof(double);
+
+			if(bytes <= 0xFF)			{ out += char(0xc7); appendBigEndian(bytes, 1, out); }
+			else if(bytes <= 0xFFFF)	{ out += char(0xc8); appendBigEndian(bytes, 2, out); }
+			else						{ out += char(0xc9); appendBigEndian(bytes, 4, out); }
+
+			out += doubleArrayExtType;
+
+			for(Json::UInt i=0; i<value.size(); i++)
+			{
+				double		real = value[i].asDouble();
+				uint64_t	bits;
+				std::memcpy(&bits, &real, sizeof(double));
+
+				for(int byte = 0; byte < 8; byte++)
+					out += char((bits >> (8 * byte)) & 0xFF);
+			}
+		}
+		else
+		{
+			appendHeader(0x90, 0xdc, 0xdd, value.size(), out);
+
+			for(Json::UInt i=0; i<value.size(); i++)
+				appendMessagePack(value[i], out);
+		}
+		break;
+
+	case Json::objectValue:
+		appendHeader(0x80, 0xde, 0xdf, value.size(), out);
+
+		for(Json::Value::const_iterator member = value.begin(); member != value.end(); member++)
+		{
+			appendMessagePackString(member.memberName(), out);
+			appendMessagePack(*member, out);
+		}
+		break;
+	}
+}
+
+bool JsonSerializer::isMessagePack(const char * message, size_t size)
+{
+	if(size == 0)
+		return false;
+
+	unsigned char first = message[0];
+
+	return (first & 0xF0) == 0x80 || first == 0xde || first == 0xdf; //All messages are objects, so they start with a map
+}
+
+bool JsonSerializer::parse(const char * message, size_t size, Json::Value & out)
+{
+	if(isMessagePack(message, size))
+		return parseMessagePack(message, size, out);
+
+	return Json::Reader().parse(message, message + size, out, false);
+}
+
+namespace
+{
+	class MessagePackReader
+	{
+	public:
+		MessagePackReader(const char * message, size_t size) : _at(reinterpret_cast<const unsigned char *>(message)), _end(_at + size) {}
+
+		bool atEnd() const { return _at == _end; }
+
+		void read(Json::Value & out)
+		{
+			unsigned char kind = take(1)[0];
+
+			if(kind <= 0x7f)			{ out = Json::Value(int(kind));					return; }
+			if(kind >= 0xe0)			{ out = Json::Value(int(int8_t(kind)));			return; }
+			if((kind & 0xF0) == 0x80)	{ readMap(kind & 0x0F, out);					return; }
+			if((kind & 0xF0) == 0x90)	{ readArray(kind & 0x0F, out);					return; }
+			if((kind & 0xE0) == 0xa0)	{ readString(kind & 0x1F, out);					return; }
+
+			switch(kind)
+			{
+			case 0xc0:	out = Json::nullValue;										return;
+			case 0xc2:	out = false;												return;
+			case 0xc3:	out = true;													return;
+			case 0xc4:
+			case 0xd9:	readString(bigEndian(1), out);								return;
+			case 0xc5:
+			case 0xda:	readString(bigEndian(2), out);								return;
+			case 0xc6:
+			case 0xdb:	readString(bigEndian(4), out);								return;
+			case 0xc7:	readExt(bigEndian(1), out);									return;
+			case 0xc8:	readExt(bigEndian(2), out);									return;
+			case 0xc9:	readExt(bigEndian(4), out);									return;
+			case 0xca:	{ uint32_t bits = bigEndian(4); float real; std::memcpy(&real, &bits, 4); out = double(real); return; }
+			case 0xcb:	{ uint64_t bits = bigEndian(8); double real; std::memcpy(&real, &bits, 8); out = real; return; }
+			case 0xcc:	setInteger(int64_t(bigEndian(1)), out);						return;
+			case 0xcd:	setInteger(int64_t(bigEndian(2)), out);						return;
+			case 0xce:	setInteger(int64_t(bigEndian(4)), out);						return;
+			case 0xcf:	setUnsigned(bigEndian(8), out);								return;
+			case 0xd0:	setInteger(int8_t(bigEndian(1)), out);						return;
+			case 0xd1:	setInteger(int16_t(bigEndian(2)), out);						return;
+			case 0xd2:	setInteger(int32_t(bigEndian(4)), out);						return;
+			case 0xd3:	setInteger(int64_t(bigEndian(8)), out);						return;
+			case 0xdc:	readArray(bigEndian(2), out);								return;
+			case 0xdd:	readArray(bigEndian(4), out);								return;
+			case 0xde:	readMap(bigEndian(2), out);									return;
+			case 0xdf:	readMap(bigEndian(4), out);									return;
+			default:	throw JsonSerializer::malformed("Unsupported MessagePack type " + std::to_string(int(kind)));
+			}
+		}
+
+	private:
+		const unsigned char * take(size_t bytes)
+		{
+			if(size_t(_end - _at) < bytes)
+				throw JsonSerializer::malformed("MessagePack message is cut off");
+
+			const unsigned char * taken = _at;
+			_at += bytes;
+			return taken;
+		}
+
+		uint64_t bigEndian(int bytes)
+		{
+			const unsigned char * data = take(bytes);
+			uint64_t value = 0;
+
+			for(int byte = 0; byte < bytes; byte++)
+				value = (value << 8) | data[byte];
+
+			return value;
+		}
+
+		//Json::Value only has 32 bits integers, larger ones become doubles
+		void setInteger(int64_t value, Json::Value & out)
+		{
+			if(value >= std::numeric_limits<Json::Int>::min() && value <= std::numeric_limits<Json::Int>::max())	out = Json::Int(value);
+			else if(value > 0 && uint64_t(value) <= std::numeric_limits<Json::UInt>::max())						out = Json::UInt(value);
+			else																									out = double(value);
+		}
+
+		void setUnsigned(uint64_t value, Json::Value & out)
+		{
+			if(value <= uint64_t(std::numeric_limits<int64_t>::max()))	setInteger(int64_t(value), out);
+			else														out = double(value);
+		}
+
+		void readString(size_t length, Json::Value & out)
+		{
+			const char * text = reinterpret_cast<const char *>(take(length));
+			out = std::string(text, length);
+		}
+
+		void readArray(size_t count, Json::Value & out)
+		{
+			out = Json::Value(Json::arrayValue);
+
+			if(count > 0)
+				out.resize(count);
+
+			for(size_t i=0; i<count; i++)
+				read(out[Json::UInt(i)]);
+		}
+
+		void readMap(size_t count, Json::Value & out)
+		{
+			out = Json::Value(Json::objectValue);
+
+			Json::Value key;
+			for(size_t i=0; i<count; i++)
+			{
+				read(key);
+
+				if(!key.isString())
+					throw JsonSerializer::malformed("MessagePack map has a key that is not a string");
+
+				read(out[key.asString()]);
+			}
+		}
+
+		void readExt(size_t bytes, Json::Value & out)
+		{
+			char type = char(take(1)[0]);
+
+			if(type != JsonSerializer::doubleArrayExtType || bytes % sizeof(double) != 0)
+				throw JsonSerializer::malformed("Unsupported MessagePack extension " + std::to_string(int(type)));
+
+			const unsigned char * data	= take(bytes);
+			size_t				count	= bytes / sizeof(double);
+
+			out = Json::Value(Json::arrayValue);
+
+			if(count > 0)
+				out.resize(count);
+
+			for(size_t i=0; i<count; i++)
+			{
+				uint64_t bits = 0;
+				for(int byte = 7; byte >= 0; byte--)
+					bits = (bits << 8) | data[i * sizeof(double) + byte];
+
+				double real;
+				std::memcpy(&real, &bits, sizeof(double));
+				out[Json::UInt(i)] = real;
+			}
+		}
+
+		const unsigned char	*	_at,
+							*	_end;
+	};
+}
+
+bool JsonSerializer::parseMessagePack(const char * message, size_t size, Json::Value & out)
+{
+	try
+	{
+		MessagePackReader reader(message, size);
+		reader.read(out);
+
+		return reader.atEnd();
+	}
+	catch(malformed & error)
+	{
+		out = Json::nullValue;
+		return false;
+	}
+}
@@ -0,0 +1,67 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef JSONSERIALIZER_H
+#define JSONSERIALIZER_H
+
+#include <string>
+#include <stdexcept>
+
+#include "jsonredirect.h"
+#include "enginedefinitions.h"
+
+/**
+ * @brief The JsonSerializer class - Turns the messages between the Desktop and the Engines into text or bytes and back.
+ *
+ * compact() writes JSON without any of the indentation of toStyledString(), numbers keep the same precision.
+ * messagePack() writes MessagePack, arrays of at least doubleArrayMinimum doubles go in one ext block (type doubleArrayExtType) of little endian doubles.
+ * parse() accepts both, a message that starts with a MessagePack map is read as MessagePack and anything else as JSON.
+ * Both write NaN and Inf as null, so a message reads the same whichever format it was sent in.
+ */
+class JsonSerializer
+{
+public:
+	static std::string	compact(		const Json::Value & value);
+	static std::string	messagePack(	const Json::Value & value);
+	static std::string	serialize(		const Json::Value & value, messageFormat format) { return format == messageFormat::messagePack ? messagePack(value) : compact(value); }
+
+	static void			appendCompact(		const Json::Value & value, std::string & out);
+	static void			appendMessagePack(	const Json::Value & value, std::string & out);
+
+	static bool				isMessagePack(		const char * message, size_t size);
+	static messageFormat	formatOf(			const char * message, size_t size) { return isMessagePack(message, size) ? messageFormat::messagePack : messageFormat::json; }
+	static bool				parse(				const char * message, size_t size, Json::Value & out);
+	static bool				parseMessagePack(	const char * message, size_t size, Json::Value & out);
+
+	static const char	doubleArrayExtType	= 1;
+	static const size_t	doubleArrayMinimum	= 4;
+
+	/// Thrown while reading MessagePack that is cut off or uses something not supported here, parse() turns it into false.
+	class malformed : public std::runtime_error
+	{
+	public:
+		malformed(const std::string & what) : std::runtime_error(what) {}
+	};
+
+private:
+	JsonSerializer();
+
+	static void			appendDouble(double value, std::string & out);
+	static void			appendQuoted(const char * text, std::string & out);
+};
+
+#endif // JSONSERIALIZER_H
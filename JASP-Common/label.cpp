@@ -16,49 +16,25 @@
 //
 
 #include "label.h"
+#include "stringpool.h"
 
-#include <sstream>
-#include <cstring>
-
-void Label::_setLabel(const std::string &label) {
-    _stringLength = label.length();
-    if (sizeof(_stringValue) < label.length())
-        _stringLength = sizeof(_stringValue);
-
-    std::memcpy(_stringValue, label.c_str(), _stringLength);
-}
-
-Label::Label(const std::string &label, int value, bool filterAllows)
+Label::Label(const char * pooledText, int value, bool filterAllows, bool hasIntValue)
 {
-    _setLabel(label);
-	_hasIntValue = false;
-	_intValue = value;
-	_filterAllow = filterAllows;
-}
-
-Label::Label(int value)
-{
-	std::stringstream ss;
-	ss << value;
-	std::string asString = ss.str();
-
-	std::memcpy(_stringValue, asString.c_str(), asString.length());
-	_stringLength = asString.length();
-
-	_hasIntValue = true;
-	_intValue = value;
+	_text			= pooledText;
+	_hasIntValue	= hasIntValue;
+	_intValue		= value;
+	_filterAllow	= filterAllows;
 }
 
 Label::Label()
 {
 	_hasIntValue = false;
 	_intValue = -1;
-	_stringLength = 0;
 }
 
 std::string Label::text() const
 {
-	return std::string(_stringValue, _stringLength);
+	return _text ? std::string(_text.get(), StringPool::length(_text.get())) : std::string();
 }
 
 bool Label::hasIntValue() const
@@ -70,19 +46,3 @@ int Label::value() const
 {
 	return _intValue;
 }
-
-void Label::setLabel(const std::string &label) {
-    _setLabel(label);
-}
-
-Label &Label::operator=(const Label &label)
-{
-	this->_hasIntValue	= label._hasIntValue;
-	this->_intValue		= label._intValue;
-	this->_filterAllow	= label._filterAllow;
-
-	std::memcpy(_stringValue, label._stringValue, label._stringLength);
-	_stringLength = label._stringLength;
-
-	return *this;
-}
@@ -19,42 +19,41 @@
 #define LABEL_H
 
 #include <string>
+#include <boost/interprocess/offset_ptr.hpp>
 
 /*********
  * Label is a class that stores the value of a column if it is not a Scale (a Nominal Int, Nominal Text, or Ordinal).
  * The value is either an integer or a string.
- * If it is an integer, the _intValue is this value, and _stringValue is at first the corresponding string.
- * _stringValue can be then changed in the Variable tab in JASP.
+ * If it is an integer, the _intValue is this value, and the text is at first the corresponding string.
+ * The text can be then changed in the Variable tab in JASP.
  * If the value is a string, _intValue is the key that maps the label with the AsInts property of the column object.
- * _stringValue is then the value, that can be changed in the Variable tab in JASP. If changed the original value
+ * The text is then the value, that can be changed in the Variable tab in JASP. If changed the original value
  * is saved in the _orgStringValues static property of the Labels class.
+ * The text itself lives in the StringPool of the DataSet, Labels interns it there, so it has no maximum length.
  *********/
 
 class Label
 {
 public:
-	static const int MAX_LABEL_LENGTH = 128;
-	Label(const std::string &label, int value, bool filterAllows);
-	Label(int value);
+	Label(const char * pooledText, int value, bool filterAllows, bool hasIntValue = false);
 	Label();
 
 	std::string text() const;
 	bool hasIntValue() const;
 	int value() const;
-    void setLabel(const std::string &label);
-	Label& operator=(const Label &label);
 
 	bool filterAllows() const { return _filterAllow; }
 	void setFilterAllows(bool allowFilter) { _filterAllow = allowFilter; }
 
 private:
+	friend class Labels;
+
+	void _setText(const char * pooledText) { _text = pooledText; }
+
+	boost::interprocess::offset_ptr<const char> _text;
 
 	bool _hasIntValue;
 	int _intValue;
-	char _stringValue[MAX_LABEL_LENGTH];
-	int  _stringLength;
-
-    void _setLabel(const std::string &label);
 
 	bool _filterAllow = true;
 };
@@ -17,6 +17,8 @@
 
 #include "labels.h"
 #include "iostream"
+#include <cstdint>
+#include <unordered_set>
 
 
 using namespace std;
@@ -25,7 +27,7 @@ map<int, map<int, string> > Labels::_orgStringValues;
 int Labels::_counter = 0;
 
 Labels::Labels(boost::interprocess::managed_shared_memory *mem)
-	: _labels(mem->get_segment_manager())
+	: _labels(mem->get_segment_manager()), _keyIndex(mem->get_segment_manager())
 {
 	 _id = ++Labels::_counter;
 	_mem = mem;
@@ -38,12 +40,15 @@ Labels::~Labels()
 void Labels::clear()
 {
 	_labels.clear();
+	_keyIndex.clear();
+	_revision++;
 }
 
 int Labels::add(int display)
 {
-	Label label(display);
+	Label label(_intern(std::to_string(display)), display, true, true);
 	_labels.push_back(label);
+	_addToKeyIndex(_labels.size() - 1);
 
 	return display;
 }
@@ -55,8 +60,9 @@ int Labels::add(const std::string &display)
 
 int Labels::add(int key, const std::string &display, bool filterAllows)
 {
-	Label label(display, key, filterAllows);
+	Label label(_intern(display), key, filterAllows);
 	_labels.push_back(label);
+	_addToKeyIndex(_labels.size() - 1);
 
 	return key;
 }
@@ -68,9 +74,11 @@ void Labels::removeValues(std::set<int> valuesToRemove)
 			_labels.begin(),
 			_labels.end(),
 			[&valuesToRemove](const Label& label) {
-				return std::find(valuesToRemove.begin(), valuesToRemove.end(), label.value()) != valuesToRemove.end();
+				return valuesToRemove.count(label.value()) > 0;
 			}),
 		_labels.end());
+
+	_rebuildKeyIndex();
 }
 
 bool Labels::syncInts(map<int, string> &values)
@@ -104,12 +112,8 @@ bool Labels::syncInts(const std::set<int> &values)
 	for (const Label& label : _labels)
 	{
 		int value = label.value();
-		if (std::find(values.begin(), values.end(), value) != values.end())
-		{
-			std::set<int>::iterator value_it = std::find(valuesToAdd.begin(), valuesToAdd.end(), value);
-			if (value_it != valuesToAdd.end())
-				valuesToAdd.erase(value_it);
-		}
+		if (values.count(value) > 0)
+			valuesToAdd.erase(value);
 		else
 		{
 			std::cout << "Remove label " << label.text() << std::endl;
@@ -119,7 +123,8 @@ bool Labels::syncInts(const std::set<int> &values)
 	}
 
 
-	removeValues(valuesToRemove);	
+	if (valuesToRemove.size() > 0)
+		removeValues(valuesToRemove);
 
 	for (int value : valuesToAdd)
 		add(value);
@@ -129,13 +134,8 @@ bool Labels::syncInts(const std::set<int> &values)
 
 std::map<std::string, int> Labels::syncStrings(const std::vector<std::string> &new_values, const std::map<std::string, std::string> &new_labels, bool *changedSomething)
 {
-	std::map<std::string,std::string> valuesToAdd;
-
-	for (const std::string& newValue : new_values)
-	{
-		std::string shortValue	= newValue.length() > Label::MAX_LABEL_LENGTH ? newValue.substr(0, Label::MAX_LABEL_LENGTH) : newValue;
-		valuesToAdd[shortValue] = newValue;
-	}
+	// Indexed on the value so that every existing label is matched in O(1)
+	std::unordered_set<std::string> valuesToAdd(new_values.begin(), new_values.end());
 	
 	std::set<int>				valuesToRemove;
 	std::map<std::string, int>	result;
@@ -152,7 +152,7 @@ std::map<std::string, int> Labels::syncStrings(const std::vector<std::string> &n
 		auto elt = valuesToAdd.find(labelText);
 		if (elt != valuesToAdd.end())
 		{
-			result[elt->second] = labelValue;
+			result[*elt] = labelValue;
 			valuesToAdd.erase(elt);
 		}
 		else
@@ -162,13 +162,16 @@ std::map<std::string, int> Labels::syncStrings(const std::vector<std::string> &n
 	if(changedSomething != NULL && (valuesToRemove.size() > 0 || valuesToAdd.size() > 0))
 		*changedSomething = true;
 
-	removeValues(valuesToRemove);
-	
-	for (auto elt : valuesToAdd)
+	if (valuesToRemove.size() > 0)
+		removeValues(valuesToRemove);
+
+	std::set<std::string> sortedValuesToAdd(valuesToAdd.begin(), valuesToAdd.end()); //New keys are handed out in sorted order, as before
+
+	for (const std::string & value : sortedValuesToAdd)
 	{
 		maxLabelKey++;
-		add(maxLabelKey, elt.first, true);
-		result[elt.second] = maxLabelKey;
+		add(maxLabelKey, value, true);
+		result[value] = maxLabelKey;
 	}
 
 	for (Label& label : _labels)
@@ -210,15 +213,63 @@ void Labels::setOrgStringValues(int key, std::string value)
 	orgStringValues[key] = value;
 }
 
-const Label &Labels::getLabelObjectFromKey(int index) const
+int Labels::indexOfKey(int key) const
+{
+	if (_keyIndex.size() == 0)
+		return -1;
+
+	size_t mask = _keyIndex.size() - 1;
 
+	for (size_t slot = (uint32_t(key) * 2654435761u) & mask; _keyIndex[slot] != 0; slot = (slot + 1) & mask)
+		if (_labels[_keyIndex[slot] - 1].value() == key)
+			return _keyIndex[slot] - 1;
+
+	return -1;
+}
+
+void Labels::_addToKeyIndex(size_t position)
 {
-	for (const Label &label: _labels)
+	_revision++;
+
+	if (_keyIndex.size() < 2 * _labels.size())
 	{
-		if (label.value() == index)
-			return label;
+		_rebuildKeyIndex();
+		return;
 	}
 
+	int		key		= _labels[position].value();
+	size_t	mask	= _keyIndex.size() - 1,
+			slot	= (uint32_t(key) * 2654435761u) & mask;
+
+	for (; _keyIndex[slot] != 0; slot = (slot + 1) & mask)
+		if (_labels[_keyIndex[slot] - 1].value() == key)
+			return; //Like the old linear search the first label with a key wins
+
+	_keyIndex[slot] = int(position) + 1;
+}
+
+void Labels::_rebuildKeyIndex()
+{
+	_revision++;
+
+	size_t slots = 16;
+	while (slots < 4 * _labels.size())
+		slots *= 2;
+
+	_keyIndex.assign(_labels.size() == 0 ? 0 : slots, 0);
+
+	for (size_t position = 0; position < _labels.size(); position++)
+		_addToKeyIndex(position);
+}
+
+const Label &Labels::getLabelObjectFromKey(int index) const
+
+{
+	int position = indexOfKey(index);
+
+	if (position >= 0)
+		return _labels[position];
+
 	std::cout << "Cannot find entry " << index << std::endl;
 	for(const Label &label: _labels)
 	{
@@ -259,7 +310,16 @@ void Labels::_setNewStringForLabel(Label &label, const string &display)
 	map<int, string> &orgStringValues = getOrgStringValues();
 	if (orgStringValues.find(label_value) == orgStringValues.end())
 		orgStringValues[label_value] = label_string;
-	label.setLabel(display);
+	label._setText(_intern(display));
+	_revision++;
+}
+
+const char *Labels::_intern(const string &text)
+{
+	if (!_pool)
+		_pool = StringPool::of(_labels.get_stored_allocator().get_segment_manager());
+
+	return _pool->intern(text);
 }
 
 string Labels::_getValueFromLabel(const Label &label) const
@@ -328,6 +388,8 @@ void Labels::set(vector<Label> &labels)
 	{
 		_labels.push_back(label);
 	}
+
+	_rebuildKeyIndex();
 }
 
 size_t Labels::size() const
@@ -341,6 +403,7 @@ Labels &Labels::operator=(const Labels &labels)
 	{
 		this->_mem = labels._mem;
 		this->_labels = labels._labels;
+		_rebuildKeyIndex();
 	}
 
 	return *this;
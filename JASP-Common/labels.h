@@ -19,6 +19,7 @@
 #define LABELS_H
 
 #include "label.h"
+#include "stringpool.h"
 #include <map>
 #include <vector>
 #include <set>
@@ -32,6 +33,9 @@
 typedef boost::interprocess::allocator<Label, boost::interprocess::managed_shared_memory::segment_manager> LabelAllocator;
 typedef boost::container::vector<Label, LabelAllocator> LabelVector;
 
+typedef boost::interprocess::allocator<int, boost::interprocess::managed_shared_memory::segment_manager> LabelIndexAllocator;
+typedef boost::container::vector<int, LabelIndexAllocator> LabelIndexVector;
+
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/range/const_iterator.hpp>
 
@@ -70,6 +74,9 @@ public:
 	std::string getValueFromKey(int key) const;
 	const Label &getLabelObjectFromKey(int key) const;
 
+	// Position of the label with this key, or -1. Uses a hash index kept next to the labels in shared memory, so it is O(1) in both the Desktop and the Engine.
+	int indexOfKey(int key) const;
+
 	// These 3 methods are used by the Variable Page to get/set the value & label of a Variable
 	// (confusing is that a Variable is a Label object). The row means here the row of the
 	// Variable in the table (as displayed to the user).
@@ -79,13 +86,25 @@ public:
 	std::string getValueFromRow(int);
 	bool setLabelFromRow(int row, const std::string &display);
 
+	// Goes up whenever labels are added, removed, reordered or renamed, so the Engine can tell whether what it made of them is still up to date.
+	unsigned int revision() const { return _revision; }
+
 private:
 	void _setNewStringForLabel(Label &label, const std::string &display);
 	std::string _getValueFromLabel(const Label &label) const;
 	std::string _getOrgValueFromLabel(const Label &label) const;
 
+	void _rebuildKeyIndex();
+	void _addToKeyIndex(size_t position);
+	const char * _intern(const std::string &text);
+
 	boost::interprocess::managed_shared_memory *_mem;
 	LabelVector _labels;
+	// Open addressing hash table from key to position in _labels + 1, 0 marks an empty slot. Its size is a power of two and at least twice the number of labels.
+	LabelIndexVector _keyIndex;
+	// Where the texts of the labels are kept, found on first use
+	boost::interprocess::offset_ptr<StringPool> _pool;
+	unsigned int _revision = 0;
 	int _id;
 	static int _counter;
 	// Original string values: used only when value is a string and when the label has been changed
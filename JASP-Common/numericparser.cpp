@@ -0,0 +1,264 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "numericparser.h"
+
+#include <cctype>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <stdint.h>
+
+using namespace std;
+
+bool NumericParser::parseInt(boost::string_view text, int &value)
+{
+	const char	*pos		= text.begin(),
+				*end		= text.end();
+	bool		negative	= false;
+
+	if (pos != end && (*pos == '+' || *pos == '-'))
+	{
+		negative = *pos == '-';
+		pos++;
+	}
+
+	if (pos == end)
+		return false;
+
+	const int64_t	limit	= negative ? -int64_t(INT_MIN) : int64_t(INT_MAX);
+	int64_t			result	= 0;
+
+	for (; pos != end; pos++)
+	{
+		unsigned digit = (unsigned char)*pos - '0';
+
+		if (digit > 9)
+			return false;
+
+		result = result * 10 + digit;
+
+		if (result > limit)
+			return false;
+	}
+
+	value = int(negative ? -result : result);
+
+	return true;
+}
+
+bool NumericParser::parseDouble(boost::string_view text, double &value)
+{
+	// Doubles that are exactly an integer of at most 53 bits times or divided by an exactly representable power of ten are computed directly,
+	// that is correctly rounded and covers nearly all data. Anything else is left to the standard library.
+	static const double powersOfTen[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	static const int	maxPowerOfTen	= 22;
+	static const int	maxDigits		= 19;
+
+	const char	*pos		= text.begin(),
+				*end		= text.end();
+	bool		negative	= false;
+
+	if (pos != end && (*pos == '+' || *pos == '-'))
+	{
+		negative = *pos == '-';
+		pos++;
+	}
+
+	if (pos == end)
+		return false;
+
+	if (*pos != '.' && (*pos < '0' || *pos > '9'))
+		return _parseSpecialDouble(boost::string_view(pos, end - pos), negative, value);
+
+	uint64_t	mantissa	= 0;
+	int			digits		= 0,
+				exponent	= 0;
+	bool		anyDigits	= false,
+				exact		= true;
+
+	for (; pos != end && *pos >= '0' && *pos <= '9'; pos++)
+	{
+		anyDigits = true;
+
+		if (digits < maxDigits)
+		{
+			mantissa = mantissa * 10 + (*pos - '0');
+			if (mantissa > 0)
+				digits++;
+		}
+		else
+		{
+			exponent++;
+			exact = exact && *pos == '0';
+		}
+	}
+
+	if (pos != end && *pos == '.')
+	{
+		for (pos++; pos != end && *pos >= '0' && *pos <= '9'; pos++)
+		{
+			anyDigits = true;
+
+			if (digits < maxDigits)
+			{
+				mantissa = mantissa * 10 + (*pos - '0');
+				exponent--;
+				if (mantissa > 0)
+					digits++;
+			}
+			else
+				exact = exact && *pos == '0';
+		}
+	}
+
+	if ( ! anyDigits)
+		return false;
+
+	if (pos != end && (*pos == 'e' || *pos == 'E'))
+	{
+		pos++;
+
+		bool negativeExponent = false;
+
+		if (pos != end && (*pos == '+' || *pos == '-'))
+		{
+			negativeExponent = *pos == '-';
+			pos++;
+		}
+
+		if (pos == end)
+			return false;
+
+		int writtenExponent = 0;
+
+		for (; pos != end && *pos >= '0' && *pos <= '9'; pos++)
+			if (writtenExponent < 100000)
+				writtenExponent = writtenExponent * 10 + (*pos - '0');
+
+		exponent += negativeExponent ? -writtenExponent : writtenExponent;
+	}
+
+	if (pos != end)
+		return false;
+
+	if (mantissa == 0 && exact)
+	{
+		value = negative ? -0.0 : 0.0;
+		return true;
+	}
+
+	if (exact && mantissa <= (uint64_t(1) << 53) && exponent >= -maxPowerOfTen && exponent <= maxPowerOfTen)
+	{
+		double result = double(mantissa);
+
+		if (exponent < 0)	result /= powersOfTen[-exponent];
+		else				result *= powersOfTen[exponent];
+
+		value = negative ? -result : result;
+		return true;
+	}
+
+	return _parseDoubleSlow(text, value);
+}
+
+bool NumericParser::_parseSpecialDouble(boost::string_view text, bool negative, double &value)
+{
+	struct caseInsensitive
+	{
+		static bool equals(boost::string_view text, const char *word)
+		{
+			size_t length = strlen(word);
+
+			if (text.size() != length)
+				return false;
+
+			for (size_t i = 0; i < length; i++)
+				if (tolower((unsigned char)text[i]) != word[i])
+					return false;
+
+			return true;
+		}
+	};
+
+	if (caseInsensitive::equals(text, "inf") || caseInsensitive::equals(text, "infinity"))
+	{
+		value = negative ? -numeric_limits<double>::infinity() : numeric_limits<double>::infinity();
+		return true;
+	}
+
+	if (caseInsensitive::equals(text, "nan") || (text.size() > 4 && caseInsensitive::equals(text.substr(0, 4), "nan(") && text.back() == ')'))
+	{
+		value = negative ? -numeric_limits<double>::quiet_NaN() : numeric_limits<double>::quiet_NaN();
+		return true;
+	}
+
+	return false;
+}
+
+bool NumericParser::_parseDoubleSlow(boost::string_view text, double &value)
+{
+	istringstream stream(string(text.begin(), text.end()));
+	stream.imbue(locale::classic());
+	stream.unsetf(ios::skipws);
+
+	double result;
+	stream >> result;
+
+	if (stream.fail() || stream.peek() != char_traits<char>::eof())
+		return false;
+
+	value = result;
+	return true;
+}
+
+boost::string_view NumericParser::deEuropeanise(boost::string_view text, char *buffer, size_t bufferSize, string &longer)
+{
+	size_t comma = text.find(',');
+
+	if (comma == boost::string_view::npos)
+		return text;
+
+	char *out = buffer;
+
+	if (text.size() > bufferSize)
+	{
+		longer.resize(text.size());
+		out = &longer[0];
+	}
+
+	bool	firstComma	= true;
+	size_t	written		= 0;
+
+	for (char ch : text)
+	{
+		if (ch == '.')
+			continue;
+
+		if (ch == ',' && firstComma)
+		{
+			ch			= '.';
+			firstComma	= false;
+		}
+
+		out[written++] = ch;
+	}
+
+	return boost::string_view(out, written);
+}
@@ -0,0 +1,61 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef NUMERICPARSER_H
+#define NUMERICPARSER_H
+
+#include <string>
+#include <boost/utility/string_view.hpp>
+
+/**
+ * @brief The NumericParser class - Converts text to numbers without exceptions or allocations.
+ *
+ * Accepts the same text as boost::lexical_cast<int> and boost::lexical_cast<double> in the classic locale,
+ * so no leading or trailing whitespace, but reports failure through the return value.
+ */
+class NumericParser
+{
+public:
+	/**
+	 * @brief parseInt Parses an optionally signed decimal integer.
+	 * @return false if text is not an integer or does not fit in an int.
+	 */
+	static bool parseInt(boost::string_view text, int &value);
+
+	/**
+	 * @brief parseDouble Parses a floating point number with a decimal point, or inf, infinity or nan.
+	 * @return false if text is not a number or is too large for a double.
+	 */
+	static bool parseDouble(boost::string_view text, double &value);
+
+	/**
+	 * @brief deEuropeanise Rewrites a number written with a decimal comma to one with a decimal point.
+	 * If text contains a comma all dots are taken as thousands separators and dropped and the first comma becomes the decimal point.
+	 * @param buffer - Receives the result if it fits in bufferSize characters.
+	 * @param longer - Receives the result otherwise.
+	 * @return The rewritten text, or text itself if it has no comma.
+	 */
+	static boost::string_view deEuropeanise(boost::string_view text, char *buffer, size_t bufferSize, std::string &longer);
+
+private:
+	NumericParser();
+
+	static bool _parseSpecialDouble(boost::string_view text, bool negative, double &value);
+	static bool _parseDoubleSlow(boost::string_view text, double &value);
+};
+
+#endif // NUMERICPARSER_H
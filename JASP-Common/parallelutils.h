@@ -0,0 +1,86 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PARALLELUTILS_H
+#define PARALLELUTILS_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+class parallelUtils
+{
+public:
+	/// The number of worker threads worth starting for a number of independent jobs.
+	inline static size_t threadCount(size_t jobs)
+	{
+		size_t cores = std::thread::hardware_concurrency();
+
+		if (cores == 0)
+			cores = 1;
+
+		return std::max(size_t(1), std::min(cores, jobs));
+	}
+
+	/// Runs job(i) for every i in [0, jobs) spread over threadCount(jobs) threads, jobs are handed out in order.
+	/// Returns when all jobs are done, if any of them threw the first exception is rethrown on the calling thread.
+	template<typename Job> static void forEach(size_t jobs, Job job)
+	{
+		size_t threads = threadCount(jobs);
+
+		if (threads <= 1)
+		{
+			for (size_t i = 0; i < jobs; i++)
+				job(i);
+			return;
+		}
+
+		std::atomic<size_t>				next(0);
+		std::vector<std::exception_ptr>	errors(threads);
+		std::vector<std::thread>		workers;
+		workers.reserve(threads);
+
+		for (size_t t = 0; t < threads; t++)
+			workers.push_back(std::thread([&, t]()
+			{
+				try
+				{
+					for (size_t i = next++; i < jobs; i = next++)
+						job(i);
+				}
+				catch (...)
+				{
+					errors[t] = std::current_exception();
+					next		= jobs;
+				}
+			}));
+
+		for (std::thread & worker : workers)
+			worker.join();
+
+		for (std::exception_ptr & error : errors)
+			if (error)
+				std::rethrow_exception(error);
+	}
+
+private:
+	parallelUtils();
+};
+
+#endif // PARALLELUTILS_H
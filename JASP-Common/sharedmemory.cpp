@@ -28,6 +28,7 @@ using namespace boost;
 
 interprocess::managed_shared_memory *SharedMemory::_memory = NULL;
 string SharedMemory::_memoryName;
+unsigned int SharedMemory::_dataSetGenerations = 0;
 
 DataSet *SharedMemory::createDataSet()
 {
@@ -45,6 +46,8 @@ DataSet *SharedMemory::createDataSet()
 	}
 
 	DataSet * data = _memory->construct<DataSet>(interprocess::unique_instance)(_memory);
+	data->setGeneration(++_dataSetGenerations);
+
 	return data;
 }
 
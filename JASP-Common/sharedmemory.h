@@ -45,7 +45,8 @@ public:
 	static void		unloadDataSet();
 private:
 
-	static std::string _memoryName;
+	static std::string	_memoryName;
+	static unsigned int	_dataSetGenerations;
 	static boost::interprocess::managed_shared_memory *_memory;
 
 };
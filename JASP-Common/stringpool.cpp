@@ -0,0 +1,127 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "stringpool.h"
+
+#include <algorithm>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+const size_t StringPool::blockSize = 64 * 1024;
+
+StringPool::StringPool(SegmentManager * manager) : _manager(manager), _blocks(manager), _index(manager)
+{
+}
+
+StringPool::~StringPool()
+{
+	for(CharPtr & block : _blocks)
+		_manager->deallocate(block.get());
+}
+
+const char * StringPool::intern(const std::string & text)
+{
+	boost::interprocess::scoped_lock<boost::interprocess::interprocess_mutex> lock(_mutex);
+
+	if(2 * (_count + 1) > _index.size())
+		_growIndex();
+
+	size_t		hash	= _hash(text.data(), text.size()),
+				slot;
+	const char	* found	= _find(text, hash, slot);
+
+	if(found != NULL)
+		return found;
+
+	char * stored	= _store(text);
+	_index[slot]	= stored;
+	_count++;
+
+	return stored;
+}
+
+const char * StringPool::_find(const std::string & text, size_t hash, size_t & slot) const
+{
+	size_t mask = _index.size() - 1;
+
+	for(slot = hash & mask; _index[slot].get() != NULL; slot = (slot + 1) & mask)
+	{
+		const char * stored = _index[slot].get();
+
+		if(length(stored) == text.size() && std::memcmp(stored, text.data(), text.size()) == 0)
+			return stored;
+	}
+
+	return NULL;
+}
+
+char * StringPool::_store(const std::string & text)
+{
+	size_t needed = (sizeof(uint32_t) + text.size() + 1 + 3) & ~size_t(3); //Keeps the length prefixes aligned
+
+	if(_blocks.size() == 0 || _blockUsed + needed > _blockEnd)
+	{
+		size_t size	= std::max(blockSize, needed);
+		char * block = static_cast<char*>(_manager->allocate(size));
+
+		try							{ _blocks.push_back(block);				}
+		catch(std::bad_alloc &)		{ _manager->deallocate(block); throw;	}
+
+		_blockUsed	= 0;
+		_blockEnd	= size;
+	}
+
+	char		* record	= _blocks.back().get() + _blockUsed;
+	uint32_t	length		= uint32_t(text.size());
+
+	std::memcpy(record, &length, sizeof(uint32_t));
+	std::memcpy(record + sizeof(uint32_t), text.data(), text.size());
+	record[sizeof(uint32_t) + text.size()] = '\0';
+
+	_blockUsed += needed;
+
+	return record + sizeof(uint32_t);
+}
+
+void StringPool::_growIndex()
+{
+	size_t slots = std::max(size_t(64), _index.size() * 2);
+
+	CharPtrVector grown(slots, CharPtr(), _index.get_stored_allocator());
+
+	for(const CharPtr & stored : _index)
+		if(stored.get() != NULL)
+		{
+			size_t slot = _hash(stored.get(), length(stored.get())) & (slots - 1);
+
+			while(grown[slot].get() != NULL)
+				slot = (slot + 1) & (slots - 1);
+
+			grown[slot] = stored;
+		}
+
+	_index.swap(grown);
+}
+
+size_t StringPool::_hash(const char * text, size_t length)
+{
+	uint64_t hash = 14695981039346656037ull; //FNV-1a, the same in every process unlike std::hash
+
+	for(size_t i=0; i<length; i++)
+		hash = (hash ^ (unsigned char)text[i]) * 1099511628211ull;
+
+	return size_t(hash ^ (hash >> 32));
+}
@@ -0,0 +1,76 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/container/vector.hpp>
+#include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/offset_ptr.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+
+/**
+ * @brief The StringPool class - A deduplicated arena of strings in shared memory, used for the texts of the Labels.
+ *
+ * Every string is stored once, as its length followed by its characters, in blocks allocated from the segment.
+ * Nothing is freed until the pool itself is destroyed, which happens together with the DataSet.
+ * The Desktop and the Engines share it, intern() is guarded by an interprocess mutex.
+ */
+class StringPool
+{
+public:
+	typedef boost::interprocess::managed_shared_memory::segment_manager SegmentManager;
+
+	StringPool(SegmentManager * manager);
+	~StringPool();
+
+	/// Returns the pooled copy of text, equal texts give the same pointer. It can be kept in shared memory as an offset_ptr.
+	const char *	intern(const std::string & text);
+
+	static size_t	length(const char * pooled)	{ uint32_t length; std::memcpy(&length, pooled - sizeof(uint32_t), sizeof(uint32_t)); return length; }
+	size_t			count()				const	{ return _count; }
+
+	/// Finds the pool of this segment, making it if there is none yet. Goes through the segment manager because that is valid in every process.
+	static StringPool * of(SegmentManager * manager) { return manager->find_or_construct<StringPool>(boost::interprocess::unique_instance)(manager); }
+
+	static const size_t blockSize;
+
+private:
+	typedef boost::interprocess::offset_ptr<char>										CharPtr;
+	typedef boost::interprocess::allocator<CharPtr, SegmentManager>						CharPtrAllocator;
+	typedef boost::container::vector<CharPtr, CharPtrAllocator>							CharPtrVector;
+
+	const char *	_find(const std::string & text, size_t hash, size_t & slot) const;
+	char		*	_store(const std::string & text);
+	void			_growIndex();
+
+	static size_t	_hash(const char * text, size_t length);
+
+	boost::interprocess::offset_ptr<SegmentManager>	_manager;
+	CharPtrVector									_blocks,
+													_index;		///< Open addressing hash table of the stored strings, its size is a power of two
+	size_t											_blockUsed	= 0,
+													_blockEnd	= 0,
+													_count		= 0;
+	boost::interprocess::interprocess_mutex			_mutex;
+};
+
+#endif // STRINGPOOL_H
@@ -16,6 +16,10 @@
 //
 
 #include "utils.h"
+#include "numericparser.h"
+
+#include <climits>
+#include <cmath>
 
 #ifdef __WIN32__
 #include "windows.h"
@@ -277,46 +281,21 @@ void Utils::setEmptyValues(const vector<string> &emptyvalues)
 
 bool Utils::getIntValue(const string &value, int &intValue)
 {
-	bool success = true;
-	try
-	{
-		intValue = boost::lexical_cast<int>(value);
-	}
-	catch (...)
-	{
-		success = false;
-	}
-
-	return success;
+	return NumericParser::parseInt(value, intValue);
 }
 
 bool Utils::getIntValue(const double &value, int &intValue)
 {
-	bool success = true;
-	try
-	{
-		intValue = boost::lexical_cast<int>(value);
-	}
-	catch (...)
-	{
-		success = false;
-	}
+	// only doubles holding a whole number that fits in an int
+	if (std::isnan(value) || value < INT_MIN || value > INT_MAX || value != std::floor(value))
+		return false;
 
-	return success;
+	intValue = int(value);
+	return true;
 }
 
 bool Utils::getDoubleValue(const string &value, double &doubleValue)
 {
-	bool success = true;
-	try
-	{
-		doubleValue = boost::lexical_cast<double>(value);
-	}
-	catch (...)
-	{
-		success = false;
-	}
-
-	return success;
+	return NumericParser::parseDouble(value, doubleValue);
 }
 
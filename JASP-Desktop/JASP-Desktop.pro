@@ -247,6 +247,7 @@ HEADERS += \
     data/importers/codepageconvert.h \
     data/importers/convertedstringcontainer.h \
     data/importers/csv.h \
+    data/importers/columnbuilder.h \
     data/importers/csvimportcolumn.h \
     data/importers/csvimporter.h \
     data/importers/importcolumn.h \
@@ -269,7 +270,9 @@ HEADERS += \
     analysis/options/variableinfo.h \
     engine/enginerepresentation.h \
     engine/enginesync.h \
+    engine/ipcchannelwatcher.h \
     engine/rscriptstore.h \
+    engine/scheduledefines.h \
     gui/aboutdialog.h \
     gui/aboutdialogjsinterface.h \
     qquick/datasetview.h \
@@ -435,6 +438,7 @@ SOURCES += \
     data/importers/codepageconvert.cpp \
     data/importers/convertedstringcontainer.cpp \
     data/importers/csv.cpp \
+    data/importers/columnbuilder.cpp \
     data/importers/csvimportcolumn.cpp \
     data/importers/csvimporter.cpp \
     data/importers/importcolumn.cpp \
@@ -455,6 +459,8 @@ SOURCES += \
     data/fileevent.cpp \
     engine/enginerepresentation.cpp \
     engine/enginesync.cpp \
+    engine/ipcchannelwatcher.cpp \
+    engine/scheduledefines.cpp \
     gui/aboutdialog.cpp \
     gui/aboutdialogjsinterface.cpp \
     qquick/datasetview.cpp \
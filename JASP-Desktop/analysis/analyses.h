@@ -52,6 +52,7 @@ public:
 	Analysis*	create(Modules::AnalysisEntry * analysisEntry)		{ return create(analysisEntry, _nextId++);						}
 
 	Analysis*	get(size_t id) const								{ return _analysisMap.count(id) > 0 ? _analysisMap.at(id) : nullptr;	}
+	Analysis*	currentAnalysis() const								{ return _currentAnalysisIndex < 0 || size_t(_currentAnalysisIndex) >= _orderedIds.size() ? nullptr : get(_orderedIds[size_t(_currentAnalysisIndex)]); }
 	void		clear();
 
 	void		setAnalysesUserData(Json::Value userData);
@@ -82,11 +82,136 @@ void Analysis::scheduleRun()
 
 void Analysis::setResults(Json::Value results, int progress)
 {
-	_results = results;
-	_progress = progress;
+	_results		= results;
+	_resultsPatch	= Json::nullValue;
+	_progress		= progress;
 	resultsChanged(this);
 }
 
+///Follows the nested names in path from the results of jaspResults, where the objects are members, through the collections of the containers below it.
+static Json::Value * resultsNodeAt(Json::Value & results, const Json::Value & path, bool createMissing)
+{
+	Json::Value * node = &results;
+
+	for(Json::UInt i=0; i<path.size(); i++)
+	{
+		std::string name = path[i].asString();
+
+		if(i > 0)
+		{
+			if(!createMissing && !node->isMember("collection"))
+				return NULL;
+
+			node = &(*node)["collection"];
+		}
+
+		if(!createMissing && !node->isMember(name))
+			return NULL;
+
+		node = &(*node)[name];
+	}
+
+	return node;
+}
+
+void Analysis::applyResultsPatch(const Json::Value & patch, int progress)
+{
+	if(!_results.isObject())
+		_results = Json::objectValue;
+
+	const Json::Value & fields = patch["fields"];
+
+	for(const std::string & field : fields.getMemberNames())
+		_results[field] = fields[field];
+
+	for(const Json::Value & added : patch["added"])
+		*resultsNodeAt(_results, added["path"], true) = added["data"];
+
+	for(const Json::Value & changed : patch["changed"])
+	{
+		Json::Value & node = *resultsNodeAt(_results, changed["path"], true),
+					data = changed["data"];
+
+		if(!data.isMember("collection") && node.isMember("collection")) //Changed containers do not send their children again
+			data["collection"].swap(node["collection"]);
+
+		node.swap(data);
+	}
+
+	for(const Json::Value & removed : patch["removed"])
+	{
+		Json::Value path = removed;
+		std::string name = path[path.size() - 1].asString();
+		path.resize(path.size() - 1);
+
+		Json::Value * parent = resultsNodeAt(_results, path, false);
+
+		if(parent != NULL)
+		{
+			Json::Value & members = path.size() == 0 ? *parent : (*parent)["collection"];
+
+			if(members.isObject())
+				members.removeMember(name);
+		}
+	}
+
+	_resultsPatch	= patch;
+	_progress		= progress;
+	resultsChanged(this);
+}
+
+///Tables with more rows than fit on a page have a "rowCount" next to the rows they came with, they can be anywhere in the results.
+static void collectPagedTables(Json::Value & node, std::map<std::string, Json::Value*> & tables)
+{
+	if(!node.isObject())
+		return;
+
+	if(node.isMember("rowCount") && node["data"].isArray() && node["name"].isString())
+		tables[node["name"].asString()] = &node;
+
+	for(const std::string & member : node.getMemberNames())
+		if(member != "data")
+			collectPagedTables(node[member], tables);
+}
+
+void Analysis::insertTablePage(const std::string & tableName, int from, const Json::Value & rows)
+{
+	std::map<std::string, Json::Value*> tables;
+	collectPagedTables(_results, tables);
+
+	if(tables.count(tableName) == 0 || !rows.isArray())
+		return;
+
+	Json::Value & data = (*tables[tableName])["data"];
+
+	if(from < 0 || Json::UInt(from) > data.size())
+		return;
+
+	data.resize(Json::UInt(from));
+
+	for(const Json::Value & row : rows)
+		data.append(row);
+}
+
+std::map<std::string, std::pair<int, int>> Analysis::pagedTablesMissingRows()
+{
+	std::map<std::string, Json::Value*>			tables;
+	std::map<std::string, std::pair<int, int>>	missing;
+
+	collectPagedTables(_results, tables);
+
+	for(auto & nameTable : tables)
+	{
+		int loaded	= int((*nameTable.second)["data"].size()),
+			total	= (*nameTable.second)["rowCount"].asInt();
+
+		if(loaded < total)
+			missing[nameTable.first] = std::make_pair(loaded, total);
+	}
+
+	return missing;
+}
+
 void Analysis::setImageResults(Json::Value results)
 {
 	_imgResults = results;
@@ -120,6 +245,22 @@ Analysis::Status Analysis::parseStatus(string name)
 	else							return Analysis::Error;
 }
 
+string Analysis::statusToString(Analysis::Status status)
+{
+	switch (status)
+	{
+	case Analysis::Empty:		return "empty";
+	case Analysis::Inited:		return "waiting";
+	case Analysis::Running:		return "running";
+	case Analysis::Complete:	return "complete";
+	case Analysis::Aborted:		return "aborted";
+	case Analysis::SaveImg:		return "SaveImg";
+	case Analysis::EditImg:		return "EditImg";
+	case Analysis::Exception:	return "exception";
+	default:					return "error";
+	}
+}
+
 Json::Value Analysis::asJSON() const
 {
 	Json::Value analysisAsJson = Json::objectValue;
@@ -137,22 +278,7 @@ Json::Value Analysis::asJSON() const
 	analysisAsJson["version"]		= _version.asString();
 	analysisAsJson["results"]		= _results;
 
-	string status;
-
-	switch (_status)
-	{
-	case Analysis::Empty:		status = "empty";		break;
-	case Analysis::Inited:		status = "waiting";		break;
-	case Analysis::Running:		status = "running";		break;
-	case Analysis::Complete:	status = "complete";	break;
-	case Analysis::Aborted:		status = "aborted";		break;
-	case Analysis::SaveImg:		status = "SaveImg";		break;
-	case Analysis::EditImg:		status = "EditImg";		break;
-	case Analysis::Exception:	status = "exception";	break;
-	default:					status = "error";		break;
-	}
-
-	analysisAsJson["status"]	= status;
+	analysisAsJson["status"]	= statusToString(_status);
 
 	analysisAsJson["fromQML"]	= fromQML();
 	analysisAsJson["options"]	= fromQML() ? options()->asJSONWithType(true) : options()->asJSON(true);
@@ -191,7 +317,8 @@ int Analysis::callback(Json::Value results)
 	{
 		if (results != Json::nullValue)
 		{
-			_results = results;
+			_results		= results;
+			_resultsPatch	= Json::nullValue;
 			resultsChanged(this);
 		}
 		return 0;
@@ -61,6 +61,9 @@ public:
 	bool isDynamicModule() { return _moduleData == nullptr ? false : _moduleData->dynamicModule() != nullptr; }
 
 	void setResults(Json::Value results, int progress = -1);
+	void applyResultsPatch(const Json::Value & patch, int progress = -1);
+	void insertTablePage(const std::string & tableName, int from, const Json::Value & rows);
+	std::map<std::string, std::pair<int, int>> pagedTablesMissingRows(); ///< Per paged table how many rows are in the results and how many it has
 	void setImageResults(Json::Value results);
 	void setImageEdited(Json::Value results);
 	void setStatus(Status status);
@@ -74,6 +77,7 @@ public:
 	
 	//getters
 	const	Json::Value &results()				const	{ return _results;				}
+	const	Json::Value &resultsPatch()			const	{ return _resultsPatch;			}
 	const	Json::Value &userData()				const	{ return _userData;				}
 	const	Json::Value &requiresInit()			const	{ return _requiresInit;			}
 	const	Json::Value &dataKey()				const	{ return _dataKey;				}
@@ -91,6 +95,7 @@ public:
 			bool		usesJaspResults()		const	{ return _useJaspResults;		}
 			Status		status()				const	{ return _status;				}
 			int			revision()				const	{ return _revision;				}
+			int			progress()				const	{ return _progress;				}
 			bool		isVisible()				const	{ return _visible;				}
 			bool		isRefreshBlocked()		const	{ return _refreshBlocked;		}
 	const	Json::Value	&getSaveImgOptions()	const	{ return _saveImgOptions;		}
@@ -104,9 +109,11 @@ public:
 			Json::Value createAnalysisRequestJson(int ppi, std::string imageBackground);
 
 	static	Status		parseStatus(std::string name);
+	static	std::string	statusToString(Status status);
 
 	bool isEmpty()		const { return status() == Empty; }
 	bool isAborted()	const { return status() == Aborted; }
+	bool isAborting()	const { return status() == Aborting; }
 	bool isSaveImg()	const { return status() == SaveImg; }
 	bool isEditImg()	const { return status() == EditImg; }
 	bool isInited()		const { return status() == Inited; }
@@ -136,6 +143,7 @@ protected:
 
 	Options*				_options;
 	Json::Value				_results		= Json::nullValue,
+							_resultsPatch	= Json::nullValue, ///< The patch behind the last change of _results, null if they were replaced completely
 							_imgResults		= Json::nullValue,
 							_userData		= Json::nullValue,
 							_saveImgOptions	= Json::nullValue;
@@ -41,6 +41,13 @@ void DataSetPackage::reset()
 
 	setModified(false);
 	resetEmptyValues();
+	resetColumnFingerprints();
+}
+
+std::string DataSetPackage::columnFingerprint(std::string columnName) const
+{
+	auto fingerprint = _columnFingerprints.find(columnName);
+	return fingerprint == _columnFingerprints.end() ? "" : fingerprint->second;
 }
 
 void DataSetPackage::setModified(bool value)
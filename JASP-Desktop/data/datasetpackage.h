@@ -32,6 +32,7 @@
 class DataSetPackage
 {
 	typedef std::map<std::string, std::map<int, std::string>> emptyValsType;
+	typedef std::map<std::string, std::string> fingerprintsType;
 
 public:
 			DataSetPackage();
@@ -39,6 +40,9 @@ public:
 			void			reset();
 			void			storeInEmptyValues(std::string columnName, std::map<int, std::string> emptyValues)	{ _emptyValuesMap[columnName] = emptyValues;	}
 			void			resetEmptyValues()																	{ _emptyValuesMap.clear();											}
+			void			storeColumnFingerprint(std::string columnName, std::string fingerprint)			{ _columnFingerprints[columnName] = fingerprint;	}
+			void			resetColumnFingerprints()															{ _columnFingerprints.clear();										}
+			std::string		columnFingerprint(std::string columnName)	const;	///< Of the column in the data file at the last import or sync, "" when unknown
 
 			std::string		id()							const	{ return _id;							}
 			bool			isReady()						const	{ return _analysesHTMLReady;			}
@@ -55,6 +59,7 @@ public:
 	const	std::string&	warningMessage()				const	{ return _warningMessage;				}
 	const	Version&		archiveVersion()				const	{ return _archiveVersion;				}
 	const	emptyValsType&	emptyValuesMap()				const	{ return _emptyValuesMap;				}
+	const	fingerprintsType& columnFingerprints()			const	{ return _columnFingerprints;			}
 			bool			dataFileReadOnly()				const	{ return _dataFileReadOnly;				}
 			uint			dataFileTimestamp()				const	{ return _dataFileTimestamp;			}
 	const	Version&		dataArchiveVersion()			const	{ return _dataArchiveVersion;			}
@@ -105,6 +110,7 @@ public:
 private:
 	DataSet				*_dataSet = NULL;
 	emptyValsType		_emptyValuesMap;
+	fingerprintsType	_columnFingerprints;
 
 	std::string			_analysesHTML,
 						_id,
@@ -100,29 +100,54 @@ QVariant DataSetTableModel::data(const QModelIndex &index, int role) const
 		else if(role == (int)specialRoles::active)
 			return getRowFilter(index.row());
 		else if(role == (int)specialRoles::lines)
-		{
-			bool	iAmActive = getRowFilter(index.row()),
-					//aboveMeIsActive = index.row() > 0				&& data(this->index(index.row() - 1, index.column()), (int)specialRoles::active).toBool();
-					belowMeIsActive = index.row() < rowCount() - 1	&& data(this->index(index.row() + 1, index.column()), (int)specialRoles::active).toBool();
-					//iAmLastRow = index.row() == rowCount() - 1;
-
-			bool	up		= iAmActive,
-					left	= iAmActive,
-					down	= iAmActive && !belowMeIsActive,
-					right	= iAmActive && index.column() == columnCount() - 1; //always draw left line and right line only if last col
-
-			return	(left ?		1 : 0) +
-					(right ?	2 : 0) +
-					(up ?		4 : 0) +
-					(down ?		8 : 0);
-		}
-
-
+			return cellLines(getRowFilter(index.row()), index.row() < rowCount() - 1 && getRowFilter(index.row() + 1), index.column() == columnCount() - 1);
 	}
 
     return QVariant();
 }
 
+int DataSetTableModel::cellLines(bool active, bool belowActive, bool lastColumn)
+{
+	bool	up		= active,
+			left	= active,
+			down	= active && !belowActive,
+			right	= active && lastColumn; //always draw left line and right line only if last col
+
+	return	(left ?		1 : 0) +
+			(right ?	2 : 0) +
+			(up ?		4 : 0) +
+			(down ?		8 : 0);
+}
+
+///Gives the same as data() would for the display, active and lines roles of the rows [rowStart, rowEnd) but without going through a QVariant per cell and role
+void DataSetTableModel::cellBlock(int column, int rowStart, int rowEnd, DataSetCellBlock & block) const
+{
+	block.texts.clear();
+	block.active.clear();
+	block.lines.clear();
+
+	if (_dataSet == NULL || _dataSet->synchingData() || column < 0 || column >= columnCount())
+		return;
+
+	int					rows	= rowCount();
+	Column			&	col		= _dataSet->column(column);
+	const FilterBits &	filter	= _dataSet->filterVector();
+
+	rowStart	= std::max(0, rowStart);
+	rowEnd		= std::min(rows, rowEnd);
+
+	block.texts.reserve(std::max(0, rowEnd - rowStart));
+
+	for(int row=rowStart; row<rowEnd; row++)
+	{
+		bool active = filter[row];
+
+		block.texts.push_back(tq(col[row]));
+		block.active.push_back(active);
+		block.lines.push_back(cellLines(active, row < rows - 1 && filter[row + 1], column == columnCount() - 1));
+	}
+}
+
 QVariant DataSetTableModel::columnTitle(int column) const
 {
 	if(column >= 0 && size_t(column) < _dataSet->columnCount())
@@ -27,6 +27,16 @@
 #include "datasetpackage.h"
 
 
+///The texts, filter status and lines of a range of rows in one column, so a view can get them in one go
+struct DataSetCellBlock
+{
+	std::vector<QString>	texts;
+	std::vector<bool>		active;
+	std::vector<int>		lines;
+
+	size_t size() const { return texts.size(); }
+};
+
 class DataSetTableModel : public QAbstractTableModel
 {
     Q_OBJECT
@@ -61,6 +71,7 @@ public:
 				size_t				addColumnToDataSet();
 				int					columnsFilteredCount();
 				int					getMaximumColumnWidthInCharacters(size_t columnIndex) const;
+				void				cellBlock(int column, int rowStart, int rowEnd, DataSetCellBlock & block) const;
 
 				bool				setColumnType(int columnIndex, Column::ColumnType newColumnType);
 				Column::ColumnType	getColumnType(int columnIndex);
@@ -83,6 +94,8 @@ public slots:
 				void				setColumnsUsedInEasyFilter(std::set<std::string> usedColumns);
     
 private:
+	static		int					cellLines(bool active, bool belowActive, bool lastColumn);
+
 	DataSet						*_dataSet;
 	DataSetPackage				*_package;
 	std::map<std::string, bool> columnNameUsedInEasyFilter;
@@ -23,8 +23,16 @@
 #include <sys/stat.h>
 
 #include "dataset.h"
+#include "parallelutils.h"
 
 #include <boost/nowide/fstream.hpp>
+#include <unordered_map>
+#include <clocale>
+#include <climits>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
 
 using namespace std;
 
@@ -34,6 +42,110 @@ DataExporter::DataExporter(bool includeComputeColumns) : _includeComputeColumns(
     _allowedFileTypes.push_back(Utils::txt);
 }
 
+namespace
+{
+
+///How the cells of one column are written. Everything that needs the labels is worked out up front,
+///so that the rows can be formatted on several threads straight from the shared memory.
+class CellFormatter
+{
+public:
+	CellFormatter(Column &column, DataExporter &exporter)
+		: _scale(column.columnType() == Column::ColumnTypeScale), _rows(column.rowCount())
+	{
+		if (_scale)
+		{
+			_doubles		= column.AsDoubles.data();
+			_emptyDoubles	= Utils::getDoubleEmptyValues();
+			return;
+		}
+
+		_ints = column.AsInts.data();
+
+		for (const Label &label : column.labels())
+		{
+			string value = column.labels().getValueFromKey(label.value());
+
+			if (value == ".")						value = "";
+			else if (exporter.escapeValue(value))	value = '"' + value + '"';
+
+			_texts[label.value()] = value;
+		}
+	}
+
+	void append(size_t row, string &out) const
+	{
+		if (row >= _rows)
+			return;
+
+		if (_scale)
+		{
+			double v = _doubles[row];
+
+			if (std::isinf(v) || std::find(_emptyDoubles.begin(), _emptyDoubles.end(), v) == _emptyDoubles.end())
+				appendDouble(v, out);
+
+			return;
+		}
+
+		int key = _ints[row];
+
+		if (key == INT_MIN)
+			return;
+
+		auto text = _texts.find(key);
+		if (text == _texts.end())
+			throw runtime_error("Cannot find this entry");
+
+		out.append(text->second);
+	}
+
+	///Writes the same as Column::getOriginalValue, which streams the double with the default precision of 6, so %g.
+	static void appendDouble(double v, string &out)
+	{
+		if (v > DBL_MAX)			{ out.append("\xE2\x88\x9E");	return; }
+		if (v < -DBL_MAX)			{ out.append("-\xE2\x88\x9E");	return; }
+		if (std::isnan(v))			return;
+
+		char buffer[32];
+
+		if (v == std::floor(v) && std::fabs(v) < 1e6 && !(v == 0 && std::signbit(v))) //Whole numbers are the most common, and %g writes them just like this
+		{
+			char	*end	= buffer + sizeof(buffer),
+					*begin	= end;
+			long	whole	= std::labs(long(v));
+
+			do { *--begin = char('0' + whole % 10); whole /= 10; } while (whole > 0);
+
+			if (v < 0)
+				*--begin = '-';
+
+			out.append(begin, end);
+			return;
+		}
+
+		int length = snprintf(buffer, sizeof(buffer), "%g", v);
+
+		for (int i = 0; i < length; i++)
+			if (buffer[i] == decimalPoint())
+				buffer[i] = '.'; //The GUI may have set a locale that writes a comma there
+
+		out.append(buffer, length);
+	}
+
+private:
+	static char decimalPoint() { static const char point = *localeconv()->decimal_point; return point; }
+
+	bool						_scale;
+	size_t						_rows;
+	const double			*	_doubles	= nullptr;
+	const int				*	_ints		= nullptr;
+	vector<double>				_emptyDoubles;
+	unordered_map<int, string>	_texts;		///< Already escaped
+};
+
+}
+
 void DataExporter::saveDataSet(const std::string &path, DataSetPackage* package, boost::function<void (const std::string &, int)> progressCallback)
 {
 
@@ -41,7 +153,8 @@ void DataExporter::saveDataSet(const std::string &path, DataSetPackage* package,
 
 	DataSet *dataset = package->dataSet();
 
-	std::vector<Column*> cols;
+	std::vector<Column*>		cols;
+	std::vector<CellFormatter>	formatters;
 
 	int columnCount = dataset->columnCount();
 	for (int i = 0; i < columnCount; i++)
@@ -50,40 +163,64 @@ void DataExporter::saveDataSet(const std::string &path, DataSetPackage* package,
 		string name = column.name();
 
 		if(!package->isColumnComputed(name) || _includeComputeColumns)
+		{
 			cols.push_back(&column);
+			formatters.push_back(CellFormatter(column, *this));
+		}
 	}
 
 
+	string header;
+
 	for (size_t i = 0; i < cols.size(); i++)
 	{
 		Column *column		= cols[i];
 		std::string name	= column->name();
 
-		if (escapeValue(name))	outfile << '"' << name << '"';
-		else					outfile << name;
+		if (escapeValue(name))	header += '"' + name + '"';
+		else					header += name;
 
-		if (i < cols.size()-1)	outfile << ",";
-		else					outfile << "\n";
+		if (i < cols.size()-1)	header += ",";
+		else					header += "\n";
 
 	}
 
-	size_t rowCount = dataset->rowCount();
+	outfile.write(header.data(), header.size());
 
-	for (size_t r = 0; r < rowCount; r++)
-		for (size_t i = 0; i < cols.size(); i++)
+	// The rows are formatted in blocks on all cores, a batch of blocks is written in order before the next batch is started
+	size_t	rowCount	= dataset->rowCount(),
+			blocks		= (rowCount + _rowsPerBlock - 1) / _rowsPerBlock,
+			batch		= parallelUtils::threadCount(blocks) * 4;
+
+	std::vector<string> formatted(batch);
+
+	for (size_t firstBlock = 0; firstBlock < blocks && !cols.empty(); firstBlock += batch)
+	{
+		size_t blocksNow = std::min(batch, blocks - firstBlock);
+
+		parallelUtils::forEach(blocksNow, [&](size_t b)
 		{
-			Column *column = cols[i];
+			string	&out	= formatted[b];
+			size_t	begin	= (firstBlock + b) * _rowsPerBlock,
+					end		= std::min(rowCount, begin + _rowsPerBlock);
 
-			string value = column->getOriginalValue(r);
-			if (value != ".")
-			{
-				if (escapeValue(value))	outfile << '"' << value << '"';
-				else					outfile << value;
-			}
+			out.clear();
 
-			if (i < cols.size()-1)		outfile << ",";
-			else if (r != rowCount-1)	outfile << "\n";
-		}
+			for (size_t r = begin; r < end; r++)
+				for (size_t i = 0; i < formatters.size(); i++)
+				{
+					formatters[i].append(r, out);
+
+					if (i < formatters.size()-1)	out += ',';
+					else if (r != rowCount-1)		out += '\n';
+				}
+		});
+
+		for (size_t b = 0; b < blocksNow; b++)
+			outfile.write(formatted[b].data(), formatted[b].size());
+
+		progressCallback("Export Data Set", int(100 * (firstBlock + blocksNow) / blocks));
+	}
 
 	outfile.flush();
 	outfile.close();
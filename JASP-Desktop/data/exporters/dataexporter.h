@@ -29,6 +29,9 @@ public:
 	bool escapeValue(std::string &value);
 
 	bool _includeComputeColumns;
+
+private:
+	static const size_t _rowsPerBlock = 16384; ///< Rows formatted in one go by one thread
 };
 
 #endif // DATAEXPORTER_H
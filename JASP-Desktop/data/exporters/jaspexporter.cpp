@@ -33,7 +33,8 @@
 #include "appinfo.h"
 #include <QDebug>
 
-const Version JASPExporter::dataArchiveVersion = Version("1.0.2");
+const Version JASPExporter::dataArchiveVersion = Version("2.0.0");
+const size_t  JASPExporter::dataColumnAlignment = 4096;
 const Version JASPExporter::jaspArchiveVersion = Version("3.0.0");
 
 
@@ -116,6 +117,11 @@ void JASPExporter::saveDataArchive(archive *a, DataSetPackage *package, boost::f
 		dataSet["emptyValuesMap"][colName] = mapJson;
 	}
 
+	dataSet["columnFingerprints"]		= Json::objectValue;
+
+	for (auto it : package->columnFingerprints())
+		dataSet["columnFingerprints"][it.first] = it.second;
+
 
 	Json::Value columnsData = Json::arrayValue;
 
@@ -131,16 +137,12 @@ void JASPExporter::saveDataArchive(archive *a, DataSetPackage *package, boost::f
 		columnMetaData["name"]			= Json::Value(name);
 		columnMetaData["measureType"]	= Json::Value(getColumnTypeName(column.columnType()));
 
-		if (column.columnType()			!= Column::ColumnTypeScale)
-		{
-			columnMetaData["type"] = Json::Value("integer");
-			dataSize += sizeof(int) * dataset->rowCount();
-		}
-		else
-		{
-			columnMetaData["type"] = Json::Value("number");
-			dataSize += sizeof(double) * dataset->rowCount();
-		}
+		columnMetaData["type"]			= Json::Value(column.columnType() != Column::ColumnTypeScale ? "integer" : "number");
+
+		//Every column starts page aligned in data.bin so that it can be mapped in straight from the file when loading
+		dataSize						= alignedDataOffset(dataSize);
+		columnMetaData["dataOffset"]	= Json::Value(double(dataSize)); //Json::Value has no 64 bits ints, but a double is exact up to 2^53
+		dataSize					   += column.valueSize() * column.rowCount();
 
 
 		if (column.columnType() != Column::ColumnTypeScale)
@@ -222,36 +224,36 @@ void JASPExporter::saveDataArchive(archive *a, DataSetPackage *package, boost::f
 
 
 	//Create new entry for archive NOTE: must be done before data is added
+	//data.bin is stored uncompressed so the importer can map it directly from the file
+	archive_write_zip_set_compression_store(a);
+
 	entry = archive_entry_new();
 	std::string dd = std::string("data.bin");
 	archive_entry_set_pathname(entry, dd.c_str());
-	archive_entry_set_size(entry, int(dataSize));
+	archive_entry_set_size(entry, dataSize);
 	archive_entry_set_filetype(entry, AE_IFREG);
 	archive_entry_set_perm(entry, 0644); // Not sure what this does
 	archive_write_header(a, entry);
 
 	//Data data to archive
+	const std::vector<char>	padding(dataColumnAlignment, 0);
+	size_t					written = 0;
 
 	for (size_t i = 0; i < columnCount; i++)
 	{
 		Column &column = dataset->column(i);
 
-		if (column.columnType() != Column::ColumnTypeScale)
-		{
-			for (Column::Ints::iterator iter = column.AsInts.begin(); iter != column.AsInts.end(); iter++)
-			{
-				int value = *iter;
-				archive_write_data(a, reinterpret_cast<const char*>(&value), sizeof(int));
-			}
-		}
-		else
+		size_t paddingSize = alignedDataOffset(written) - written;
+		if (paddingSize > 0)
+			archive_write_data(a, padding.data(), paddingSize);
+		written += paddingSize + column.valueSize() * column.rowCount();
+
+		column.visitChunks([&](const char * data, size_t bytes, size_t, size_t)
 		{
-			for (Column::Doubles::iterator iter = column.AsDoubles.begin(); iter != column.AsDoubles.end(); iter++)
-			{
-				double value = *iter;
-				archive_write_data(a, reinterpret_cast<const char*>(&value), sizeof(double));
-			}
-		}
+			size_t ws = archive_write_data(a, data, bytes);
+			if (ws != bytes)
+				throw std::runtime_error("Can't save jasp archive writing ERROR");
+		}, 64 * 1024);
 
 		progress = 49 + 50 * int(i / columnCount);
 		if (progress != lastProgress)
@@ -262,6 +264,7 @@ void JASPExporter::saveDataArchive(archive *a, DataSetPackage *package, boost::f
 	}
 
 	archive_entry_free(entry);
+	archive_write_zip_set_compression_deflate(a);
 
 	//Create new entry for archive: HTML results
 	std::string html = package->analysesHTML();
@@ -378,6 +381,11 @@ void JASPExporter::createJARContents(archive *a)
 }
 
 
+size_t JASPExporter::alignedDataOffset(size_t offset)
+{
+	return (offset + dataColumnAlignment - 1) / dataColumnAlignment * dataColumnAlignment;
+}
+
 std::string JASPExporter::getColumnTypeName(Column::ColumnType columnType)
 {
 	switch(columnType)
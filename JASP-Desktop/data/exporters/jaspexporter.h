@@ -27,6 +27,7 @@ class JASPExporter: public Exporter
 public:
 	static const Version jaspArchiveVersion;
 	static const Version dataArchiveVersion;
+	static const size_t  dataColumnAlignment;
 
 	JASPExporter();
 	void saveDataSet(const std::string &path, DataSetPackage* package, boost::function<void (const std::string &, int)> progressCallback) OVERRIDE;
@@ -37,6 +38,7 @@ private:
 
 	static void createJARContents(archive *a);
 	static std::string getColumnTypeName(Column::ColumnType columnType);
+	static size_t alignedDataOffset(size_t offset);
 };
 
 #endif // JASPEXPORTER_H
@@ -1,6 +1,8 @@
 #include "filtermodel.h"
 #include "variablespage/labelfiltergenerator.h"
 #include "utilities/jsonutilities.h"
+#include "filterevaluator.h"
+#include "stringutils.h"
 
 void FilterModel::reset()
 {
@@ -109,6 +111,21 @@ void FilterModel::processFilterResult(std::vector<bool> filterResult, int reques
 }
 
 
+void FilterModel::processFilterResultInDataSet(int requestId)
+{
+	if((requestId > -1 && requestId < _lastSentRequestId) || _package == NULL || _package->dataSet() == NULL)
+		return;
+
+	if(!_package->dataSet()->applyPendingFilter(requestId)) //The dataset was resized or replaced in the meantime, a new filter result will follow
+		return;
+
+	_package->setDataFilter(_rFilter.toStdString());
+
+	emit filterUpdated();
+
+	updateStatusBar();
+}
+
 void FilterModel::processFilterErrorMsg(QString filterErrorMsg, int requestId)
 {
 	if(requestId == _lastSentRequestId || requestId == -1)
@@ -120,10 +137,29 @@ void FilterModel::checkForSendFilter(bool justCameFromGeneratedFilterUpdate)
 	if(!justCameFromGeneratedFilterUpdate || (_package != NULL && _package->refreshAnalysesAfterFilter()))
 	{
 		setFilterErrorMsg("");
-		emit sendFilter(_generatedFilter, _rFilter, ++_lastSentRequestId);
+		++_lastSentRequestId;
+
+		if(!applyFilterNatively())
+			emit sendFilter(_generatedFilter, _rFilter, _lastSentRequestId);
 	}
 }
 
+///Simple filters are evaluated right here on the shared columns, anything else goes to an engine and R
+bool FilterModel::applyFilterNatively()
+{
+	if(_package == NULL || _package->dataSet() == NULL)
+		return false;
+
+	std::vector<bool> filterResult;
+
+	if(!FilterEvaluator(_package->dataSet()).evaluate(_generatedFilter.toStdString(), stringUtils::stripRComments(_rFilter.toStdString()), filterResult))
+		return false;
+
+	processFilterResult(filterResult, _lastSentRequestId);
+
+	return true;
+}
+
 void FilterModel::updateStatusBar()
 {
 	if(_package == NULL || _package->dataSet() == NULL)
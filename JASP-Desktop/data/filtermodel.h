@@ -56,6 +56,7 @@ public slots:
 	void setConstructedJSON(QString newConstructedJSON);
 
 	void processFilterResult(std::vector<bool> filterResult, int requestId);
+	void processFilterResultInDataSet(int requestId);
 	void processFilterErrorMsg(QString filterErrorMsg, int requestId);
 	void rescanRFilterForColumns();
 
@@ -81,6 +82,8 @@ signals:
 	void defaultRFilterChanged(); //Will never be called
 
 private:
+	bool applyFilterNatively();
+
 	DataSetPackage	*_package;
 	QString			_generatedFilter,
 					_rFilter			= DEFAULT_FILTER,
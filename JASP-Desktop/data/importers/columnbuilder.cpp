@@ -0,0 +1,300 @@
+#include "columnbuilder.h"
+#include "utils.h"
+
+#include <cmath>
+#include <climits>
+#include <sstream>
+#include <boost/functional/hash.hpp>
+
+using namespace std;
+
+static const size_t maxNominalLevels = 24;
+
+ColumnBuilder::ColumnBuilder()
+{
+	_inferred.type = Column::ColumnTypeNominal;
+}
+
+void ColumnBuilder::add(boost::string_view value)
+{
+	_fingerprinter.add(value);
+
+	switch (_inferred.type)
+	{
+	case Column::ColumnTypeNominal:
+		if (_addInt(value))
+		{
+			if (_inferred.uniqueValues.size() > maxNominalLevels && ! _promoteToScale())
+				_promoteToText();
+			break;
+		}
+
+		if ( ! _promoteToScale())
+		{
+			_promoteToText();
+			_inferred.ints.push_back(_addText(value));
+			break;
+		}
+		// fall through
+
+	case Column::ColumnTypeScale:
+		if (_addDouble(value, _rowCount, _inferred.doubles, _inferred.emptyValuesMap))
+		{
+			_scaleTexts.append(value.begin(), value.end());
+			_scaleTextEnds.push_back(_scaleTexts.size());
+			break;
+		}
+
+		_promoteToText();
+		// fall through
+
+	default:
+		_inferred.ints.push_back(_addText(value));
+		break;
+	}
+
+	_rowCount++;
+}
+
+void ColumnBuilder::finish()
+{
+	// the texts kept for a promotion are not needed anymore
+	string().swap(_scaleTexts);
+	vector<size_t>().swap(_scaleTextEnds);
+	vector<int>().swap(_textIndex);
+
+	if (_inferred.type == Column::ColumnTypeNominalText)
+		_intTexts.clear();
+}
+
+bool ColumnBuilder::_addInt(boost::string_view value)
+{
+	int intValue = INT_MIN;
+
+	if ( ! ImportColumn::convertValueToInt(value, intValue))
+		return false;
+
+	if (intValue != INT_MIN)
+	{
+		_inferred.uniqueValues.insert(intValue);
+
+		bool canonical = value[0] != '+' && (value[value[0] == '-'] != '0' || value == "0");
+		if ( ! canonical)
+			_intTexts.insert(make_pair(int(_rowCount), string(value.begin(), value.end())));
+	}
+	else if ( ! value.empty())
+	{
+		_inferred.emptyValuesMap.insert(make_pair(int(_rowCount), string(value.begin(), value.end())));
+
+		// an empty value with a comma in it or an integer that happens to be INT_MIN might read differently as a double
+		_intsAreDoubles = _intsAreDoubles && value.find(',') == boost::string_view::npos && ImportColumn::isEmptyValue(value);
+	}
+
+	_inferred.ints.push_back(intValue);
+
+	return true;
+}
+
+bool ColumnBuilder::_addDouble(boost::string_view value, size_t row, vector<double> &doubles, map<int, string> &emptyValuesMap)
+{
+	double doubleValue = NAN;
+
+	if ( ! ImportColumn::convertValueToDouble(value, doubleValue))
+		return false;
+
+	doubles.push_back(doubleValue);
+
+	if (std::isnan(doubleValue) && value != Utils::emptyValue)
+		emptyValuesMap.insert(make_pair(int(row), string(value.begin(), value.end())));
+
+	return true;
+}
+
+bool ColumnBuilder::_promoteToScale()
+{
+	vector<double>		doubles;
+	map<int, string>	emptyValuesMap;
+
+	doubles.reserve(_inferred.ints.capacity());
+
+	if (_intsAreDoubles)
+	{
+		// the integers read the same as doubles, so they do not have to be parsed again
+		for (int intValue : _inferred.ints)
+			doubles.push_back(intValue == INT_MIN ? NAN : double(intValue));
+
+		emptyValuesMap.swap(_inferred.emptyValuesMap);
+		_intRows = _inferred.ints.size();
+	}
+	else
+	{
+		for (size_t row = 0; row < _inferred.ints.size(); row++)
+		{
+			string text = _intTextAt(row, _inferred.ints[row]);
+
+			if ( ! _addDouble(text, row, doubles, emptyValuesMap))
+				return false;
+
+			_scaleTexts.append(text);
+			_scaleTextEnds.push_back(_scaleTexts.size());
+		}
+
+		_intRows = 0;
+	}
+
+	_inferred.doubles.swap(doubles);
+	_inferred.emptyValuesMap.swap(emptyValuesMap);
+	vector<int>().swap(_inferred.ints);
+	_inferred.uniqueValues.clear();
+	_inferred.type = Column::ColumnTypeScale;
+
+	return true;
+}
+
+void ColumnBuilder::_promoteToText()
+{
+	size_t		rows = _inferred.type == Column::ColumnTypeNominal ? _inferred.ints.size() : _inferred.doubles.size();
+	vector<int>	indices;
+	indices.reserve(max(_inferred.ints.capacity(), _inferred.doubles.capacity()));
+
+	for (size_t row = 0; row < rows; row++)
+		indices.push_back(_addText(textAt(row)));
+
+	_inferred.ints.swap(indices);
+	vector<double>().swap(_inferred.doubles);
+	_inferred.uniqueValues.clear();
+	_inferred.emptyValuesMap.clear(); // Column::setColumnAsNominalText works these out itself
+	_intTexts.clear();
+	string().swap(_scaleTexts);
+	vector<size_t>().swap(_scaleTextEnds);
+	_inferred.type = Column::ColumnTypeNominalText;
+}
+
+int ColumnBuilder::_addText(boost::string_view value)
+{
+	if (_textIndex.size() < 2 * (_inferred.dictionary.size() + 1))
+		_growTextIndex();
+
+	size_t mask = _textIndex.size() - 1;
+
+	for (size_t slot = boost::hash_range(value.begin(), value.end()) & mask; ; slot = (slot + 1) & mask)
+	{
+		int index = _textIndex[slot];
+
+		if (index == -1)
+		{
+			index				= int(_inferred.dictionary.size());
+			_textIndex[slot]	= index;
+			_inferred.dictionary.push_back(string(value.begin(), value.end()));
+
+			return index;
+		}
+
+		if (value == _inferred.dictionary[index])
+			return index;
+	}
+}
+
+void ColumnBuilder::_growTextIndex()
+{
+	size_t slots = max(size_t(64), _textIndex.size() * 2);
+
+	_textIndex.assign(slots, -1);
+
+	for (size_t index = 0; index < _inferred.dictionary.size(); index++)
+	{
+		const string	&text	= _inferred.dictionary[index];
+		size_t			slot	= boost::hash_range(text.begin(), text.end()) & (slots - 1);
+
+		while (_textIndex[slot] != -1)
+			slot = (slot + 1) & (slots - 1);
+
+		_textIndex[slot] = int(index);
+	}
+}
+
+string ColumnBuilder::_intTextAt(size_t row, int intValue) const
+{
+	auto text = _intTexts.find(int(row));
+	if (text != _intTexts.end())
+		return text->second;
+
+	if (intValue == INT_MIN)
+	{
+		auto emptyValue = _inferred.emptyValuesMap.find(int(row));
+		return emptyValue != _inferred.emptyValuesMap.end() ? emptyValue->second : Utils::emptyValue;
+	}
+
+	stringstream ss;
+	ss << intValue;
+
+	return ss.str();
+}
+
+string ColumnBuilder::_scaleTextAt(size_t row) const
+{
+	if (row >= _intRows && row - _intRows < _scaleTextEnds.size())
+	{
+		size_t textRow	= row - _intRows,
+			   begin	= textRow == 0 ? 0 : _scaleTextEnds[textRow - 1];
+
+		return _scaleTexts.substr(begin, _scaleTextEnds[textRow] - begin);
+	}
+
+	double doubleValue = _inferred.doubles[row];
+
+	if (std::isnan(doubleValue))
+	{
+		auto emptyValue = _inferred.emptyValuesMap.find(int(row));
+		return emptyValue != _inferred.emptyValuesMap.end() ? emptyValue->second : Utils::emptyValue;
+	}
+
+	if (row < _intRows)
+		return _intTextAt(row, int(doubleValue));
+
+	// after finish() the text itself is gone, this is how Column shows a scale value as text
+	stringstream ss;
+	ss << doubleValue;
+
+	return ss.str();
+}
+
+string ColumnBuilder::textAt(size_t row) const
+{
+	switch (_inferred.type)
+	{
+	case Column::ColumnTypeNominal:	return _intTextAt(row, _inferred.ints[row]);
+	case Column::ColumnTypeScale:	return _scaleTextAt(row);
+	default:						return _inferred.dictionary[_inferred.ints[row]];
+	}
+}
+
+bool ColumnBuilder::isValueEqual(Column &col, size_t row) const
+{
+	if (row >= _rowCount)
+		return false;
+
+	if (_inferred.type != Column::ColumnTypeScale)
+		return ImportColumn::isStringValueEqual(textAt(row), col, row);
+
+	double doubleValue = _inferred.doubles[row];
+
+	switch (col.columnType())
+	{
+	case Column::ColumnTypeScale:
+		return col.isValueEqual(row, doubleValue);
+
+	case Column::ColumnTypeNominal:
+	case Column::ColumnTypeOrdinal:
+	{
+		int intValue = INT_MIN;
+		if ( ! std::isnan(doubleValue) && ! Utils::getIntValue(doubleValue, intValue))
+			return false;
+
+		return col.isValueEqual(row, intValue);
+	}
+
+	default:
+		return col.isValueEqual(row, _scaleTextAt(row));
+	}
+}
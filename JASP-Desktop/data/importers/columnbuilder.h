@@ -0,0 +1,57 @@
+#ifndef COLUMNBUILDER_H
+#define COLUMNBUILDER_H
+
+#include "importcolumn.h"
+
+/**
+ * @brief The ColumnBuilder class - Collects the values of an imported column in their final type while they are read.
+ *
+ * A column starts out nominal and is promoted to scale once a value is no integer or there are more than 24 levels,
+ * and to nominal-text once a value is no number. Texts are stored once in a dictionary and every row refers to one.
+ * It decides the same types as filling a column from all its strings at once did, without keeping those strings around.
+ */
+class ColumnBuilder
+{
+public:
+	ColumnBuilder();
+
+	void	add(boost::string_view value);
+	void	finish();
+
+	size_t									size()		const	{ return _rowCount; }
+	const ImportColumn::InferredValues &	values()	const	{ return _inferred; }
+
+	std::string	textAt(size_t row) const;
+	bool		isValueEqual(Column &col, size_t row) const;
+	std::string	fingerprint() const { return _fingerprinter.result(); }
+
+private:
+	bool		_addInt(boost::string_view value);
+	bool		_addDouble(boost::string_view value, size_t row, std::vector<double> &doubles, std::map<int, std::string> &emptyValuesMap);
+	int			_addText(boost::string_view value);
+
+	bool		_promoteToScale();
+	void		_promoteToText();
+
+	std::string	_intTextAt(size_t row, int intValue) const;
+	std::string	_scaleTextAt(size_t row) const;
+	void		_growTextIndex();
+
+	ImportColumn::InferredValues	_inferred;
+	ImportColumn::Fingerprinter		_fingerprinter;	///< Of the texts as they came in
+	size_t							_rowCount		= 0;
+	bool							_intsAreDoubles	= true;
+
+	// Texts of integers that do not read back the same from the integer, like "007" or "+5"
+	std::map<int, std::string>		_intTexts;
+
+	// While scale: the texts of the rows after the first _intRows, so the column can still become nominal-text
+	size_t							_intRows		= 0;
+	std::string						_scaleTexts;
+	std::vector<size_t>				_scaleTextEnds;
+
+	// While nominal-text: an open addressing hash table of indices into the dictionary
+	std::vector<int>				_textIndex;
+};
+
+#endif // COLUMNBUILDER_H
@@ -19,6 +19,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <cstring>
 #include <stdexcept>
@@ -85,8 +86,7 @@ bool CSV::readRaw()
 {	
 	int bytesToMove = _rawBufferEndPos - _rawBufferStartPos;
 
-	for (int i = bytesToMove - 1; i >= 0; i--)
-		_rawBuffer[i] = _rawBuffer[_rawBufferStartPos + i];
+	std::memmove(_rawBuffer, &_rawBuffer[_rawBufferStartPos], bytesToMove);
 
 	_rawBufferEndPos = bytesToMove;
 	_rawBufferStartPos = 0;
@@ -190,8 +190,7 @@ bool CSV::readUtf8()
 
 	int bytesToMove = _utf8BufferEndPos - _utf8BufferStartPos;
 
-	for (int i = bytesToMove - 1; i >= 0; i--)
-		_utf8Buffer[i] = _utf8Buffer[_utf8BufferStartPos + i];
+	std::memmove(_utf8Buffer, &_utf8Buffer[_utf8BufferStartPos], bytesToMove);
 
 	_utf8BufferEndPos = bytesToMove;
 	_utf8BufferStartPos = 0;
@@ -428,15 +427,151 @@ bool CSV::readLine(vector<string> &items)
 		i++;
 	}
 
-    for (size_t index = 0; index < items.size(); index++)
+	for (string &item : items)
+		stripQuotes(item);
+
+	return true;
+}
+
+void CSV::stripQuotes(string &item)
+{
+	if (item.size() >= 2 && item[0] == '"' && item[item.size()-1] == '"')
+		item = item.substr(1, item.size()-2);
+}
+
+bool CSV::readBlock(string &utf8)
+{
+	if (_eof)
+		return false;
+
+	bool more = readUtf8();
+	int keep = 0;
+
+	// a multi-byte character cut off at the end of the buffer is held back, so it is validated again once it is complete
+	if (more)
 	{
-        string item = items.at(index);
-		if (item.size() >= 2 && item[0] == '"' && item[item.size()-1] == '"')
-			item = item.substr(1, item.size()-2);
-        items[index] = item;
+		for (int i = _utf8BufferEndPos - 1; i >= _utf8BufferStartPos && i >= _utf8BufferEndPos - 3; i--)
+		{
+			unsigned char ch = _utf8Buffer[i];
+
+			if (ch < 0x80)
+				break;
+
+			if (ch >= 0xC0)
+			{
+				int length = ch < 0xE0 ? 2 : (ch < 0xF0 ? 3 : 4);
+				if (i + length > _utf8BufferEndPos)
+					keep = _utf8BufferEndPos - i;
+				break;
+			}
+		}
 	}
 
-	return true;
+	// illegal utf-8 becomes '.', just like readLine() does
+	for (int i = _utf8BufferStartPos; i < _utf8BufferEndPos - keep; i++)
+		if ((unsigned char)_utf8Buffer[i] >= 0xF8)
+			_utf8Buffer[i] = '.';
+
+	utf8.append(&_utf8Buffer[_utf8BufferStartPos], _utf8BufferEndPos - _utf8BufferStartPos - keep);
+	_utf8BufferStartPos = _utf8BufferEndPos - keep;
+
+	if ( ! more)
+		_eof = true;
+
+	return more;
+}
+
+vector<size_t> CSV::recordBoundaries(const string &utf8, size_t pieces, bool atEndOfFile)
+{
+	// Splits the text in about equally sized pieces of whole records: each piece starts right after a line break outside of quotes.
+	// Unless atEndOfFile is set, the last piece ends after the last complete record, the rest is left for the next call.
+	vector<size_t>	boundaries(1, 0);
+	size_t			pieceSize	= utf8.size() / std::max(pieces, size_t(1)) + 1;
+	size_t			lastBreak	= 0;
+	bool			inQuote		= false;
+
+	for (size_t i = 0; i < utf8.size(); i++)
+	{
+		char ch = utf8[i];
+
+		if (ch == '"')
+			inQuote = !inQuote;
+		else if ( ! inQuote && (ch == '\r' || ch == '\n'))
+		{
+			lastBreak = i + 1;
+
+			if (boundaries.size() < pieces && lastBreak - boundaries.back() >= pieceSize)
+				boundaries.push_back(lastBreak);
+		}
+	}
+
+	size_t end = atEndOfFile ? utf8.size() : lastBreak;
+
+	if (end > boundaries.back())
+		boundaries.push_back(end);
+
+	return boundaries;
+}
+
+boost::string_view CSV::trimmedField(const char *begin, const char *end)
+{
+	// trims like boost::algorithm::trim in the classic locale and strips the quotes like stripQuotes() does
+	static const char *whitespace = " \t\n\v\f\r";
+
+	while (begin < end && strchr(whitespace, *begin) != NULL)
+		begin++;
+	while (end > begin && strchr(whitespace, end[-1]) != NULL)
+		end--;
+
+	if (end - begin >= 2 && *begin == '"' && end[-1] == '"')
+	{
+		begin++;
+		end--;
+	}
+
+	return boost::string_view(begin, end - begin);
+}
+
+void CSV::parseRecords(const char *begin, const char *end, char delim, vector<vector<boost::string_view> > &columns)
+{
+	// Splits the records the same way readLine() does, short records are padded with empty values and surplus fields are dropped.
+	// The fields point into the text between begin and end, which comes from readBlock() so the illegal utf-8 is already replaced.
+	vector<boost::string_view>	items;
+	const char					*start		= begin;
+	bool						inQuote		= false;
+
+	for (const char *pos = begin; pos <= end; pos++)
+	{
+		bool atEnd	= pos == end;
+		char ch		= atEnd ? '\n' : *pos;
+
+		if (ch == '"')
+			inQuote = !inQuote;
+
+		if (inQuote && ! atEnd)
+			continue;
+
+		if (ch == delim)
+		{
+			items.push_back(trimmedField(start, pos));
+			start = pos + 1;
+		}
+		else if (ch == '\r' || ch == '\n')
+		{
+			if (items.size() > 0 || pos > start)
+				items.push_back(trimmedField(start, pos));
+
+			start = pos + 1;
+
+			if (items.size() > 0)
+			{
+				for (size_t col = 0; col < columns.size(); col++)
+					columns[col].push_back(col < items.size() ? items[col] : boost::string_view());
+
+				items.clear();
+			}
+		}
+	}
 }
 
 long CSV::pos()
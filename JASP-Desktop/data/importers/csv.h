@@ -18,12 +18,14 @@
 #ifndef CSV_H
 #define CSV_H
 
+#include <string>
 #include <vector>
 #include <map>
 
 #include <stdint.h>
 
 #include <boost/nowide/fstream.hpp>
+#include <boost/utility/string_view.hpp>
 
 class CSV
 {
@@ -32,6 +34,8 @@ public:
 
 	void open();
 	bool readLine(std::vector<std::string> &items);
+	bool readBlock(std::string &utf8);
+	char delimiter() const { return _delim; }
 	long pos();
 	long size();
 	void close();
@@ -40,6 +44,9 @@ public:
 
 	Status status();
 
+	static std::vector<size_t> recordBoundaries(const std::string &utf8, size_t pieces, bool atEndOfFile);
+	static void parseRecords(const char *begin, const char *end, char delim, std::vector<std::vector<boost::string_view> > &columns);
+
 private:
 
 	long _fileSize;
@@ -69,6 +76,9 @@ private:
 	char _rawBuffer[4096];
 	char _utf8Buffer[8192];
 
+	static void stripQuotes(std::string &item);
+	static boost::string_view trimmedField(const char *begin, const char *end);
+
 	static inline bool utf16to8(char *out, char *in, int outSize, int inSize, int &written, int &read, bool bigEndian = false);
 	static inline bool utf16to32(uint32_t &out, char *in, int inSize, int &bytesRead, bool bigEndian = false);
 	static inline bool utf32to8(char *out, uint32_t in, int outSize, int &bytesWritten);
@@ -12,25 +12,16 @@ CSVImportColumn::~CSVImportColumn()
 
 size_t CSVImportColumn::size() const
 {
-	return _data.size();
+	return _builder.size();
 }
 
-void CSVImportColumn::addValue(const string &value)
+void CSVImportColumn::addValues(const vector<boost::string_view> &values)
 {
-	_data.push_back(value);
-}
-
-const vector<string> &CSVImportColumn::getValues() const
-{
-	return _data;
+	for (const boost::string_view &value : values)
+		_builder.add(value);
 }
 
 bool CSVImportColumn::isValueEqual(Column &col, size_t row) const
 {
-	if (row >= _data.size())
-		return false;
-
-	const string &value = _data[row];
-
-	return isStringValueEqual(value, col, row);
+	return _builder.isValueEqual(col, row);
 }
@@ -1,7 +1,7 @@
 #ifndef CSVIMPORTCOLUMN_H
 #define CSVIMPORTCOLUMN_H
 
-#include "importcolumn.h"
+#include "columnbuilder.h"
 
 class CSVImportColumn : public ImportColumn
 {
@@ -11,12 +11,14 @@ public:
 
 	virtual size_t size() const;
 	virtual bool isValueEqual(Column &col, size_t row) const;
+	virtual std::string fingerprint() const			{ return _builder.fingerprint(); }
 
-	void addValue(const std::string &value);
-	const std::vector<std::string>& getValues() const;
+	void addValues(const std::vector<boost::string_view> &values);
+	void finish()									{ _builder.finish(); }
+	const InferredValues& getInferredValues() const	{ return _builder.values(); }
 
 private:
-	std::vector<std::string> _data;
+	ColumnBuilder _builder;
 
 };
 
@@ -18,10 +18,15 @@
 #include "csvimporter.h"
 #include "csvimportcolumn.h"
 #include "csv.h"
+#include "parallelutils.h"
 
 
 using namespace std;
 
+// Files smaller than this are read on a single thread, larger files are read in windows of about this many bytes per thread.
+static const size_t minimumPieceSize	= 1024 * 1024;
+static const size_t windowSizePerPiece	= 16 * 1024 * 1024;
+
 CSVImporter::CSVImporter(DataSetPackage *packageData) : Importer(packageData)
 {
 	_packageData->setIsArchive(false);
@@ -70,35 +75,61 @@ ImportDataSet* CSVImporter::loadFile(const string &locator, boost::function<void
 	unsigned long long progress;
 	unsigned long long lastProgress = -1;
 
-	size_t columnCount = colNames.size();
-
-//	for (size_t i = 0; i < columnCount; i++)  // columns
-//		cells.push_back(vector<string>());
+	size_t	columnCount	= colNames.size();
+	char	delim		= csv.delimiter();
 
-	vector<string> line;
-	bool success = csv.readLine(line);
+	// The file is read in windows of text that are split on record boundaries, the pieces are tokenised on worker threads and appended to the columns in order.
+	size_t	pieces		= parallelUtils::threadCount(csv.size() / minimumPieceSize + 1);
+	size_t	windowSize	= pieces * windowSizePerPiece;
+	string	window;
+	bool	more		= true;
 
-	while (success)
+	while (more)
 	{
-		progress = 50 * csv.pos() / csv.size();
-		if (progress != lastProgress)
+		while (more && window.size() < windowSize)
 		{
-			progressCallback("Loading Data Set", progress);
-			lastProgress = progress;
+			more = csv.readBlock(window);
+
+			progress = 50 * csv.pos() / csv.size();
+			if (progress != lastProgress)
+			{
+				progressCallback("Loading Data Set", progress);
+				lastProgress = progress;
+			}
 		}
 
-		if (line.size() != 0) {
-			size_t i = 0;
-			for (; i < line.size() && i < columnCount; i++)
-				importColumns.at(i)->addValue(line[i]);
-			for (; i < columnCount; i++)
-				importColumns.at(i)->addValue(string());
+		vector<size_t> boundaries = CSV::recordBoundaries(window, pieces, ! more);
+
+		if (boundaries.size() < 2)
+		{
+			// no complete record in the window yet
+			windowSize *= 2;
+			continue;
 		}
 
-		line.clear();
-		success = csv.readLine(line);
+		size_t											chunks = boundaries.size() - 1;
+		vector<vector<vector<boost::string_view> > >	chunkColumns(chunks, vector<vector<boost::string_view> >(columnCount));
+
+		parallelUtils::forEach(chunks, [&](size_t chunk)
+		{
+			CSV::parseRecords(window.data() + boundaries[chunk], window.data() + boundaries[chunk + 1], delim, chunkColumns[chunk]);
+		});
+
+		// the fields point into the window, every column takes its values over in their final type, in parallel over the columns
+		parallelUtils::forEach(columnCount, [&](size_t col)
+		{
+			for (vector<vector<boost::string_view> > &chunk : chunkColumns)
+				importColumns[col]->addValues(chunk[col]);
+		});
+
+		window.erase(0, boundaries.back());
 	}
 
+	csv.close();
+
+	for (CSVImportColumn *importColumn : importColumns)
+		importColumn->finish();
+
 	for (vector<CSVImportColumn *>::iterator it = importColumns.begin(); it != importColumns.end(); ++it)
 		result->addColumn(*it);
 
@@ -112,8 +143,7 @@ ImportDataSet* CSVImporter::loadFile(const string &locator, boost::function<void
 void CSVImporter::fillSharedMemoryColumn(ImportColumn *importColumn, Column &column)
 {
 	CSVImportColumn *csvColumn = dynamic_cast<CSVImportColumn *>(importColumn);
-	const vector<string> &values = csvColumn->getValues();
 
-	fillSharedMemoryColumnWithStrings(values, column);
+	fillSharedMemoryColumnWithInferred(csvColumn->getInferredValues(), column);
 }
 
@@ -1,6 +1,8 @@
 #include "importcolumn.h"
 #include <cmath>
+#include <cstdio>
 #include "utils.h"
+#include "numericparser.h"
 
 using namespace std;
 
@@ -34,137 +36,71 @@ bool ImportColumn::isStringValueEqual(const string &value, Column &col, size_t r
 	return result;
 }
 
-string ImportColumn::getName() const
+void ImportColumn::Fingerprinter::addBytes(const char * bytes, size_t size)
 {
-	return _name;
+	for (size_t i = 0; i < size; i++)
+	{
+		_hash ^= uint8_t(bytes[i]);
+		_hash *= 1099511628211ULL;
+	}
 }
 
-string ImportColumn::_deEuropeanise(const string &value)
+void ImportColumn::Fingerprinter::add(boost::string_view value)
 {
-	int dots = 0;
-	int commas = 0;
+	uint64_t size = value.size();
 
-	for (size_t i = 0; i < value.length(); i++)
-	{
-		if (value[i] == '.')
-			dots++;
-		else if (value[i] == ',')
-			commas++;
-	}
+	addBytes(reinterpret_cast<const char*>(&size), sizeof(size));
+	addBytes(value.data(), value.size());
+	_rows++;
+}
 
-	if (commas > 0)
-	{
-		string uneurope = value;
-
-		if (dots > 0)
-		{
-			size_t i = 0;
-			size_t j = 0;
-
-			for (;i < value.size(); i++)
-			{
-				if (value[i] == '.')
-					continue;
-				uneurope[j] = value[i];
-
-				j++;
-			}
-
-			uneurope.resize(j);
-		}
-
-		for (size_t i = 0; i < uneurope.length(); i++)
-		{
-			if (uneurope[i] == ',')
-			{
-				uneurope[i] = '.';
-				break;
-			}
-		}
-
-		return uneurope;
-	}
+string ImportColumn::Fingerprinter::result() const
+{
+	char hash[17];
+	snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)_hash);
 
-	return value;
+	return std::to_string(_rows) + ":" + hash;
 }
 
-bool ImportColumn::convertValueToInt(const string &strValue, int &intValue)
+string ImportColumn::getName() const
 {
-	bool success = true;
-	if (!Column::isEmptyValue(strValue))
-	{
-		if (!Utils::getIntValue(strValue, intValue))
-			success = false;
-	}
-	else
-	{
-		intValue = INT_MIN;
-	}
-
-	return success;
+	return _name;
 }
 
-bool ImportColumn::convertValueToDouble(const string &strValue, double &doubleValue)
+bool ImportColumn::isEmptyValue(boost::string_view value)
 {
-	bool success = true;
-	string v = _deEuropeanise(strValue);
+	if (value.empty())
+		return true;
 
-	if (!Column::isEmptyValue(v))
-	{
-		if (!Utils::getDoubleValue(v, doubleValue))
-			success = false;
-	}
-	else
-	{
-		doubleValue = NAN;
-	}
+	for (const string &emptyValue : Utils::getEmptyValues())
+		if (value == emptyValue)
+			return true;
 
-	return success;
+	return false;
 }
 
-bool ImportColumn::convertToInt(const vector<string> &values, vector<int> &intValues, set<int> &uniqueValues, map<int, string> &emptyValuesMap)
+bool ImportColumn::convertValueToInt(boost::string_view strValue, int &intValue)
 {
-	bool success = true;
-	int row = 0;
-	for (vector<string>::const_iterator it = values.begin(); it != values.end(); ++it, ++row)
+	if (isEmptyValue(strValue))
 	{
-		const string &value = *it;
-		int intValue = INT_MIN;
-		success = convertValueToInt(value, intValue);
-		if (success)
-		{
-			if (intValue != INT_MIN)
-				uniqueValues.insert(intValue);
-			else if (!value.empty())
-				emptyValuesMap.insert(make_pair(row, value));
-			intValues.push_back(intValue);
-		}
-		else
-			break;
+		intValue = INT_MIN;
+		return true;
 	}
 
-	return success;
+	return NumericParser::parseInt(strValue, intValue);
 }
 
-bool ImportColumn::convertToDouble(const vector<string> &values, vector<double> &doubleValues, map<int, string> &emptyValuesMap)
+bool ImportColumn::convertValueToDouble(boost::string_view strValue, double &doubleValue)
 {
-	bool success = true;
-	int row = 0;
-	for (vector<string>::const_iterator it = values.begin(); it != values.end(); ++it, ++row)
+	char				buffer[64];
+	string				longer;
+	boost::string_view	v = NumericParser::deEuropeanise(strValue, buffer, sizeof(buffer), longer);
+
+	if (isEmptyValue(v))
 	{
-		const string &value = *it;
-		double doubleValue = NAN;
-		success = convertValueToDouble(value, doubleValue);
-
-		if (success)
-		{
-			doubleValues.push_back(doubleValue);
-			if (std::isnan(doubleValue) && value != Utils::emptyValue)
-				emptyValuesMap.insert(make_pair(row, value));
-		}
-		else
-			break;
+		doubleValue = NAN;
+		return true;
 	}
 
-	return success;
+	return NumericParser::parseDouble(v, doubleValue);
 }
@@ -4,6 +4,8 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <cstdint>
+#include <boost/utility/string_view.hpp>
 #include "column.h"
 
 class ImportDataSet;
@@ -16,23 +18,50 @@ public:
 	virtual size_t size() const = 0;
 	virtual bool isValueEqual(Column &col, size_t row) const = 0;
 
+	/// A hash of the values as they were read from the file, the same values give the same fingerprint in every session.
+	/// Empty when the importer doesn't make one, then a sync compares the column cell by cell.
+	virtual std::string fingerprint() const { return ""; }
+
 
 	virtual std::string getName() const;
 
-	static bool convertToInt(const std::vector<std::string> &values, std::vector<int> &intValues, std::set<int> &uniqueValues, std::map<int, std::string> &emptyValuesMap);
-	static bool convertToDouble(const std::vector<std::string> &values, std::vector<double> &doubleValues, std::map<int, std::string> &emptyValuesMap);
+	static bool convertValueToInt(boost::string_view strValue, int &intValue);
+	static bool convertValueToDouble(boost::string_view strValue, double &doubleValue);
 
-	static bool convertValueToInt(const std::string &strValue, int &intValue);
-	static bool convertValueToDouble(const std::string &strValue, double &doubleValue);
+	/// What a column of strings becomes in the data set, worked out apart from the shared memory so that it can be done on a worker thread.
+	/// For nominal-text ints holds for every row the index of its text in dictionary.
+	struct InferredValues
+	{
+		Column::ColumnType			type = Column::ColumnTypeUnknown;
+		std::vector<int>			ints;
+		std::vector<double>			doubles;
+		std::vector<std::string>	dictionary;
+		std::set<int>				uniqueValues;
+		std::map<int, std::string>	emptyValuesMap;
+	};
 
+	static bool isEmptyValue(boost::string_view value);
 	static bool isStringValueEqual(const std::string &value, Column &col, size_t row);
 
+	/// Builds a fingerprint() one value at a time: FNV-1a over every value and its length, so that "ab","c" differs from "a","bc".
+	class Fingerprinter
+	{
+	public:
+		void		add(boost::string_view value);
+		void		add(double value) { add(boost::string_view(reinterpret_cast<const char*>(&value), sizeof(double))); }
+		std::string	result() const;
+
+	private:
+		void		addBytes(const char * bytes, size_t size);
+
+		uint64_t	_hash = 14695981039346656037ULL;
+		size_t		_rows = 0;
+	};
+
 protected:
 	ImportDataSet* _importDataSet;
 	std::string _name;
 
-	static std::string _deEuropeanise(const std::string &value);
-
 };
 
 #endif // IMPORTCOLUMN_H
@@ -1,4 +1,5 @@
 #include "importer.h"
+#include "columnbuilder.h"
 #include "sharedmemory.h"
 #include <iostream>
 
@@ -21,12 +22,14 @@ void Importer::loadDataSet(const std::string &locator, boost::function<void(cons
 	int rowCount = importDataSet->rowCount();
 
 	setDataSetSize(columnCount, rowCount);
+	_packageData->resetColumnFingerprints();
 
 	int colNo = 0;
 	for (ImportColumn *importColumn : *importDataSet)
 	{
 		progressCallback("Loading Data Set", 50 + 50 * colNo / columnCount);
 		initColumn(colNo, importColumn);
+		_packageData->storeColumnFingerprint(importColumn->getName(), importColumn->fingerprint());
 		colNo++;
 	}
 
@@ -69,7 +72,15 @@ void Importer::syncDataSet(const std::string &locator, boost::function<void(cons
 			int orgRowCount		= orgColumn.rowCount();
 			int syncRowCount	= syncColumn->size();
 
-			if (orgRowCount != syncRowCount)
+			std::string syncFingerprint	= syncColumn->fingerprint(),
+						orgFingerprint	= _packageData->columnFingerprint(syncColumnName);
+
+			if (syncFingerprint != "" && orgFingerprint != "")
+			{
+				if (syncFingerprint != orgFingerprint)
+					changedColumns.push_back(std::pair<int, Column *>(syncColNo, &orgColumn));
+			}
+			else if (orgRowCount != syncRowCount)
 				changedColumns.push_back(std::pair<int, Column *>(syncColNo, &orgColumn));
 			else
 			{
@@ -97,7 +108,20 @@ void Importer::syncDataSet(const std::string &locator, boost::function<void(cons
 				std::string newColName	= newColIt->first;
 				ImportColumn *newValues = importDataSet->getColumn(newColName);
 
-				if (newValues->size()== missingColumn->rowCount())
+				std::string newFingerprint		= newValues->fingerprint(),
+							missingFingerprint	= _packageData->columnFingerprint(nameColMissing.first);
+
+				if (newFingerprint != "" && missingFingerprint != "")
+				{
+					// a renamed column has the same content, so no need to look at the cells
+					if (newFingerprint == missingFingerprint)
+					{
+						changeNameColumns[newColName] = missingColumn;
+						newColumns.erase(newColIt);
+						break;
+					}
+				}
+				else if (newValues->size()== missingColumn->rowCount())
 				{
 					bool same_values = true;
 					for (size_t r = 0; r < newValues->size(); r++)
@@ -117,45 +141,50 @@ void Importer::syncDataSet(const std::string &locator, boost::function<void(cons
 			}
 	}
 
-	_syncPackage(importDataSet, newColumns, changedColumns, missingColumns, changeNameColumns, rowCountChanged);
+	// The engines don't need to pause and nothing needs to be refreshed when the file only got a new timestamp
+	if (newColumns.size() > 0 || changedColumns.size() > 0 || missingColumns.size() > 0 || changeNameColumns.size() > 0 || rowCountChanged)
+		_syncPackage(importDataSet, newColumns, changedColumns, missingColumns, changeNameColumns, rowCountChanged);
+
+	_packageData->resetColumnFingerprints();
+
+	for (ImportColumn *syncColumn : *importDataSet)
+		_packageData->storeColumnFingerprint(syncColumn->getName(), syncColumn->fingerprint());
 
 	delete importDataSet;
 }
 
 void Importer::fillSharedMemoryColumnWithStrings(const std::vector<std::string> &values, Column &column)
 {
-	// try to make the column nominal
-	bool success = false;
-	std::set<int> uniqueValues;
-	std::vector<int> intValues;
-	intValues.reserve(values.size());
-	std::map<int, std::string> emptyValuesMap;
+	ColumnBuilder builder;
 
-	if (ImportColumn::convertToInt(values, intValues, uniqueValues, emptyValuesMap) && uniqueValues.size() <= 24)
-	{
-		column.setColumnAsNominalOrOrdinal(intValues, uniqueValues);
-		success = true;
-	}
+	for (const std::string &value : values)
+		builder.add(value);
 
+	builder.finish();
 
-	if (!success)
-	{
-		// try to make the column scale
-		std::vector<double> doubleValues;
-		doubleValues.reserve(values.size());
-		emptyValuesMap.clear();
+	fillSharedMemoryColumnWithInferred(builder.values(), column);
+}
 
-		if (ImportColumn::convertToDouble(values, doubleValues, emptyValuesMap))
-		{
-			column.setColumnAsScale(doubleValues);
-			success = true;
-		}
-	}
+void Importer::fillSharedMemoryColumnWithInferred(const ImportColumn::InferredValues &inferred, Column &column)
+{
+	std::map<int, std::string> emptyValuesMap;
 
-	if (!success)
+	switch (inferred.type)
 	{
-		// if it can't be made nominal numeric or scale, make it nominal-text
-		emptyValuesMap = column.setColumnAsNominalText(values);
+	case Column::ColumnTypeNominal:
+	case Column::ColumnTypeOrdinal:
+		column.setColumnAsNominalOrOrdinal(inferred.ints, inferred.uniqueValues, inferred.type == Column::ColumnTypeOrdinal);
+		emptyValuesMap = inferred.emptyValuesMap;
+		break;
+
+	case Column::ColumnTypeScale:
+		column.setColumnAsScale(inferred.doubles);
+		emptyValuesMap = inferred.emptyValuesMap;
+		break;
+
+	default:
+		emptyValuesMap = column.setColumnAsNominalText(inferred.dictionary, inferred.ints);
+		break;
 	}
 
 	_packageData->storeInEmptyValues(column.name(), emptyValuesMap);
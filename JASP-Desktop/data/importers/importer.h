@@ -22,6 +22,7 @@ protected:
 	virtual void fillSharedMemoryColumn(ImportColumn *importColumn, Column &column) = 0;
 
 	void fillSharedMemoryColumnWithStrings(const std::vector<std::string> &values, Column &column);
+	void fillSharedMemoryColumnWithInferred(const ImportColumn::InferredValues &inferred, Column &column);
 
 	DataSetPackage *_packageData;
 
@@ -20,6 +20,8 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/nowide/fstream.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include <sys/stat.h>
 
@@ -56,7 +58,7 @@ void JASPImporter::loadDataSet(DataSetPackage *packageData, const std::string &p
 
 void JASPImporter::loadDataArchive(DataSetPackage *packageData, const std::string &path, boost::function<void (const std::string &, int)> progressCallback)
 {
-	if (packageData->dataArchiveVersion().major == 1)
+	if (packageData->dataArchiveVersion().major == 1 || packageData->dataArchiveVersion().major == 2) //2.x stores data.bin uncompressed with page aligned columns but is otherwise the same as 1.x
 		loadDataArchive_1_00(packageData, path, progressCallback);
 	else
 		throw std::runtime_error("The file version is not supported.\nPlease update to the latest version of JASP to view this file.");
@@ -128,6 +130,12 @@ void JASPImporter::loadDataArchive_1_00(DataSetPackage *packageData, const std::
 		}
 	}
 
+	Json::Value &columnFingerprintsJson = dataSetDesc["columnFingerprints"];
+	packageData->resetColumnFingerprints();
+
+	for (Json::Value::iterator iter = columnFingerprintsJson.begin(); iter != columnFingerprintsJson.end(); ++iter) //Older files don't have them, the next sync compares cell by cell
+		packageData->storeColumnFingerprint(iter.key().asString(), (*iter).asString());
+
 	columnCount = dataSetDesc["columnCount"].asInt();
 	rowCount	= dataSetDesc["rowCount"].asInt();
 	if (rowCount < 0 || columnCount < 0)
@@ -164,6 +172,10 @@ void JASPImporter::loadDataArchive_1_00(DataSetPackage *packageData, const std::
 	Json::Value &columnsDesc = dataSetDesc["fields"];
 	int i = 0;
 
+	std::vector<uint64_t>	dataOffsets;
+	uint64_t				packedOffset	= 0;
+	bool					alignedData		= packageData->dataArchiveVersion().major >= 2;
+
 	for (Json::Value columnDesc : columnsDesc)
 	{
 		std::string name					= columnDesc["name"].asString();
@@ -228,6 +240,12 @@ void JASPImporter::loadDataArchive_1_00(DataSetPackage *packageData, const std::
 			catch (...)						{ std::cout << "something else" << std::endl;	}
 		} while (success == false);
 
+		Column::ColumnType columnType = parseColumnType(columnDesc["measureType"].asString());
+
+		//Before 2.0 the columns were simply written one after the other
+		dataOffsets.push_back(alignedData ? uint64_t(columnDesc["dataOffset"].asDouble()) : packedOffset);
+		packedOffset += uint64_t(rowCount) * (columnType == Column::ColumnTypeScale ? sizeof(double) : sizeof(int));
+
 		progress = 50 * i / columnCount;
 		if (progress != lastProgress)
 		{
@@ -238,39 +256,8 @@ void JASPImporter::loadDataArchive_1_00(DataSetPackage *packageData, const std::
 		i += 1;
 	}
 
-	std::string entryName = "data.bin";
-	FileReader dataEntry = FileReader(path, entryName);
-	if (!dataEntry.exists())
-		throw std::runtime_error("Entry " + entryName + " could not be found.");
-
-	char buff[sizeof(double) > sizeof(int) ? sizeof(double) : sizeof(int)];
-
-	for (int c = 0; c < columnCount; c++)
-	{
-		Column &column					= packageData->dataSet()->column(c);
-		Column::ColumnType columnType	= column.columnType();
-		int typeSize					= (columnType == Column::ColumnTypeScale) ? sizeof(double) : sizeof(int);
-
-		for (int r = 0; r < rowCount; r++)
-		{
-			int errorCode	= 0;
-			int size		= dataEntry.readData(buff, typeSize, errorCode);
-
-			if (errorCode != 0 || size != typeSize)
-				throw std::runtime_error("Could not read 'data.bin' in JASP archive.");
-
-			if (columnType == Column::ColumnTypeScale)	column.setValue(r, *(double*)buff);
-			else										column.setValue(r, *(int*)buff);
-
-			progress = 50 + (50 * ((c * rowCount) + (r + 1)) / (columnCount * rowCount));
-			if (progress != lastProgress)
-			{
-				progressCallback("Loading Data Set", progress);
-				lastProgress = progress;
-			}
-		}
-	}
-	dataEntry.close();
+	if (!alignedData || !loadDataBinMapped(packageData, path, dataOffsets, rowCount, progressCallback))
+		loadDataBinStreamed(packageData, path, dataOffsets, rowCount, progressCallback);
 
 	if(resultXmlCompare::compareResults::theOne()->testMode())
 	{
@@ -308,6 +295,119 @@ void JASPImporter::loadDataArchive_1_00(DataSetPackage *packageData, const std::
 	}*/
 }
 
+bool JASPImporter::loadDataBinMapped(DataSetPackage *packageData, const std::string &path, const std::vector<uint64_t> &dataOffsets, int rowCount, boost::function<void (const std::string &, int)> progressCallback)
+{
+	uint64_t dataStart, dataSize;
+
+	if (!FileReader::findStoredEntry(path, "data.bin", dataStart, dataSize))
+		return false;
+
+	try
+	{
+		boost::interprocess::file_mapping archiveFile(path.c_str(), boost::interprocess::read_only);
+
+		int columnCount = int(dataOffsets.size()),
+			lastProgress = -1;
+
+		for (int c = 0; c < columnCount; c++)
+		{
+			Column &column	= packageData->dataSet()->column(c);
+			size_t	bytes	= size_t(rowCount) * ((column.columnType() == Column::ColumnTypeScale) ? sizeof(double) : sizeof(int));
+
+			if (dataOffsets[c] + bytes > dataSize)
+				throw std::runtime_error("Could not read 'data.bin' in JASP archive.");
+
+			if (bytes == 0)
+				continue;
+
+			boost::interprocess::mapped_region columnData(archiveFile, boost::interprocess::read_only, dataStart + dataOffsets[c], bytes);
+
+			if (column.columnType() == Column::ColumnTypeScale)	column.setValues(0, rowCount, static_cast<const double*>(columnData.get_address()));
+			else												column.setValues(0, rowCount, static_cast<const int*>(columnData.get_address()));
+
+			int progress = 50 + 50 * (c + 1) / columnCount;
+			if (progress != lastProgress)
+			{
+				progressCallback("Loading Data Set", progress);
+				lastProgress = progress;
+			}
+		}
+	}
+	catch (boost::interprocess::interprocess_exception &e)
+	{
+		std::cout << "Could not map data.bin (" << e.what() << "), reading it instead." << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void JASPImporter::loadDataBinStreamed(DataSetPackage *packageData, const std::string &path, const std::vector<uint64_t> &dataOffsets, int rowCount, boost::function<void (const std::string &, int)> progressCallback)
+{
+	std::string entryName = "data.bin";
+	FileReader dataEntry = FileReader(path, entryName);
+	if (!dataEntry.exists())
+		throw std::runtime_error("Entry " + entryName + " could not be found.");
+
+	const size_t		rowsPerChunk = 64 * 1024;
+	std::vector<char>	buff(rowsPerChunk * sizeof(double));
+
+	int					columnCount		= int(dataOffsets.size());
+	uint64_t			position		= 0;
+	unsigned long long	progress,
+						lastProgress	= -1;
+
+	//Reads exactly size bytes into buff, the archive might hand them over in smaller pieces
+	auto readExactly = [&](int size)
+	{
+		int readSoFar = 0;
+
+		while (readSoFar < size)
+		{
+			int errorCode	= 0;
+			int read		= dataEntry.readData(buff.data() + readSoFar, size - readSoFar, errorCode);
+
+			if (errorCode != 0 || read <= 0)
+				throw std::runtime_error("Could not read 'data.bin' in JASP archive.");
+
+			readSoFar += read;
+		}
+
+		position += size;
+	};
+
+	for (int c = 0; c < columnCount; c++)
+	{
+		Column &column					= packageData->dataSet()->column(c);
+		Column::ColumnType columnType	= column.columnType();
+		int typeSize					= (columnType == Column::ColumnTypeScale) ? sizeof(double) : sizeof(int);
+
+		if (dataOffsets[c] < position)
+			throw std::runtime_error("Could not read 'data.bin' in JASP archive.");
+
+		while (position < dataOffsets[c]) //skip the alignment padding
+			readExactly(int(std::min<uint64_t>(buff.size(), dataOffsets[c] - position)));
+
+		for (size_t r = 0; r < size_t(rowCount); r += rowsPerChunk)
+		{
+			size_t	rows		= std::min(rowsPerChunk, size_t(rowCount) - r);
+
+			readExactly(int(rows * typeSize));
+
+			if (columnType == Column::ColumnTypeScale)	column.setValues(r, rows, reinterpret_cast<const double*>(buff.data()));
+			else										column.setValues(r, rows, reinterpret_cast<const int*>(buff.data()));
+
+			progress = 50 + (50 * ((c * rowCount) + (r + rows)) / (columnCount * rowCount));
+			if (progress != lastProgress)
+			{
+				progressCallback("Loading Data Set", progress);
+				lastProgress = progress;
+			}
+		}
+	}
+	dataEntry.close();
+}
+
 void JASPImporter::loadJASPArchive(DataSetPackage *packageData, const std::string &path, boost::function<void (const std::string &, int)> progressCallback)
 {
 	if (packageData->archiveVersion().major >= 1 && packageData->archiveVersion().major <= 3) //2.x version have a different analyses.json structure but can be loaded using the 1_00 loader. 3.x adds computed columns
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <vector>
+#include <stdint.h>
 
 class JASPImporter
 {
@@ -38,6 +39,8 @@ private:
 	static void loadJASPArchive(DataSetPackage *packageData, const std::string &path, boost::function<void (const std::string &, int)> progressCallback);
 	static void loadDataArchive_1_00(DataSetPackage *packageData, const std::string &path, boost::function<void (const std::string &, int)> progressCallback);
 	static void loadJASPArchive_1_00(DataSetPackage *packageData, const std::string &path, boost::function<void (const std::string &, int)> progressCallback);
+	static bool loadDataBinMapped(DataSetPackage *packageData, const std::string &path, const std::vector<uint64_t> &dataOffsets, int rowCount, boost::function<void (const std::string &, int)> progressCallback);
+	static void loadDataBinStreamed(DataSetPackage *packageData, const std::string &path, const std::vector<uint64_t> &dataOffsets, int rowCount, boost::function<void (const std::string &, int)> progressCallback);
 
 	static Column::ColumnType parseColumnType(std::string name);
 	static bool parseJsonEntry(Json::Value &root, const std::string &path, const std::string &entry, bool required);
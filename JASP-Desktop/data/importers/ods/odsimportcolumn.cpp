@@ -62,6 +62,16 @@ bool ODSImportColumn::isValueEqual(Column &col, size_t row) const
 	return isStringValueEqual(value, col, row);
 }
 
+string ODSImportColumn::fingerprint() const
+{
+	Fingerprinter fingerprinter;
+
+	for (const ODSSheetCell &cell : _rows)
+		fingerprinter.add(cell._string);
+
+	return fingerprinter.result();
+}
+
 /**
  * @brief insert Inserts string value for cell, irrespective of type.
  * @param row
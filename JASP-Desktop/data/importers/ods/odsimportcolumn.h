@@ -69,6 +69,12 @@ public:
 	 */
 	virtual bool isValueEqual(Column &col, size_t row) const;
 
+	/**
+	 * @brief fingerprint Hash of the cells as read.
+	 * @return A fingerprint to compare with the one from the last import.
+	 */
+	virtual std::string fingerprint() const;
+
 	/**
 	 * @brief hasCall Checks for presence of a cell at row.
 	 * @param row Row check for.
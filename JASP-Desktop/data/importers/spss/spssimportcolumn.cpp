@@ -98,6 +98,20 @@ bool SPSSImportColumn::isValueEqual(Column &col, size_t row) const
 	return result;
 }
 
+string SPSSImportColumn::fingerprint() const
+{
+	Fingerprinter fingerprinter;
+
+	if (cellType() == cellString)
+		for (const string &value : strings)
+			fingerprinter.add(value);
+	else
+		for (double value : numerics)
+			fingerprinter.add(value);
+
+	return fingerprinter.result();
+}
+
 const string& SPSSImportColumn::setSuitableName()
 {
     if (_spssLongColName.length() > 0)
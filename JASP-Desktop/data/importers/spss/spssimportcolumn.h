@@ -69,6 +69,7 @@ public:
 
 	virtual size_t size() const;
 	virtual bool isValueEqual(Column &col, size_t row) const;
+	virtual std::string fingerprint() const;
 
 	const std::string& setSuitableName();
 
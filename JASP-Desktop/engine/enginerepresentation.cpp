@@ -1,20 +1,108 @@
 #include "enginerepresentation.h"
 #include "utilities/settings.h"
 
+#ifdef __linux__
+#include <signal.h>
+#endif
+
 EngineRepresentation::EngineRepresentation(IPCChannel * channel, QProcess * slaveProcess, QObject * parent)
 	: QObject(parent), _slaveProcess(slaveProcess), _channel(channel)
 {
-	_imageBackground = Settings::value(Settings::IMAGE_BACKGROUND).toString();
+	_imageBackground	= Settings::value(Settings::IMAGE_BACKGROUND).toString();
+	_messageFormat		= messageFormatFromString(Settings::value(Settings::ENGINE_MESSAGE_FORMAT).toString().toStdString());
+
+	_watcher = new IPCChannelWatcher(_channel, this);
+	connect(_watcher, &IPCChannelWatcher::messageWaiting, this, &EngineRepresentation::messageWaiting);
+	_watcher->start();
+
+	_lastActivity.start();
 }
 
 EngineRepresentation::~EngineRepresentation()
 {
+	_watcher->stop();
+	delete _channel;
+
 	if(_slaveProcess != NULL)
 	{
 
 		_slaveProcess->terminate();
 		_slaveProcess->kill();
 	}
+
+#ifdef __linux__
+	if(_forkedPID > 0)
+		::kill(pid_t(_forkedPID), SIGKILL); //The template reaps it
+#endif
+}
+
+///The process behind this engine died and a new one is started on the same channel number, whatever it was doing is lost.
+void EngineRepresentation::restartOnChannel(IPCChannel * channel)
+{
+	_watcher->stop();
+	delete _watcher;
+	delete _channel;
+
+	_channel	= channel;
+	_watcher	= new IPCChannelWatcher(_channel, this);
+	connect(_watcher, &IPCChannelWatcher::messageWaiting, this, &EngineRepresentation::messageWaiting);
+	_watcher->start();
+
+	_slaveProcess	= NULL;
+	_forkedPID		= 0;
+	_forkRequest	= -1;
+
+	switch(_engineState)
+	{
+	case engineState::analysis:
+	{
+		Analysis * analysis = _analysisInProgress;
+
+		Json::Value results(Json::objectValue);
+		results["title"]		= analysis->title();
+		results["error"]		= 1;
+		results["errorMessage"]	= "The engine running this analysis crashed, it was restarted but this analysis was not.";
+
+		analysis->setStatus(Analysis::Error);
+		analysis->setResults(results);
+		clearAnalysisInProgress();
+
+		for(std::string col : analysis->columnsCreated())
+			emit computeColumnFailed(col, "Engine crashed..");
+		break;
+	}
+
+	case engineState::filter:
+		_engineState = engineState::idle;
+		emit processFilterErrorMsg("The engine crashed while running this filter..", _scriptRequest.get("requestId", -1).asInt());
+		break;
+
+	case engineState::rCode:
+		_engineState = engineState::idle;
+		emit rCodeReturned("", _scriptRequest.get("requestId", -1).asInt());
+		break;
+
+	case engineState::computeColumn:
+		_engineState = engineState::idle;
+		emit computeColumnFailed(_scriptRequest.get("columnName", "").asString(), "Engine crashed..");
+		break;
+
+	case engineState::paused:	_enginePaused = true;				break;	//A fresh engine hasn't loaded any data yet so it is as paused as can be
+	default:					_engineState = engineState::idle;	break;
+	}
+
+	_scriptRequest = Json::nullValue;
+
+	for(; !_tablePageRequests.empty(); _tablePageRequests.pop())
+	{
+		const Json::Value & page = _tablePageRequests.front();
+		emit tablePageReturned(page["analysisId"].asInt(), QString::fromStdString(page["tableName"].asString()), page["from"].asInt(), "null");
+	}
+
+	_replayingModules = false;
+	std::queue<Json::Value>().swap(_moduleReplays);
+
+	_lastActivity.restart();
 }
 
 void EngineRepresentation::clearAnalysisInProgress()
@@ -39,20 +127,22 @@ void EngineRepresentation::setAnalysisInProgress(Analysis* analysis)
 
 void EngineRepresentation::process()
 {
-	if (_engineState == engineState::idle)
+	if (_engineState == engineState::idle && _tablePageRequests.empty())
 		return;
 
-	std::string data;
+	Json::Value json;
+	bool		received = _channel->receive([&](const char * message, size_t size) { JsonSerializer::parse(message, size, json); });
 
-	if (_channel->receive(data))
+	_watcher->rearm();
+
+	if (received)
 	{
+		_lastActivity.restart();
+
 #ifdef PRINT_ENGINE_MESSAGES
 		std::cout << "message received" <<std::endl;
 #endif
 
-		Json::Value json;
-		Json::Reader().parse(data, json);
-
 		if(!json.get("typeRequest", Json::nullValue).isString() && _engineState != engineState::analysis)
 			throw std::runtime_error("Malformed reply from engine!");
 
@@ -67,6 +157,7 @@ void EngineRepresentation::process()
 		case engineState::paused:			processEnginePausedReply();			break;
 		case engineState::resuming:			processEngineResumedReply();		break;
 		case engineState::moduleRequest:	processModuleRequestReply(json);	break;
+		case engineState::tablePage:		processTablePageReply(json);		break;
 		default:							throw std::logic_error("If you define new engineStates you should add them to the switch in EngineRepresentation::process()!");
 		}
 	}
@@ -90,7 +181,8 @@ void EngineRepresentation::runScriptOnProcess(RFilterStore * filterStore)
 	std::cout << "sending filter with requestID " << filterStore->requestId << " to engine" << std::endl;
 #endif
 
-	sendString(json.toStyledString());
+	_scriptRequest = json;
+	sendJson(json);
 }
 
 void EngineRepresentation::processFilterReply(Json::Value json)
@@ -105,7 +197,14 @@ void EngineRepresentation::processFilterReply(Json::Value json)
 
 	int requestId = json.get("requestId", -1).asInt();
 
-	if(json.get("filterResult", Json::Value(Json::intValue)).isArray()) //If the result is an array then it came from the engine.
+	if(json.get("filterResultInDataSet", false).asBool()) //The engine put the result in the pending filter of the DataSet
+	{
+		emit processFilterResultInDataSet(requestId);
+
+		if(json.get("filterError", "").asString() != "")
+			emit processFilterErrorMsg(QString::fromStdString(json.get("filterError", "there was a warning").asString()), requestId);
+	}
+	else if(json.get("filterResult", Json::Value(Json::intValue)).isArray()) //If the result is an array then it came from the engine.
 	{
 		std::vector<bool> filterResult;
 		for(Json::Value & jsonResult : json.get("filterResult", Json::Value(Json::arrayValue)))
@@ -129,7 +228,8 @@ void EngineRepresentation::runScriptOnProcess(RScriptStore * scriptStore)
 	json["rCode"]			= scriptStore->script.toStdString();
 	json["requestId"]		= scriptStore->requestId;
 
-	sendString(json.toStyledString());
+	_scriptRequest = json;
+	sendJson(json);
 }
 
 
@@ -162,7 +262,8 @@ void EngineRepresentation::runScriptOnProcess(RComputeColumnStore * computeColum
 	json["computeCode"]		= computeColumnStore->script.toStdString();
 	json["columnType"]		= Column::columnTypeToString(computeColumnStore->columnType);
 
-	sendString(json.toStyledString());
+	_scriptRequest = json;
+	sendJson(json);
 }
 
 
@@ -182,6 +283,35 @@ void EngineRepresentation::processComputeColumnReply(Json::Value json)
 	else						emit computeColumnFailed(columnName, error == "" ? "Unknown Error" : error);
 }
 
+void EngineRepresentation::runScriptOnProcess(RTablePageStore * tablePageStore)
+{
+	Json::Value json = Json::Value(Json::objectValue);
+
+	if(_engineState != engineState::analysis) //The engine running an analysis answers for the tables of it in between
+		_engineState		= engineState::tablePage;
+
+	json["typeRequest"]		= engineStateToString(engineState::tablePage);
+	json["analysisId"]		= tablePageStore->analysisId;
+	json["tableName"]		= tablePageStore->script.toStdString();
+	json["from"]			= tablePageStore->from;
+	json["count"]			= tablePageStore->count;
+
+	_tablePageRequests.push(json);
+	sendJson(json);
+}
+
+void EngineRepresentation::processTablePageReply(Json::Value json)
+{
+	if(_tablePageRequests.empty())
+		throw std::runtime_error("Received an unexpected tablePage reply!");
+	_tablePageRequests.pop();
+
+	if(_engineState == engineState::tablePage)
+		_engineState = engineState::idle;
+
+	emit tablePageReturned(json.get("analysisId", -1).asInt(), QString::fromStdString(json.get("tableName", "").asString()), json.get("from", 0).asInt(), QString::fromStdString(json.get("rows", Json::nullValue).toStyledString()));
+}
+
 void EngineRepresentation::runAnalysisOnProcess(Analysis *analysis)
 {
 #ifdef PRINT_ENGINE_MESSAGES
@@ -190,15 +320,26 @@ void EngineRepresentation::runAnalysisOnProcess(Analysis *analysis)
 
 	setAnalysisInProgress(analysis);
 
+	performType perform = analysis->desiredPerformTypeFromAnalysisStatus();
+
+	if(perform == performType::init || perform == performType::run)
+	{
+		_analysisPerform = perform;
+		_analysisTimer.start();
+	}
+
 	Json::Value json(analysis->createAnalysisRequestJson(_ppi, _imageBackground.toStdString()));
-	_channel->send(json.toStyledString());
+	sendJson(json);
 
 #ifdef PRINT_ENGINE_MESSAGES
 	std::cout << "sending: " << json.toStyledString() << std::endl;
 #endif
 
 	if(analysis->isAborted())
+	{
+		_abortedAnalysisId = int(analysis->id()); //The engine might still be sending something for it
 		clearAnalysisInProgress();
+	}
 
 }
 
@@ -234,8 +375,12 @@ void EngineRepresentation::processAnalysisReply(Json::Value json)
 	int revision				= json.get("revision", -1).asInt();
 	int progress				= json.get("progress", -1).asInt();
 	Json::Value results			= json.get("results", Json::nullValue);
+	Json::Value resultsPatch	= json.get("resultsPatch", Json::nullValue); //jaspResults sends only the changes while running
 	analysisResultStatus status	= analysisResultStatusFromString(json.get("status", "error").asString());
 
+	if (analysis->id() != id && id == _abortedAnalysisId)
+		return;
+
 	if (analysis->id() != id || analysis->revision() < revision)
 		throw std::runtime_error("Received results for wrong analysis!");
 
@@ -265,9 +410,12 @@ void EngineRepresentation::processAnalysisReply(Json::Value json)
 			emit computeColumnFailed(col, "Analysis had an error..");
 		break;
 
-	case analysisResultStatus::exception:
 	case analysisResultStatus::inited:
 	case analysisResultStatus::complete:
+		emit analysisRunTime(analysis, _analysisPerform, _analysisTimer.elapsed());
+		//fallthrough
+
+	case analysisResultStatus::exception:
 		analysis->setResults(results);
 		clearAnalysisInProgress();
 
@@ -278,7 +426,8 @@ void EngineRepresentation::processAnalysisReply(Json::Value json)
 
 	case analysisResultStatus::running:
 	default:
-		analysis->setResults(results, progress);
+		if(resultsPatch.isNull())	analysis->setResults(results, progress);
+		else						analysis->applyResultsPatch(resultsPatch, progress);
 		break;
 	}
 }
@@ -288,10 +437,19 @@ void EngineRepresentation::handleRunningAnalysisStatusChanges()
 	if (_engineState != engineState::analysis)
 		return;
 
-	if(_analysisInProgress->isEmpty() || _analysisInProgress->isAborted())
+	if(_analysisInProgress->isEmpty() || _analysisInProgress->isAborting() || _analysisInProgress->isAborted())
 		runAnalysisOnProcess(_analysisInProgress);
 }
 
+void EngineRepresentation::abortAnalysisInProgress()
+{
+	if (_engineState != engineState::analysis)
+		return;
+
+	_analysisInProgress->setStatus(Analysis::Aborting);
+	runAnalysisOnProcess(_analysisInProgress);
+}
+
 void EngineRepresentation::pauseEngine()
 {
 	Json::Value json		= Json::Value(Json::objectValue);
@@ -302,7 +460,7 @@ void EngineRepresentation::pauseEngine()
 	std::cout << "informing engine that it ought to pause for a bit" << std::endl;
 #endif
 
-	sendString(json.toStyledString());
+	sendJson(json);
 
 	_enginePaused = false;
 }
@@ -320,7 +478,7 @@ void EngineRepresentation::resumeEngine()
 	std::cout << "informing engine that it may resume" << std::endl;
 #endif
 
-	sendString(json.toStyledString());
+	sendJson(json);
 }
 
 void EngineRepresentation::processEnginePausedReply()
@@ -344,7 +502,7 @@ void EngineRepresentation::runModuleRequestOnProcess(Json::Value request)
 	_engineState			= engineState::moduleRequest;
 	request["typeRequest"]	= engineStateToString(_engineState);
 
-	sendString(request.toStyledString());
+	sendJson(request);
 }
 
 void EngineRepresentation::processModuleRequestReply(Json::Value json)
@@ -358,6 +516,15 @@ void EngineRepresentation::processModuleRequestReply(Json::Value json)
 	std::string moduleName		= json["moduleName"].asString();
 	auto getError				= [&](){ return json.get("error", "Unknown error").asString(); };
 
+	if(_replayingModules) //Nobody is waiting for these, the module was loaded everywhere else already
+	{
+		if(!succes)
+			std::cout << "Loading module " << moduleName << " on engine " << channelNumber() << " failed because of: " << getError() << std::endl;
+
+		runNextModuleReplay();
+		return;
+	}
+
 	switch(moduleRequest)
 	{
 	case moduleStatus::installNeeded:
@@ -374,3 +541,24 @@ void EngineRepresentation::processModuleRequestReply(Json::Value json)
 		throw std::runtime_error("Unsupported module request reply to EngineRepresentation::processModuleRequestReply!");
 	}
 }
+
+void EngineRepresentation::replayModuleRequests(std::queue<Json::Value> requests)
+{
+	_moduleReplays = requests;
+
+	if(isIdle())
+		runNextModuleReplay();
+}
+
+void EngineRepresentation::runNextModuleReplay()
+{
+	_replayingModules = _moduleReplays.size() > 0;
+
+	if(!_replayingModules)
+		return;
+
+	Json::Value request = _moduleReplays.front();
+	_moduleReplays.pop();
+
+	runModuleRequestOnProcess(request);
+}
@@ -4,15 +4,18 @@
 #include <QObject>
 #include <QProcess>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <vector>
 
 #include "analysis/options/options.h"
 #include "analysis/analysis.h"
 #include "analysis/analyses.h"
 #include "ipcchannel.h"
+#include "ipcchannelwatcher.h"
 #include "data/datasetpackage.h"
 #include <queue>
 #include "enginedefinitions.h"
+#include "jsonserializer.h"
 #include "rscriptstore.h"
 #include "modules/dynamicmodules.h"
 
@@ -26,13 +29,21 @@ public:
 	void clearAnalysisInProgress();
 	void setAnalysisInProgress(Analysis* analysis);
 
-	bool isIdle() { return _engineState == engineState::idle; }
+	bool isIdle()			{ return _engineState == engineState::idle;		}
+	bool isRunningFilter()	{ return _engineState == engineState::filter;	}
+
+	bool waitingForTablePages() const { return !_tablePageRequests.empty(); }
 
 	void handleRunningAnalysisStatusChanges();
+	void abortAnalysisInProgress();
+
+	Analysis*	analysisInProgress()	const	{ return _engineState == engineState::analysis ? _analysisInProgress : NULL; }
+	qint64		msecsAnalysisRunning()	const	{ return _analysisTimer.elapsed(); }
 
 	void runScriptOnProcess(RFilterStore * filterStore);
 	void runScriptOnProcess(RScriptStore * scriptStore);
 	void runScriptOnProcess(RComputeColumnStore * computeColumnStore);
+	void runScriptOnProcess(RTablePageStore * tablePageStore);
 	void runAnalysisOnProcess(Analysis *analysis);
 	void terminateJaspEngine();
 
@@ -42,6 +53,7 @@ public:
 	bool resumed() const { return _engineState != engineState::paused && _engineState != engineState::resuming;	}
 
 	void runModuleRequestOnProcess(Json::Value request);
+	void replayModuleRequests(std::queue<Json::Value> requests);
 
 
 	void process();
@@ -52,44 +64,79 @@ public:
 	void processEnginePausedReply();
 	void processComputeColumnReply(	Json::Value json);
 	void processModuleRequestReply(	Json::Value json);
+	void processTablePageReply(		Json::Value json);
 
-	void setChannel(IPCChannel * channel)			{ _channel = channel; }
 	void setSlaveProcess(QProcess * slaveProcess)	{ _slaveProcess = slaveProcess; }
+	QProcess * slaveProcess()						{ return _slaveProcess; }
 	int channelNumber()								{ return _channel->channelNumber(); }
 
+	///Engines forked from the engine template have no QProcess, just a pid that is known once the template answers
+	void	setForkRequest(int request)				{ _forkRequest = request; _forkedPID = 0; }
+	int		forkRequest()					const	{ return _forkRequest; }
+	void	setForkedPID(qint64 pid)				{ _forkedPID = pid; }
+	qint64	forkedPID()						const	{ return _forkedPID; }
+
+	void restartOnChannel(IPCChannel * channel);
+
 
-	void sendString(std::string str)
+	void sendJson(const Json::Value & json)
 	{
 #ifdef PRINT_ENGINE_MESSAGES
-		std::cout << "sending to jaspEngine: " << str << "\n" << std::endl;
+		std::cout << "sending to jaspEngine: " << json.toStyledString() << "\n" << std::endl;
 #endif
-		_channel->send(str);
+		_channel->send(JsonSerializer::serialize(json, _messageFormat));
+		_watcher->rearm();
+		_lastActivity.restart();
 	}
 
+	int		ppi()				const	{ return _ppi;				}
+	QString	imageBackground()	const	{ return _imageBackground;	}
+	qint64	msecsSinceLastActivity()	{ return _lastActivity.elapsed(); }
+
 	int engineChannelID()							{ return _channel->channelNumber(); }
 
 private:
+	void runNextModuleReplay();
+
 	Analysis::Status analysisResultStatusToAnalysStatus(analysisResultStatus result, Analysis * analysis);
 
-	QProcess*	_slaveProcess		= NULL;
-	IPCChannel*	_channel			= NULL;
-	Analysis*	_analysisInProgress = NULL;
-	engineState	_engineState		= engineState::idle;
-	int			_ppi				= 96;
-	QString		_imageBackground	= "white";
-	bool		_enginePaused		= false;
+	QProcess*			_slaveProcess		= NULL;
+	qint64				_forkedPID			= 0;
+	int					_forkRequest		= -1;
+	IPCChannel*			_channel			= NULL;
+	IPCChannelWatcher*	_watcher			= NULL;
+	Analysis*			_analysisInProgress = NULL;
+	engineState			_engineState		= engineState::idle;
+	int					_ppi				= 96;
+	QString				_imageBackground	= "white";
+	bool				_enginePaused		= false,
+						_replayingModules	= false;
+	QElapsedTimer		_lastActivity,
+						_analysisTimer;
+	performType			_analysisPerform	= performType::run;
+	int					_abortedAnalysisId	= -1;
+	messageFormat		_messageFormat		= messageFormat::json; ///< The engine answers in the format it is sent
+	Json::Value			_scriptRequest		= Json::nullValue; ///< The filter, rCode or computeColumn request that was sent last, so it can still be answered if the engine crashes
+
+	std::queue<Json::Value>	_moduleReplays,
+							_tablePageRequests; ///< Sent and not answered yet, also while an analysis runs on this engine
 
 signals:
+	void messageWaiting();
 	void engineTerminated();
 	void processFilterErrorMsg(QString error, int requestId);
 	void processNewFilterResult(std::vector<bool> filterResult, int requestId);
+	void processFilterResultInDataSet(int requestId);
 	void computeColumnErrorTextChanged(QString error);
 
 	void rCodeReturned(QString result, int requestId);
+	void tablePageReturned(int analysisId, QString tableName, int from, QString rows);
 
 	void computeColumnSucceeded(std::string columnName, std::string warning, bool dataChanged);
 	void computeColumnFailed(std::string columnName, std::string error);
 
+	void analysisRunTime(Analysis * analysis, performType perform, qint64 msecs);
+
 	void moduleInstallationSucceeded(	std::string moduleName);
 	void moduleInstallationFailed(		std::string moduleName, std::string errorMessage);
 	void moduleLoadingSucceeded(		std::string moduleName, int channelID);
@@ -35,9 +35,23 @@
 #include "tempfiles.h"
 #include "timers.h"
 #include "utilities/appdirs.h"
+#include "utilities/settings.h"
+
+#include <thread>
+#include <algorithm>
+
+#ifdef __linux__
+#include <signal.h>
+#endif
 
 using namespace boost::interprocess;
 
+#ifndef JASP_DEBUG
+const size_t EngineSync::initedAnalysesStartIndex = 1; // don't perform 'runs' on process 0, "only" inits & filters & rCode & columnComputes & moduleRequests.
+#else
+const size_t EngineSync::initedAnalysesStartIndex = 0;
+#endif
+
 
 EngineSync::EngineSync(Analyses *analyses, DataSetPackage *package, DynamicModules *dynamicModules, QObject *parent = 0)
 	: QObject(parent), _analyses(analyses), _package(package), _dynamicModules(dynamicModules)
@@ -47,6 +61,7 @@ EngineSync::EngineSync(Analyses *analyses, DataSetPackage *package, DynamicModul
 	connect(_analyses,	&Analyses::analysisSaveImage,						this,					&EngineSync::ProcessAnalysisRequests	);
 	connect(_analyses,	&Analyses::analysisEditImage,						this,					&EngineSync::ProcessAnalysisRequests	);
 	connect(_analyses,	&Analyses::analysisOptionsChanged,					this,					&EngineSync::ProcessAnalysisRequests	);
+	connect(_analyses,	&Analyses::currentAnalysisIndexChanged,				this,					&EngineSync::ProcessAnalysisRequests	);
 	connect(this,		&EngineSync::moduleLoadingFailed,					_dynamicModules,		&DynamicModules::loadingFailed			);
 	connect(this,		&EngineSync::moduleLoadingSucceeded,				_dynamicModules,		&DynamicModules::loadingSucceeded		);
 	connect(this,		&EngineSync::moduleInstallationFailed,				_dynamicModules,		&DynamicModules::installationPackagesFailed		);
@@ -64,6 +79,14 @@ EngineSync::~EngineSync()
 		TempFiles::deleteAll();
 	}
 
+	if(_engineTemplate != nullptr)
+		_engineTemplate->disconnect(this); //It goes down with us, nothing to restart
+
+	if(_engineTemplateWatcher != nullptr)
+		_engineTemplateWatcher->stop();
+
+	delete _engineTemplateChannel;
+
 	shared_memory_object::remove(_memoryName.c_str());
 }
 
@@ -80,28 +103,11 @@ void EngineSync::start()
 	try {
 		_memoryName = "JASP-IPC-" + std::to_string(ProcessInfo::currentPID());
 
-#ifdef JASP_DEBUG
-		_engines.resize(1);
-#else
-		_engines.resize(4);
-#endif
-		for(size_t i=0; i<_engines.size(); i++)
-		{
-			_engines[i] = new EngineRepresentation(new IPCChannel(_memoryName, i), startSlaveProcess(i), this);
-
-			connect(_engines[i],	&EngineRepresentation::engineTerminated,				this,			&EngineSync::engineTerminated		);
-			connect(_engines[i],	&EngineRepresentation::rCodeReturned,					this,			&EngineSync::rCodeReturned			);
-			connect(_engines[i],	&EngineRepresentation::processNewFilterResult,			this,			&EngineSync::processNewFilterResult	);
-			connect(_engines[i],	&EngineRepresentation::processFilterErrorMsg,			this,			&EngineSync::processFilterErrorMsg	);
-			connect(_engines[i],	&EngineRepresentation::computeColumnSucceeded,			this,			&EngineSync::computeColumnSucceeded	);
-			connect(_engines[i],	&EngineRepresentation::computeColumnFailed,				this,			&EngineSync::computeColumnFailed	);
-			connect(this,			&EngineSync::ppiChanged,								_engines[i],	&EngineRepresentation::ppiChanged	);
-			connect(this,			&EngineSync::imageBackgroundChanged,					_engines[i],	&EngineRepresentation::imageBackgroundChanged );
-			connect(_engines[i],	&EngineRepresentation::moduleLoadingFailed,				this,			&EngineSync::moduleLoadingFailedHandler);
-			connect(_engines[i],	&EngineRepresentation::moduleLoadingSucceeded,			this,			&EngineSync::moduleLoadingSucceededHandler);
-			connect(_engines[i],	&EngineRepresentation::moduleInstallationFailed,		this,			&EngineSync::moduleInstallationFailed);
-			connect(_engines[i],	&EngineRepresentation::moduleInstallationSucceeded,		this,			&EngineSync::moduleInstallationSucceeded);
-		}
+		determinePoolSize();
+		startEngineTemplate();
+
+		for(size_t i=0; i<std::min(_maxEngines, _initialEngines); i++)
+			startEngine();
 	}
 	catch (interprocess_exception e)
 	{
@@ -114,18 +120,265 @@ void EngineSync::start()
 	connect(timerProcess,	&QTimer::timeout, this, &EngineSync::process);
 	connect(timerBeat,		&QTimer::timeout, this, &EngineSync::heartbeatTempFiles);
 
-	timerProcess->start(50);
+	timerProcess->start(250); // replies are handled through messageWaiting, this only picks up status changes nobody signals
 	timerBeat->start(30000);
 }
 
+void EngineSync::determinePoolSize()
+{
+	// Engine 0 is reserved for inits, filters, rCode etc so we need at least one more to run analyses on
+#ifdef JASP_DEBUG
+	_minEngines		= 1;
+	_initialEngines	= 1;
+#else
+	_minEngines		= 2;
+	_initialEngines	= 4;
+#endif
+
+	int preferred	= Settings::value(Settings::MAX_ENGINES).toInt();
+	size_t cores	= std::max(1u, std::thread::hardware_concurrency());
+
+	_maxEngines		= std::max(_minEngines, preferred > 0 ? size_t(preferred) : cores - 1); //Leave a core for the GUI
+
+#ifdef JASP_DEBUG
+	std::cout << "EngineSync will keep between " << _minEngines << " and " << _maxEngines << " engines running" << std::endl;
+#endif
+}
+
+EngineRepresentation * EngineSync::startEngine()
+{
+	int no = int(_engines.size());
+
+	EngineRepresentation * engine = new EngineRepresentation(new IPCChannel(_memoryName, no), NULL, this);
+
+	if(!forkFromTemplate(engine))
+		engine->setSlaveProcess(startSlaveProcess(no));
+
+	connect(engine,	&EngineRepresentation::messageWaiting,					this,	&EngineSync::process				);
+	connect(engine,	&EngineRepresentation::engineTerminated,				this,	&EngineSync::engineTerminated		);
+	connect(engine,	&EngineRepresentation::rCodeReturned,					this,	&EngineSync::rCodeReturned			);
+	connect(engine,	&EngineRepresentation::tablePageReturned,				this,	&EngineSync::tablePageReturnedHandler	);
+	connect(engine,	&EngineRepresentation::processNewFilterResult,			this,	&EngineSync::processNewFilterResult	);
+	connect(engine,	&EngineRepresentation::processFilterResultInDataSet,	this,	&EngineSync::processFilterResultInDataSet	);
+	connect(engine,	&EngineRepresentation::processFilterErrorMsg,			this,	&EngineSync::processFilterErrorMsg	);
+	connect(engine,	&EngineRepresentation::computeColumnSucceeded,			this,	&EngineSync::computeColumnSucceeded	);
+	connect(engine,	&EngineRepresentation::computeColumnFailed,				this,	&EngineSync::computeColumnFailed	);
+	connect(engine,	&EngineRepresentation::analysisRunTime,					this,	&EngineSync::analysisRunTimeHandler	);
+	connect(this,	&EngineSync::ppiChanged,								engine,	&EngineRepresentation::ppiChanged	);
+	connect(this,	&EngineSync::imageBackgroundChanged,					engine,	&EngineRepresentation::imageBackgroundChanged );
+	connect(engine,	&EngineRepresentation::moduleLoadingFailed,				this,	&EngineSync::moduleLoadingFailedHandler);
+	connect(engine,	&EngineRepresentation::moduleLoadingSucceeded,			this,	&EngineSync::moduleLoadingSucceededHandler);
+	connect(engine,	&EngineRepresentation::moduleInstallationFailed,		this,	&EngineSync::moduleInstallationFailed);
+	connect(engine,	&EngineRepresentation::moduleInstallationSucceeded,		this,	&EngineSync::moduleInstallationSucceeded);
+
+	if(_engines.size() > 0) //Engines started later on should render just like the others
+	{
+		engine->ppiChanged(				_engines[0]->ppi());
+		engine->imageBackgroundChanged(	_engines[0]->imageBackground());
+	}
+
+	_engines.push_back(engine);
+
+	replayLoadedModules(engine);
+
+	return engine;
+}
+
+///Engines started later on (or again) also need the modules that were loaded before they existed
+void EngineSync::replayLoadedModules(EngineRepresentation * engine)
+{
+	std::queue<Json::Value> modules;
+	for(const auto & nameRequest : _loadedModuleRequests)
+		if(_dynamicModules->dynamicModule(nameRequest.first) != NULL)
+			modules.push(nameRequest.second);
+
+	engine->replayModuleRequests(modules);
+}
+
+///On linux one engine process, the template, initializes R and all other engines are forked from that. See Engine::runAsTemplate()
+void EngineSync::startEngineTemplate()
+{
+#ifdef __linux__
+	_engineTemplateChannel	= new IPCChannel(_memoryName + "-Template", 0);
+	_engineTemplateWatcher	= new IPCChannelWatcher(_engineTemplateChannel, this);
+	_engineTemplate			= startSlaveProcess(-1);
+
+	//Losing the template is not fatal, the engines are then simply started the slow way
+	disconnect(_engineTemplate, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),	this,	&EngineSync::subprocessFinished);
+	disconnect(_engineTemplate, &QProcess::errorOccurred,										this,	&EngineSync::subProcessError);
+	connect(_engineTemplate,	QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),	this,	&EngineSync::engineTemplateStopped);
+	connect(_engineTemplate,	&QProcess::errorOccurred,										this,	&EngineSync::engineTemplateStopped);
+
+	connect(_engineTemplateWatcher, &IPCChannelWatcher::messageWaiting, this, &EngineSync::process);
+	_engineTemplateWatcher->start();
+#endif
+}
+
+void EngineSync::engineTemplateStopped()
+{
+	if(_engineTemplateChannel == nullptr) //finished and errorOccurred can both arrive
+		return;
+
+	std::cout << "The engine template stopped, engines are started without it from now on" << std::endl;
+
+	processEngineTemplate(); //Whatever it managed to fork or reap before it went
+
+	_engineTemplateWatcher->stop();
+	delete _engineTemplateWatcher;
+	delete _engineTemplateChannel;
+
+	_engineTemplateWatcher	= nullptr;
+	_engineTemplateChannel	= nullptr;
+
+	_engineTemplate->disconnect(this);
+	_engineTemplate->deleteLater();
+	_engineTemplate			= nullptr;
+
+	for(auto * engine : _engines)
+		if(engine->forkedPID() > 0) //Its workers check for their parent so they are on their way out as well
+		{
+#ifdef __linux__
+			::kill(pid_t(engine->forkedPID()), SIGKILL);
+#endif
+			restartCrashedEngine(engine);
+		}
+		else if(engine->forkRequest() >= 0 && engine->slaveProcess() == NULL) //Still waiting for a fork that will never come
+		{
+			engine->setForkRequest(-1);
+			engine->setSlaveProcess(startSlaveProcess(engine->channelNumber()));
+		}
+}
+
+bool EngineSync::forkFromTemplate(EngineRepresentation * engine)
+{
+	if(_engineTemplateChannel == nullptr)
+		return false;
+
+	Json::Value request(Json::objectValue);
+
+	request["fork"]		= engine->channelNumber();
+	request["request"]	= ++_forkRequests;
+
+	engine->setForkRequest(_forkRequests);
+	_engineTemplateChannel->send(JsonSerializer::compact(request));
+
+	return true;
+}
+
+void EngineSync::processEngineTemplate()
+{
+	if(_engineTemplateChannel == nullptr)
+		return;
+
+	Json::Value reply;
+
+	while(_engineTemplateChannel->receive([&](const char * message, size_t size) { JsonSerializer::parse(message, size, reply); }))
+	{
+		qint64 pid = reply.get("pid", -1).asInt();
+
+		if(reply.isMember("forked"))
+		{
+			int						request	= reply.get("request", -1).asInt();
+			EngineRepresentation *	engine	= NULL;
+
+			for(auto * e : _engines)
+				if(e->forkRequest() == request)
+					engine = e;
+
+			if(engine == NULL)
+			{
+#ifdef __linux__
+				if(pid > 0)
+					::kill(pid_t(pid), SIGKILL); //It was retired before it even got here
+#endif
+			}
+			else if(pid > 0)
+				engine->setForkedPID(pid);
+			else
+				engine->setSlaveProcess(startSlaveProcess(engine->channelNumber())); //Forking failed, so do it the slow way
+		}
+		else if(reply.isMember("exited"))
+		{
+			for(auto * engine : _engines)
+				if(pid > 0 && engine->forkedPID() == pid) //Retired engines are not in _engines anymore, so this one crashed
+				{
+					std::cout << "Engine " << engine->channelNumber() << " stopped unexpectedly (status " << reply.get("status", 0).asInt() << "), it is restarted from the template" << std::endl;
+					restartCrashedEngine(engine);
+				}
+		}
+
+		reply = Json::nullValue;
+	}
+
+	_engineTemplateWatcher->rearm();
+}
+
+void EngineSync::restartCrashedEngine(EngineRepresentation * engine)
+{
+	int no = engine->channelNumber();
+
+	engine->restartOnChannel(new IPCChannel(_memoryName, no));
+
+	if(!forkFromTemplate(engine))
+		engine->setSlaveProcess(startSlaveProcess(no));
+
+	if(amICastingAModuleRequestWide() && _requestWideCastModuleResults.count(no) == 0)
+		moduleLoadingFailedHandler(_requestWideCastModuleName, "engine crashed", no);
+
+	replayLoadedModules(engine);
+
+	finishAllTablePageFetches();
+}
+
+bool EngineSync::canStartEngine()
+{
+	return _engines.size() < _maxEngines && allEnginesResumed();
+}
+
+void EngineSync::retireIdleEngines()
+{
+	// Only the last one is retired so that the channelnumbers stay equal to the indices
+	while(_engines.size() > _minEngines && allEnginesResumed() && !amICastingAModuleRequestWide())
+	{
+		EngineRepresentation * engine = _engines.back();
+
+		if(!engine->isIdle() || engine->msecsSinceLastActivity() < _engineIdleTimeout)
+			return;
+
+#ifdef JASP_DEBUG
+		std::cout << "Retiring idle engine " << engine->channelNumber() << std::endl;
+#endif
+
+		_engines.pop_back();
+
+		QProcess * slave = engine->slaveProcess(); //NULL when it was forked from the template, then the representation kills it
+
+		if(slave)
+			slave->disconnect(this); //It is supposed to finish now, so nothing to report
+
+		delete engine;
+
+		if(slave)
+			slave->deleteLater();
+	}
+}
+
+void EngineSync::scheduleProcess()
+{
+	if(_engineStarted)
+		QTimer::singleShot(0, this, &EngineSync::process);
+}
+
 void EngineSync::process()
 {
+	processEngineTemplate();
+
 	for (auto engine : _engines)
 		engine->process();
 	
-	processScriptQueue();
 	processDynamicModules();
 	ProcessAnalysisRequests();
+	retireIdleEngines();
 }
 
 void EngineSync::sendFilter(QString generatedFilter, QString filter, int requestID)
@@ -137,29 +390,115 @@ void EngineSync::sendFilter(QString generatedFilter, QString filter, int request
 #endif
 
 		_waitingFilter = new RFilterStore(generatedFilter, filter, requestID); //There is no point in having more then one waiting filter is there?
+		scheduleProcess();
 	}
 }
 
 void EngineSync::sendRCode(QString rCode, int requestId)
 {
-	_waitingScripts.push(new RScriptStore(requestId, rCode));
+	_waitingScripts.push_back(new RScriptStore(requestId, rCode));
+	scheduleProcess();
 }
 
-void EngineSync::computeColumn(QString columnName, QString computeCode, Column::ColumnType columnType)
+void EngineSync::requestTablePage(int analysisId, QString tableName, int from, int count)
 {
-	//first we remove the previously sent requests!
-	std::queue<RScriptStore*> copiedWaiting(_waitingScripts);
-	_waitingScripts = std::queue<RScriptStore*>() ;
+	for(auto * engine : _engines)
+		if(engine->analysisInProgress() != NULL && int(engine->analysisInProgress()->id()) == analysisId)
+		{
+			//Only the engine running it has these rows right now, it answers in between
+			RTablePageStore page(analysisId, tableName, from, count);
+			engine->runScriptOnProcess(&page);
+			return;
+		}
+
+	_waitingScripts.push_back(new RTablePageStore(analysisId, tableName, from, count));
+	scheduleProcess();
+}
+
+void EngineSync::tablePageReturnedHandler(int analysisId, QString tableName, int from, QString rows)
+{
+	Analysis * analysis = _analyses->get(size_t(analysisId));
 
-	while(copiedWaiting.size() > 0)
+	if(analysis != nullptr) //The results are saved from here, so they should have the rows the results page has
 	{
-		RScriptStore * cur = copiedWaiting.front();
-		if(cur->typeScript != engineState::computeColumn || static_cast<RComputeColumnStore*>(cur)->columnName != columnName)
-			_waitingScripts.push(cur);
-		copiedWaiting.pop();
+		Json::Value rowsJson;
+		Json::Reader().parse(fq(rows), rowsJson);
+
+		analysis->insertTablePage(fq(tableName), from, rowsJson);
 	}
 
-	_waitingScripts.push(new RComputeColumnStore(columnName, computeCode, columnType));
+	emit tablePageReturned(analysisId, tableName, from, rows);
+
+	std::vector<int> fetched;
+
+	for(auto & fetch : _tablePageFetches)
+		if(fetch.second.missing.erase(std::make_pair(analysisId, fq(tableName))) > 0 && fetch.second.missing.size() == 0)
+			fetched.push_back(fetch.first);
+
+	for(int fetchId : fetched)
+		finishTablePageFetch(fetchId);
+}
+
+///Saving, exporting and copying need every row of the paged tables, so the rows that were not loaded yet are requested and whenFetched is called once they are all in.
+void EngineSync::fetchTablePages(int analysisId, std::function<void()> whenFetched)
+{
+	TablePageFetch fetch;
+	fetch.whenFetched = whenFetched;
+
+	auto requestMissing = [&](Analysis * analysis)
+	{
+		for(const auto & missing : analysis->pagedTablesMissingRows())
+		{
+			fetch.missing.insert(std::make_pair(int(analysis->id()), missing.first));
+			requestTablePage(int(analysis->id()), tq(missing.first), missing.second.first, missing.second.second - missing.second.first);
+		}
+	};
+
+	if(analysisId < 0)
+		_analyses->applyToAll(requestMissing);
+	else if(Analysis * analysis = _analyses->get(size_t(analysisId)))
+		requestMissing(analysis);
+
+	if(fetch.missing.size() == 0)
+	{
+		whenFetched();
+		return;
+	}
+
+	int fetchId = ++_tablePageFetchCounter;
+	_tablePageFetches[fetchId] = fetch;
+
+	QTimer::singleShot(_tablePageFetchTimeout, this, [this, fetchId]() { finishTablePageFetch(fetchId); });
+}
+
+void EngineSync::finishTablePageFetch(int fetchId)
+{
+	if(_tablePageFetches.count(fetchId) == 0) //Already done
+		return;
+
+	std::function<void()> whenFetched = _tablePageFetches[fetchId].whenFetched;
+	_tablePageFetches.erase(fetchId);
+
+	whenFetched();
+}
+
+///When an engine stops the pages it was asked for will not come anymore, so everyone waiting goes on with the rows that are there
+void EngineSync::finishAllTablePageFetches()
+{
+	while(_tablePageFetches.size() > 0)
+		finishTablePageFetch(_tablePageFetches.begin()->first);
+}
+
+void EngineSync::computeColumn(QString columnName, QString computeCode, Column::ColumnType columnType)
+{
+	//first we remove the previously sent requests!
+	_waitingScripts.erase(std::remove_if(_waitingScripts.begin(), _waitingScripts.end(), [&](RScriptStore * cur)
+	{
+		return cur->typeScript == engineState::computeColumn && static_cast<RComputeColumnStore*>(cur)->columnName == columnName;
+	}), _waitingScripts.end());
+
+	_waitingScripts.push_back(new RComputeColumnStore(columnName, computeCode, columnType));
+	scheduleProcess();
 }
 
 void EngineSync::processScriptQueue()
@@ -170,25 +509,34 @@ void EngineSync::processScriptQueue()
 			if(_waitingScripts.size() == 0 && _waitingFilter == nullptr)
 				return;
 
-			if(_waitingFilter != nullptr)
+			if(_waitingFilter != nullptr && !filterRunning()) //There is only one pending filter in the DataSet, so only one engine may write to it at a time
 			{
 				engine->runScriptOnProcess(_waitingFilter);
 				_waitingFilter = nullptr;
+				countDispatch(schedulePriority::interactiveScript, "filter", engine);
 			}
-			else
+			else if(_waitingScripts.size() > 0)
 			{
+				// rCode and table pages are waited for by the user so they go before computed columns, which keep their order among themselves
+				auto next = std::find_if(_waitingScripts.begin(), _waitingScripts.end(), [](RScriptStore * cur) { return cur->typeScript == engineState::rCode || cur->typeScript == engineState::tablePage; });
+
+				if(next == _waitingScripts.end())
+					next = _waitingScripts.begin();
 
-				RScriptStore * waiting = _waitingScripts.front();
+				RScriptStore * waiting = *next;
 
 				switch(waiting->typeScript)
 				{
 				case engineState::rCode:			engine->runScriptOnProcess(waiting);						break;
-				case engineState::filter:			engine->runScriptOnProcess((RFilterStore*)waiting);			break;
 				case engineState::computeColumn:	engine->runScriptOnProcess((RComputeColumnStore*)waiting);	break;
+				case engineState::tablePage:		engine->runScriptOnProcess((RTablePageStore*)waiting);		break;
 				default:							throw std::runtime_error("engineState " + engineStateToString(waiting->typeScript) + " unknown in EngineSync::processScriptQueue()!");
 				}
 
-				_waitingScripts.pop();
+				if(waiting->typeScript == engineState::computeColumn)	countDispatch(schedulePriority::computeColumn,		((RComputeColumnStore*)waiting)->columnName.toStdString(),	engine);
+				else													countDispatch(schedulePriority::interactiveScript,	engineStateToString(waiting->typeScript),					engine);
+
+				_waitingScripts.erase(next);
 				delete waiting; //clean up
 			}
 		}
@@ -212,6 +560,14 @@ void EngineSync::processDynamicModules()
 		}
 }
 
+bool EngineSync::filterRunning()
+{
+	for(auto engine : _engines)
+		if(engine->isRunningFilter())
+			return true;
+	return false;
+}
+
 bool EngineSync::idleEngineAvailable()
 {
 	for(auto engine : _engines)
@@ -221,40 +577,153 @@ bool EngineSync::idleEngineAvailable()
 }
 
 void EngineSync::ProcessAnalysisRequests()
-{	
-	const size_t initedAnalysesStartIndex =
-#ifndef JASP_DEBUG
-			1; // don't perform 'runs' on process 0, "only" inits & filters & rCode & columnComputes & moduleRequests.
-#else
-			0;
-#endif
-
+{
 	for(auto engine : _engines)
 		engine->handleRunningAnalysisStatusChanges();
 
-	_analyses->applyToSome([&](Analysis * analysis)
-	{
-		if(!idleEngineAvailable())
-			return false;
+	runWaitingAnalyses(schedulePriority::selectedAnalysis);
+	processScriptQueue();
+	runWaitingAnalyses(schedulePriority::backgroundAnalysis);
+}
 
-		if (analysis == NULL || analysis->isWaitingForModule())
-			return true;
+schedulePriority EngineSync::priorityOf(Analysis * analysis)
+{
+	// Saving or editing an image is something the user is waiting for right now
+	if(analysis == _analyses->currentAnalysis() || analysis->isSaveImg() || analysis->isEditImg())
+		return schedulePriority::selectedAnalysis;
+
+	return schedulePriority::backgroundAnalysis;
+}
+
+std::string EngineSync::runTimeKey(Analysis * analysis, performType perform)
+{
+	return analysis->module() + "/" + analysis->name() + "/" + performTypeToString(perform);
+}
+
+qint64 EngineSync::estimatedRunTime(Analysis * analysis)
+{
+	auto estimate = _runTimeEstimates.find(runTimeKey(analysis, analysis->desiredPerformTypeFromAnalysisStatus()));
+
+	if(estimate == _runTimeEstimates.end())
+		return _defaultRunTimeEstimate;
+
+	return estimate->second;
+}
+
+void EngineSync::analysisRunTimeHandler(Analysis * analysis, performType perform, qint64 msecs)
+{
+	std::string key = runTimeKey(analysis, perform);
+
+	if(_runTimeEstimates.count(key) == 0)	_runTimeEstimates[key] = msecs;
+	else									_runTimeEstimates[key] = (_runTimeEstimates[key] * 3 + msecs) / 4; //Moving average, options change the run time as well
+}
+
+void EngineSync::runWaitingAnalyses(schedulePriority priority)
+{
+	std::vector<std::pair<qint64, Analysis*>> waiting;
+
+	_analyses->applyToAll([&](Analysis * analysis)
+	{
+		if (analysis == NULL || analysis->isWaitingForModule() || priorityOf(analysis) != priority)
+			return;
 
 		bool canUseFirstEngine	= analysis->isEmpty()	|| analysis->isSaveImg() || analysis->isEditImg();
 		bool needsToRun			= canUseFirstEngine		|| analysis->isInited();
 
 		if(needsToRun)
-			for (size_t i = canUseFirstEngine ? 0 : initedAnalysesStartIndex; i<_engines.size(); i++)
-				if (_engines[i]->isIdle())
-				{
-					_engines[i]->runAnalysisOnProcess(analysis);
-					break;
-				}
-
-		return true;
+			waiting.push_back(std::make_pair(estimatedRunTime(analysis), analysis));
 	});
 
+	//Shortest first, that way a bootstrap doesn't keep all the quick ones waiting
+	std::stable_sort(waiting.begin(), waiting.end(), [](const std::pair<qint64, Analysis*> & l, const std::pair<qint64, Analysis*> & r) { return l.first < r.first; });
+
+	for(auto & estimateAnalysis : waiting)
+	{
+		Analysis * analysis = estimateAnalysis.second;
+
+		if(!idleEngineAvailable() && !canStartEngine() && priority != schedulePriority::selectedAnalysis)
+			return;
+
+		bool	canUseFirstEngine	= analysis->isEmpty() || analysis->isSaveImg() || analysis->isEditImg();
+		size_t	firstEngine			= canUseFirstEngine ? 0 : initedAnalysesStartIndex;
+
+		EngineRepresentation * engine = nullptr;
+
+		for (size_t i = firstEngine; i<_engines.size() && engine == nullptr; i++)
+			if (_engines[i]->isIdle())
+				engine = _engines[i];
 
+		if(engine == nullptr && canStartEngine())
+		{
+			engine = startEngine();
+			_schedulerStatistics.enginesStarted++;
+
+			if(!engine->isIdle()) //Still loading modules, it'll pick up work once that is done
+				engine = nullptr;
+		}
+
+		if(engine == nullptr && priority == schedulePriority::selectedAnalysis)
+			engine = preemptFor(analysis, firstEngine);
+
+		if(engine != nullptr)
+		{
+			engine->runAnalysisOnProcess(analysis);
+			countDispatch(priority, analysis->name(), engine, estimateAnalysis.first);
+		}
+	}
+}
+
+EngineRepresentation * EngineSync::preemptFor(Analysis * analysis, size_t firstEngine)
+{
+	EngineRepresentation	* victim		= nullptr;
+	qint64					wantedRunTime	= estimatedRunTime(analysis);
+
+	for (size_t i = firstEngine; i<_engines.size(); i++)
+	{
+		Analysis * running = _engines[i]->analysisInProgress();
+
+		if(running == nullptr || priorityOf(running) != schedulePriority::backgroundAnalysis || (running->status() != Analysis::Running && running->status() != Analysis::Initing))
+			continue;
+
+		//If it will probably be done before the selected one would be, just wait for it
+		if(estimatedRunTime(running) - _engines[i]->msecsAnalysisRunning() < wantedRunTime)
+			continue;
+
+		//Throw away as little work as possible
+		if(victim == nullptr || _engines[i]->msecsAnalysisRunning() < victim->msecsAnalysisRunning())
+			victim = _engines[i];
+	}
+
+	if(victim == nullptr)
+		return nullptr;
+
+	Analysis			*	preempted	= victim->analysisInProgress();
+	Analysis::Status		rerunAs		= preempted->status() == Analysis::Initing ? Analysis::Empty : Analysis::Inited;
+
+#ifdef JASP_DEBUG
+	std::cout << "Scheduler preempts " << preempted->name() << " (" << preempted->id() << ") on engine " << victim->channelNumber() << " for " << analysis->name() << " (" << analysis->id() << ")" << std::endl;
+#endif
+
+	victim->abortAnalysisInProgress();
+	preempted->setStatus(rerunAs); //So that it gets scheduled again as soon as there is room
+
+	_schedulerStatistics.preempted++;
+
+	return victim->isIdle() ? victim : nullptr;
+}
+
+void EngineSync::countDispatch(schedulePriority priority, const std::string & what, EngineRepresentation * engine, qint64 estimate)
+{
+	_schedulerStatistics.dispatched[priority]++;
+
+#ifdef JASP_DEBUG
+	std::cout << "Scheduler sends " << schedulePriorityToString(priority) << " " << what << " to engine " << engine->channelNumber();
+	if(estimate >= 0)
+		std::cout << " (estimated " << estimate << "ms)";
+	std::cout << std::endl;
+#else
+	(void)what; (void)engine; (void)estimate;
+#endif
 }
 
 QProcess * EngineSync::startSlaveProcess(int no)
@@ -264,7 +733,7 @@ QProcess * EngineSync::startSlaveProcess(int no)
 	QString engineExe		= QFileInfo( QCoreApplication::applicationFilePath() ).absoluteDir().absoluteFilePath("JASPEngine");
 
 	QStringList args;
-	args << QString::number(no) << QString::number(ProcessInfo::currentPID());
+	args << (no < 0 ? QString("template") : QString::number(no)) << QString::number(ProcessInfo::currentPID()); //-1 is the engine template
 
 	env.insert("TMPDIR", tq(TempFiles::createTmpFolder()));
 
@@ -401,6 +870,7 @@ void EngineSync::subProcessStarted()
 void EngineSync::subProcessError(QProcess::ProcessError error)
 {
 	emit engineTerminated();
+	finishAllTablePageFetches();
 
 	qDebug() << "subprocess error" << error;
 }
@@ -408,6 +878,7 @@ void EngineSync::subProcessError(QProcess::ProcessError error)
 void EngineSync::subprocessFinished(int exitCode, QProcess::ExitStatus)
 {
 	emit engineTerminated();
+	finishAllTablePageFetches();
 
 	qDebug() << "subprocess finished" << exitCode;
 }
@@ -422,8 +893,11 @@ void EngineSync::pause()
 		e->pauseEngine();
 
 	while(!allEnginesPaused())
+	{
+		processEngineTemplate(); //An engine that crashes now would otherwise be waited for forever
 		for (auto engine : _engines)
 			engine->process();
+	}
 }
 
 void EngineSync::resume()
@@ -432,8 +906,11 @@ void EngineSync::resume()
 		engine->resumeEngine();
 
 	while(!allEnginesResumed())
+	{
+		processEngineTemplate();
 		for (auto * engine : _engines)
 			engine->process();
+	}
 }
 
 bool EngineSync::allEnginesPaused()
@@ -499,6 +976,8 @@ void EngineSync::checkModuleWideCastDone()
 		}
 
 
+		if(failed == 0)	_loadedModuleRequests[_requestWideCastModuleName] = _requestWideCastModuleJson;
+
 		if(failed == 0)	emit moduleLoadingSucceeded(_requestWideCastModuleName);
 		else			emit moduleLoadingFailed(_requestWideCastModuleName, compoundedError);
 
@@ -26,8 +26,11 @@
 #endif
 
 #include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <functional>
+#include <set>
 
 #include "enginerepresentation.h"
+#include "scheduledefines.h"
 
 /* EngineSync is responsible for launching the background
  * processes, scheduling analyses, and for sending and
@@ -46,21 +49,35 @@ public:
 	void start();
 	bool engineStarted()			{ return _engineStarted; }
 
+	struct SchedulerStatistics
+	{
+		std::map<schedulePriority, size_t>	dispatched;
+		size_t								preempted		= 0,
+											enginesStarted	= 0;
+	};
+
+	const SchedulerStatistics & schedulerStatistics() const { return _schedulerStatistics; }
+
+	void fetchTablePages(int analysisId, std::function<void()> whenFetched); ///< Requests the rows the paged tables of analysisId (or of all analyses for -1) still miss and calls whenFetched once they arrived, an engine stopped or it took too long
+
 public slots:
 	void sendFilter(QString generatedFilter, QString filter, int requestID);
 	void sendRCode(QString rCode, int requestId);
 	void computeColumn(QString columnName, QString computeCode, Column::ColumnType columnType);
+	void requestTablePage(int analysisId, QString tableName, int from, int count);
 	void pause();
 	void resume();
 	
 signals:
 	void processNewFilterResult(std::vector<bool> filterResult, int requestID);
+	void processFilterResultInDataSet(int requestID);
 	void processFilterErrorMsg(QString error, int requestID);
 	void engineTerminated();
 	void filterUpdated(int requestID);
 	void filterErrorTextChanged(QString error);
 
 	void rCodeReturned(QString result, int requestId);
+	void tablePageReturned(int analysisId, QString tableName, int from, QString rows);
 
 	void ppiChanged(int newPPI);
 	void imageBackgroundChanged(QString value);
@@ -73,15 +90,37 @@ signals:
 	void moduleLoadingFailed(			std::string moduleName, std::string errorMessage);
 
 private:
+	void					determinePoolSize();
+	EngineRepresentation*	startEngine();
+	bool					canStartEngine();
+	void					retireIdleEngines();
+	void					replayLoadedModules(EngineRepresentation * engine);
+
+	void					startEngineTemplate();
+	bool					forkFromTemplate(EngineRepresentation * engine);
+	void					processEngineTemplate();
+	void					restartCrashedEngine(EngineRepresentation * engine);
+
+	void					runWaitingAnalyses(schedulePriority priority);
+	EngineRepresentation*	preemptFor(Analysis * analysis, size_t firstEngine);
+	schedulePriority		priorityOf(Analysis * analysis);
+	qint64					estimatedRunTime(Analysis * analysis);
+	std::string				runTimeKey(Analysis * analysis, performType perform);
+	void					countDispatch(schedulePriority priority, const std::string & what, EngineRepresentation * engine, qint64 estimate = -1);
+
 	bool		idleEngineAvailable();
+	bool		filterRunning();
 	bool		allEnginesPaused();
 	bool		allEnginesResumed();
 	QProcess*	startSlaveProcess(int no);
 	void		processScriptQueue();
+	void		scheduleProcess();
 	void		processDynamicModules();
 	void		checkModuleWideCastDone();
 	void		resetModuleWideCastVars();
 	bool		amICastingAModuleRequestWide()	{ return !_requestWideCastModuleJson.isNull(); }
+	void		finishTablePageFetch(int fetchId);
+	void		finishAllTablePageFetches();
 
 private slots:
 	void ProcessAnalysisRequests();
@@ -95,9 +134,13 @@ private slots:
 	void subProcessStarted();
 	void subProcessError(QProcess::ProcessError error);
 	void subprocessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+	void engineTemplateStopped();
+
+	void tablePageReturnedHandler(int analysisId, QString tableName, int from, QString rows);
 
 	void moduleLoadingFailedHandler(		std::string moduleName, std::string errorMessage, int channelID);
 	void moduleLoadingSucceededHandler(		std::string moduleName, int channelID);
+	void analysisRunTimeHandler(			Analysis * analysis, performType perform, qint64 msecs);
 
 private:
 	Analyses		*_analyses;
@@ -105,8 +148,12 @@ private:
 	DataSetPackage	*_package;
 	DynamicModules	*_dynamicModules = nullptr;;
 
-	std::queue<RScriptStore*>			_waitingScripts;
+	std::deque<RScriptStore*>			_waitingScripts;
 	std::vector<EngineRepresentation*>	_engines;
+	size_t								_minEngines		= 1,
+										_maxEngines		= 1,
+										_initialEngines	= 1;
+	static const qint64					_engineIdleTimeout = 300000; //ms before an engine above _minEngines is stopped again
 	RFilterStore						*_waitingFilter = nullptr;
 
 	std::string _memoryName,
@@ -115,6 +162,28 @@ private:
 	std::string					_requestWideCastModuleName	= "";
 	Json::Value					_requestWideCastModuleJson	= Json::nullValue;
 	std::map<int, std::string>	_requestWideCastModuleResults;
+	std::map<std::string, Json::Value>	_loadedModuleRequests; //Replayed on engines started after the module was loaded
+
+	QProcess			*	_engineTemplate			= nullptr; ///< Linux only, initializes R once so that the engines can be forked from it
+	IPCChannel			*	_engineTemplateChannel	= nullptr;
+	IPCChannelWatcher	*	_engineTemplateWatcher	= nullptr;
+	int						_forkRequests			= 0;
+
+	struct TablePageFetch
+	{
+		std::set<std::pair<int, std::string>>	missing; //analysisId and tableName of the pages not yet returned
+		std::function<void()>					whenFetched;
+	};
+
+	std::map<int, TablePageFetch>	_tablePageFetches;
+	int								_tablePageFetchCounter	= 0;
+	static const int				_tablePageFetchTimeout	= 10000; //ms before copying or exporting goes on without the missing rows
+
+	std::map<std::string, qint64>	_runTimeEstimates; //per module/analysis/performType in ms
+	SchedulerStatistics				_schedulerStatistics;
+
+	static const qint64				_defaultRunTimeEstimate = 1000;
+	static const size_t				initedAnalysesStartIndex;
 };
 
 #endif // ENGINESYNC_H
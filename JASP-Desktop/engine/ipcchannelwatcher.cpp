@@ -0,0 +1,47 @@
+#include "ipcchannelwatcher.h"
+
+IPCChannelWatcher::IPCChannelWatcher(IPCChannel * channel, QObject * parent)
+	: QThread(parent), _channel(channel)
+{
+}
+
+IPCChannelWatcher::~IPCChannelWatcher()
+{
+	stop();
+}
+
+void IPCChannelWatcher::stop()
+{
+	requestInterruption();
+	rearm();
+	wait();
+}
+
+void IPCChannelWatcher::rearm()
+{
+	QMutexLocker lock(&_mutex);
+	_notified = false;
+	_rearmed.wakeAll();
+}
+
+void IPCChannelWatcher::run()
+{
+	while(!isInterruptionRequested())
+	{
+		{
+			QMutexLocker lock(&_mutex);
+			while(_notified && !isInterruptionRequested())
+				_rearmed.wait(&_mutex, _waitTimeout);
+		}
+
+		if(isInterruptionRequested() || !_channel->waitForMessage(_waitTimeout))
+			continue;
+
+		{
+			QMutexLocker lock(&_mutex);
+			_notified = true;
+		}
+
+		emit messageWaiting();
+	}
+}
@@ -0,0 +1,42 @@
+#ifndef IPCCHANNELWATCHER_H
+#define IPCCHANNELWATCHER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include "ipcchannel.h"
+
+/* IPCChannelWatcher blocks on the incoming semaphore of an IPCChannel
+ * in its own thread and emits messageWaiting() as soon as the engine
+ * posts something. The message itself is left in the channel so that
+ * EngineRepresentation::process() can receive it on the main thread.
+ * After notifying it parks until rearm() is called, which happens
+ * whenever a message is received from or sent to the engine.
+ */
+class IPCChannelWatcher : public QThread
+{
+	Q_OBJECT
+
+public:
+	IPCChannelWatcher(IPCChannel * channel, QObject * parent = NULL);
+	~IPCChannelWatcher();
+
+	void rearm();
+	void stop();
+
+signals:
+	void messageWaiting();
+
+protected:
+	void run() override;
+
+private:
+	IPCChannel		*_channel;
+	QMutex			_mutex;
+	QWaitCondition	_rearmed;
+	bool			_notified = false;
+
+	static const int _waitTimeout = 100; //ms, only limits how long stop() takes
+};
+
+#endif // IPCCHANNELWATCHER_H
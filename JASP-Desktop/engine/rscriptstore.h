@@ -33,4 +33,14 @@ struct RComputeColumnStore : public RScriptStore
 	Column::ColumnType	columnType;
 };
 
+struct RTablePageStore : public RScriptStore
+{
+	RTablePageStore(int analysisId, QString tableName, int from, int count) : RScriptStore(-1, tableName, engineState::tablePage), analysisId(analysisId), from(from), count(count)
+	{ }
+
+	int analysisId,
+		from,
+		count;
+};
+
 #endif // RSCRIPTSTORE_H
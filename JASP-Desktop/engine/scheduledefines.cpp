@@ -0,0 +1,2 @@
+#define ENUM_DECLARATION_CPP
+#include "scheduledefines.h"
@@ -0,0 +1,9 @@
+#ifndef SCHEDULEDEFINES_H
+#define SCHEDULEDEFINES_H
+
+#include "enumutilities.h"
+
+///Classes of work EngineSync hands out to the engines, most urgent first
+DECLARE_ENUM(schedulePriority, selectedAnalysis, interactiveScript, computeColumn, backgroundAnalysis);
+
+#endif // SCHEDULEDEFINES_H
@@ -6,7 +6,8 @@ JASPWidgets.Analysis = Backbone.Model.extend({
 		status: 'waiting',
 		optionschanged: [],
 		saveimage: [],
-		editimage: []
+		editimage: [],
+		tablepage: []
 	}
 });
 
@@ -111,6 +112,10 @@ JASPWidgets.AnalysisView = JASPWidgets.View.extend({
             this.trigger("editimage", this.model.get("id"), options)
         }, this);
 
+		this.model.on("TablePage:requested", function (tableName, from, count) {
+			this.trigger("tablepage", this.model.get("id"), tableName, from, count)
+		}, this);
+
 		this.$el.on("changed:userData", this, this.onUserDataChanged);
 	},
 
@@ -554,6 +559,17 @@ JASPWidgets.AnalysisView = JASPWidgets.View.extend({
 		return itemView;
 	},
 
+	renderProgressbar: function () {
+
+		var progress = this.model.get("progress");
+		if (progress > -1) {  // called to update progressbar
+			var $progressbar = this.progressbar.init(progress, this.model.get("id"), this.model.get("status"));
+			this.$el.find(".jasp-progressbar-container").replaceWith($progressbar);
+			this.handleVisibilityProgressbar(this.progressbar.status());
+		}
+		return this;
+	},
+
 	render: function () {
 
 		if (this.imageToEdit != null) { // we only want to re-render adjusted images
@@ -564,15 +580,8 @@ JASPWidgets.AnalysisView = JASPWidgets.View.extend({
 		}
 
 		var results = this.model.get("results");
-		if (results == "" || results == null) {
-			var progress = this.model.get("progress");
-			if (progress > -1) {  // called to update progressbar
-				var $progressbar = this.progressbar.init(progress, this.model.get("id"), this.model.get("status"));
-				this.$el.find(".jasp-progressbar-container").replaceWith($progressbar);
-				this.handleVisibilityProgressbar(this.progressbar.status());
-			}
-			return this;
-		}
+		if (results == "" || results == null)
+			return this.renderProgressbar();
 		
 		this.toolbar.$el.detach();
 		this.detachNotes();
@@ -527,8 +527,15 @@ $(document).ready(function () {
 
             });
 
+			jaspWidget.on("tablepage", function (id, tableName, from, count) {
+
+				jasp.requestTablePage(id, tableName, from, count)
+
+			});
+
 			jaspWidget.on("toolbar:showMenu", function (obj, options) {
 
+				options.analysisId = analysis.id;
 				jasp.showAnalysesMenu(JSON.stringify(options));
 				window.menuObject = obj;
 			});
@@ -547,6 +554,129 @@ $(document).ready(function () {
 		jaspWidget.render();
 	}
 	
+	// Returns the object holding the last name of path, jaspResults has its objects as members and containers have them in their collection
+	var resultsMembersAt = function (results, path, createMissing) {
+
+		var members = results
+
+		for (var i = 0; i < path.length - 1; i++) {
+
+			if (members[path[i]] === undefined) {
+				if (!createMissing)
+					return undefined
+				members[path[i]] = {}
+			}
+
+			var node = members[path[i]]
+
+			if (node.collection === undefined) {
+				if (!createMissing)
+					return undefined
+				node.collection = {}
+			}
+
+			members = node.collection
+		}
+
+		return members
+	}
+
+	// Merges a patch sent by jaspResults into results, returns false if only the progress could have changed
+	var applyResultsPatch = function (results, patch) {
+
+		var fieldsChanged = !_.isEqual(_.pick(results, _.keys(patch.fields)), patch.fields)
+
+		_.extend(results, patch.fields)
+
+		_.each(patch.added, function (added) {
+			resultsMembersAt(results, added.path, true)[_.last(added.path)] = added.data
+		})
+
+		_.each(patch.changed, function (changed) {
+			var members = resultsMembersAt(results, changed.path, true)
+			var name = _.last(changed.path)
+
+			if (changed.data.collection === undefined && members[name] !== undefined && members[name].collection !== undefined) // changed containers do not send their children again
+				changed.data.collection = members[name].collection
+
+			members[name] = changed.data
+		})
+
+		_.each(patch.removed, function (path) {
+			var members = resultsMembersAt(results, path, false)
+			if (members !== undefined)
+				delete members[_.last(path)]
+		})
+
+		return fieldsChanged || patch.added.length > 0 || patch.changed.length > 0 || patch.removed.length > 0
+	}
+
+	// The table is found by its name as it could be anywhere in the results
+	var findResultsTable = function (node, tableName) {
+
+		if (!_.isObject(node) || _.isArray(node))
+			return undefined
+
+		if (node.name === tableName && _.isArray(node.data))
+			return node
+
+		for (var key in node) {
+			var found = key !== "data" ? findResultsTable(node[key], tableName) : undefined
+			if (found !== undefined)
+				return found
+		}
+
+		return undefined
+	}
+
+	window.tablePageReceived = function (id, tableName, from, rows) {
+
+		var jaspWidget = analyses.getAnalysis(id);
+		if (jaspWidget === undefined || !_.isArray(rows))
+			return
+
+		var table = findResultsTable(jaspWidget.model.get("results"), tableName)
+		if (table === undefined || from > table.data.length)
+			return
+
+		table.data.splice.apply(table.data, [from, table.data.length - from].concat(rows))
+		jaspWidget.render()
+	}
+
+	window.analysisPatched = function (patch) {
+
+		if (introVisible) {
+
+			_.each(_.where(introHidingResultsWaiting, { id: patch.id }), function (analysis) {
+				if (!_.isObject(analysis.results))
+					analysis.results = {}
+
+				applyResultsPatch(analysis.results, patch.resultsPatch)
+				analysis.status = patch.status
+				analysis.progress = patch.progress
+			})
+
+			return
+		}
+
+		var jaspWidget = analyses.getAnalysis(patch.id);
+		if (jaspWidget === undefined) // jaspResults always sends everything first, so this should not happen
+			return
+
+		var results = jaspWidget.model.get("results")
+		if (!_.isObject(results))
+			results = {}
+
+		var resultsChanged = applyResultsPatch(results, patch.resultsPatch)
+
+		jaspWidget.model.set({ results: results, status: patch.status, progress: patch.progress })
+
+		if (resultsChanged)
+			jaspWidget.render()
+		else
+			jaspWidget.renderProgressbar()
+	}
+
 	$("#results").on("click", ".stack-trace-selector", function() {
 		$(this).next(".stack-trace").slideToggle(function() {
 			var $selectedInner = $(this).parent().siblings(".jasp-analysis");
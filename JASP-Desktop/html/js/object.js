@@ -74,6 +74,11 @@ JASPWidgets.objectConstructor = function (results, params, ignoreEvents) {
 
 		this.trigger("EditImage:clicked", options)
 	}, this.model);
+
+	itemModel.on("TablePage:requested", function (tableName, from, count) {
+
+		this.trigger("TablePage:requested", tableName, from, count)
+	}, this.model);
 		
 	itemModel.on("analysis:resizeStarted", function (image) {
 		
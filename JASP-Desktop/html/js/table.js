@@ -418,6 +418,18 @@ JASPWidgets.tableView = JASPWidgets.objectView.extend({
 
 JASPWidgets.tablePrimitive = JASPWidgets.View.extend({
 
+	events: {
+		'click .jasp-table-more': '_showMoreRows',
+	},
+
+	// Very large tables only come with their first rows, the rest is asked for a page at a time
+	_showMoreRows: function (e) {
+		e.preventDefault();
+
+		var optData = this.model.get("data");
+		this.model.trigger("TablePage:requested", this.model.get("name"), optData ? optData.length : 0, this.model.get("rowsPerPage"));
+	},
+
 	render: function () {
 		var optSchema = this.model.get("schema");
 		var optData = this.model.get("data");
@@ -429,6 +441,7 @@ JASPWidgets.tablePrimitive = JASPWidgets.View.extend({
 		var optCitation = this.model.get("citation");
 		var optStatus = this.model.get("status");
 		var optError = this.model.get("error");
+		var optRowCount = this.model.get("rowCount");
 
 		var columnDefs = optSchema.fields
 		var columnCount = columnDefs.length
@@ -756,11 +769,20 @@ JASPWidgets.tablePrimitive = JASPWidgets.View.extend({
 
 		chunks.push('</tbody>')
 
-		if (optFootnotes) {
+		var paged = optRowCount !== undefined && optRowCount > rowCount
+
+		if (optFootnotes || paged) {
 
 			chunks.push('<tfoot>')
 
-			for (var i = 0; i < optFootnotes.length; i++) {
+			if (paged) {
+				chunks.push('<tr><td colspan="' + 2 * columnCount + '">')
+				chunks.push('Showing ' + rowCount + ' of ' + optRowCount + ' rows. ')
+				chunks.push('<span class="do-not-copy"><a href="#" class="jasp-table-more">Show more</a></span>')
+				chunks.push('</td></tr>')
+			}
+
+			for (var i = 0; optFootnotes && i < optFootnotes.length; i++) {
 
 				chunks.push('<tr><td colspan="' + 2 * columnCount + '">')
 
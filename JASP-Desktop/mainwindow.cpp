@@ -163,6 +163,7 @@ void MainWindow::makeConnections()
 	connect(_engineSync,			&EngineSync::computeColumnSucceeded,				_computedColumnsModel,	&ComputedColumnsModel::computeColumnSucceeded				);
 	connect(_engineSync,			&EngineSync::computeColumnFailed,					_computedColumnsModel,	&ComputedColumnsModel::computeColumnFailed					);
 	connect(_engineSync,			&EngineSync::processNewFilterResult,				_filterModel,			&FilterModel::processFilterResult							);
+	connect(_engineSync,			&EngineSync::processFilterResultInDataSet,			_filterModel,			&FilterModel::processFilterResultInDataSet					);
 	connect(_engineSync,			&EngineSync::processFilterErrorMsg,					_filterModel,			&FilterModel::processFilterErrorMsg							);
 
 	qRegisterMetaType<Column::ColumnType>();
@@ -190,6 +191,9 @@ void MainWindow::makeConnections()
 	connect(_resultsJsInterface,	&ResultsJsInterface::resultsPageLoadedPpi,			this,					&MainWindow::resultsPageLoaded								);
 	connect(_resultsJsInterface,	&ResultsJsInterface::ppiChanged,					this,					&MainWindow::ppiChangedHandler								);
 	connect(_resultsJsInterface,	&ResultsJsInterface::openFileTab,					_fileMenu,				&FileMenu::showFileMenu										);
+	connect(_resultsJsInterface,	&ResultsJsInterface::requestTablePage,				_engineSync,			&EngineSync::requestTablePage								);
+	connect(_engineSync,			&EngineSync::tablePageReturned,						_resultsJsInterface,	&ResultsJsInterface::tablePageReturned						);
+	connect(_resultsJsInterface,	&ResultsJsInterface::tablePagesNeeded,				_engineSync,			&EngineSync::fetchTablePages								);
 
 	connect(_analyses,				&Analyses::analysisResultsChanged,					this,					&MainWindow::analysisResultsChangedHandler					);
 	connect(_analyses,				&Analyses::analysisImageSaved,						this,					&MainWindow::analysisImageSavedHandler						);
@@ -953,33 +957,39 @@ void MainWindow::dataSetIORequestHandler(FileEvent *event)
 	}
 	else if (event->operation() == FileEvent::FileSave)
 	{
+		connect(event, &FileEvent::completed, this, &MainWindow::dataSetIOCompleted);
+
 		if (_analyses->count() > 0)
 		{
 			_package->setWaitingForReady();
 
 			getAnalysesUserData();
-			_resultsJsInterface->exportPreviewHTML();
 
-			Json::Value analysesData(Json::objectValue);
+			//The rows of the paged tables are fetched first, the analyses are only stored and saved once those are in
+			_resultsJsInterface->exportPreviewHTML([=]()
+			{
+				Json::Value analysesData(Json::objectValue);
 
-			analysesData["analyses"]	= _analyses->asJson();
-			analysesData["meta"]		= _resultsJsInterface->getResultsMeta();
+				analysesData["analyses"]	= _analyses->asJson();
+				analysesData["meta"]		= _resultsJsInterface->getResultsMeta();
 
-			_package->setAnalysesData(analysesData);
-		}
+				_package->setAnalysesData(analysesData);
 
-		connect(event, &FileEvent::completed, this, &MainWindow::dataSetIOCompleted);
+				_loader.io(event, _package);
+			});
+		}
+		else
+			_loader.io(event, _package);
 
-		_loader.io(event, _package);
 		showProgress();
 	}
 	else if (event->operation() == FileEvent::FileExportResults)
 	{
 		connect(event, &FileEvent::completed, this, &MainWindow::dataSetIOCompleted);
 
-		_resultsJsInterface->exportHTML();
+		_package->setWaitingForReady();
+		_resultsJsInterface->exportHTML([=]() { _loader.io(event, _package); });
 
-		_loader.io(event, _package);
 		showProgress();
 	}
 	else if (event->operation() == FileEvent::FileExportData || event->operation() == FileEvent::FileGenerateData)
@@ -1096,7 +1106,11 @@ void MainWindow::dataSetIOCompleted(FileEvent *event)
 		else
 		{
 			if (_package->dataSet() != nullptr)
+			{
+				pauseEngines(); //They should let go of the dataset before it is freed
 				_loader.free(_package->dataSet());
+				resumeEngines();
+			}
 			_package->reset();
 			setDataSetAndPackageInModels(nullptr);
 
@@ -1149,7 +1163,9 @@ void MainWindow::dataSetIOCompleted(FileEvent *event)
 			_analyses->clear();
 			std::cout << "should hide options panel now" << std::endl;
 			setDataSetAndPackageInModels(nullptr);
+			pauseEngines(); //They should let go of the dataset before it is freed
 			_loader.free(_package->dataSet());
+			resumeEngines();
 			_package->reset();
 			_filterModel->setDataSetPackage(nullptr);
 			updateMenuEnabledDisabledStatus();
@@ -3,8 +3,22 @@
 #include <QSGFlatColorMaterial>
 #include <QSGGeometry>
 #include <QSGNode>
+#include <QSGSimpleTextureNode>
+#include <QQuickWindow>
+#include <QPainter>
+#include <QtMath>
 #include <queue>
 
+DataSetViewTextLayer::DataSetViewTextLayer(DataSetView * view) : QQuickItem(view), _view(view)
+{
+	setFlag(QQuickItem::ItemHasContents, true);
+	setZ(-4);
+}
+
+QSGNode * DataSetViewTextLayer::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+	return _view->updateTextPaintNode(oldNode);
+}
 
 
 DataSetView::DataSetView(QQuickItem *parent) : QQuickItem (parent), _metricsFont(_font)
@@ -13,6 +27,8 @@ DataSetView::DataSetView(QQuickItem *parent) : QQuickItem (parent), _metricsFont
 
 	material.setColor(Qt::gray);
 
+	_textLayer = new DataSetViewTextLayer(this);
+
 	connect(this, &DataSetView::parentChanged, this, &DataSetView::myParentChanged);
 
 	connect(this, &DataSetView::viewportXChanged, this, &DataSetView::viewportChanged);
@@ -77,6 +93,7 @@ void DataSetView::calculateCellSizes()
 {
 	_cellSizes.clear();
 	_dataColsMaxWidth.clear();
+	_chunks.clear();
 
 	for(auto col : _cellTextItems)
 	{
@@ -139,6 +156,7 @@ void DataSetView::calculateCellSizes()
 
 	setWidth(_dataWidth + extraColumnWidth());
 	setHeight( _dataRowsMaxHeight * (_model->rowCount() + 1));
+	_textLayer->setSize(QSizeF(width(), height()));
 	_recalculateCellSizes = false;
 
 	emit itemSizeChanged();
@@ -156,8 +174,10 @@ void DataSetView::viewportChanged()
 	determineCurrentViewPortIndices();
 	storeOutOfViewItems();
 	buildNewLinesAndCreateNewItems();
+	dropChunksOutOfView();
 
 	update();
+	_textLayer->update();
 
 	_previousViewportColMin = _currentViewportColMin;
 	_previousViewportColMax = _currentViewportColMax;
@@ -172,6 +192,10 @@ void DataSetView::determineCurrentViewPortIndices()
 	QVector2D viewSize(_viewportW, _viewportH);
 	QVector2D rightBottom(leftTop + viewSize);
 
+	//Otherwise the margins below keep widening the columns in view each time the viewport moves
+	_currentViewportColMin = -1;
+	_currentViewportColMax = -1;
+
 	float cumulative = 0;
 	for(int col=0; col<_model->columnCount() && _currentViewportColMax == -1; col++)
 	{
@@ -242,15 +266,17 @@ void DataSetView::buildNewLinesAndCreateNewItems()
 			QVector2D pos0(_colXPositions[col],					_dataRowsMaxHeight + row * _dataRowsMaxHeight);
 			QVector2D pos1(pos0.x() + _dataColsMaxWidth[col],	pos0.y()+ _dataRowsMaxHeight);
 
-			int lineFlags = _model->data(_model->index(row, col), _roleNameToRole["lines"]).toInt();
+			DataSetViewChunk & chunk = chunkFor(row, col);
+			size_t inChunk = row % _chunkRows;
+			int lineFlags = inChunk < chunk.cells.size() ? chunk.cells.lines[inChunk] : 0;
 
 			bool	left	= (lineFlags & 1) > 0	&& pos0.x()  > _rowNumberMaxWidth + _viewportX,
 					right	= (lineFlags & 2) > 0	&& pos1.x()  > _rowNumberMaxWidth + _viewportX,
 					up		= (lineFlags & 4) > 0	&& pos0.y()  > _dataRowsMaxHeight + _viewportY,
 					down	= (lineFlags & 8) > 0	&& pos1.y()  > _dataRowsMaxHeight + _viewportY;
 
-			createTextItem(row, col);
-
+			if(!drawsCellsItself())
+				createTextItem(row, col);
 
 			if(left)	_lines.push_back(std::make_pair(QVector2D(pos0.x(),	pos1.y()),	pos0));
 			if(up)		_lines.push_back(std::make_pair(QVector2D(pos1.x(),	pos0.y()),	pos0));
@@ -310,20 +336,18 @@ QQuickItem * DataSetView::createTextItem(int row, int col)
 {
 	//std::cout << "createTextItem("<<row<<", "<<col<<") called!\n" << std::flush;
 
+	if(drawsCellsItself()) //_textLayer takes care of it
+		return NULL;
+
 	if((_cellTextItems.count(col) == 0 && _cellTextItems[col].count(row) == 0) || _cellTextItems[col][row] == NULL)
 	{
-
-		if(_itemDelegate == NULL)
-		{
-			_itemDelegate = new QQmlComponent(qmlEngine(this));
-			_itemDelegate->setData("import QtQuick 2.9\nText { text: itemText; color: itemActive ? 'black' : 'grey'; font: dataFont }", QUrl());
-		}
-
 		QQuickItem * textItem = NULL;
 		ItemContextualized * itemCon = NULL;
 
-		QModelIndex ind(_model->index(row, col));
-		bool active = _model->data(ind, _roleNameToRole["active"]).toBool();
+		DataSetViewChunk	&	chunk	= chunkFor(row, col);
+		size_t					inChunk	= row % _chunkRows;
+		bool					active	= inChunk < chunk.cells.size() && chunk.cells.active[inChunk];
+		QString					text	= inChunk < chunk.cells.size() ? chunk.cells.texts[inChunk] : QString();
 
 		if(_textItemStorage.size() > 0)
 		{
@@ -333,7 +357,7 @@ QQuickItem * DataSetView::createTextItem(int row, int col)
 			itemCon = _textItemStorage.top();
 			textItem = itemCon->item;
 			_textItemStorage.pop();
-			setStyleDataItem(itemCon->context, _model->data(ind).toString(), active, col, row);
+			setStyleDataItem(itemCon->context, text, active, col, row);
 		}
 		else
 		{
@@ -341,7 +365,7 @@ QQuickItem * DataSetView::createTextItem(int row, int col)
 			std::cout << "createTextItem("<<row<<", "<<col<<") ex nihilo!\n" << std::flush;
 #endif
 			QQmlIncubator localIncubator(QQmlIncubator::Synchronous);
-			itemCon = new ItemContextualized(setStyleDataItem(NULL, _model->data(ind).toString(), active, col, row));
+			itemCon = new ItemContextualized(setStyleDataItem(NULL, text, active, col, row));
 			_itemDelegate->create(localIncubator, itemCon->context);
 
             if(localIncubator.isError())
@@ -373,6 +397,152 @@ QQuickItem * DataSetView::createTextItem(int row, int col)
 	return _cellTextItems[col][row]->item;
 }
 
+DataSetViewChunk & DataSetView::chunkFor(int row, int col)
+{
+	int		chunk	= row / _chunkRows;
+	bool	fetch	= _chunks.count(col) == 0 || _chunks[col].count(chunk) == 0;
+
+	DataSetViewChunk & found = _chunks[col][chunk];
+
+	if(fetch)
+		fetchChunk(chunk, col, found);
+
+	if(drawsCellsItself() && found.image.isNull() && found.cells.size() > 0)
+		layoutChunk(chunk, col, found);
+
+	return found;
+}
+
+void DataSetView::fetchChunk(int chunk, int col, DataSetViewChunk & into)
+{
+	int rowStart	= chunk * _chunkRows,
+		rowEnd		= std::min(rowStart + _chunkRows, _model->rowCount());
+
+	into.image = QImage();
+
+	DataSetTableModel * dataSetModel = qobject_cast<DataSetTableModel*>(_model);
+
+	if(dataSetModel != NULL)
+	{
+		dataSetModel->cellBlock(col, rowStart, rowEnd, into.cells);
+		return;
+	}
+
+	//Other models only have data(), so it is asked cell by cell
+	into.cells = DataSetCellBlock();
+
+	for(int row=rowStart; row<rowEnd; row++)
+	{
+		QModelIndex ind(_model->index(row, col));
+
+		into.cells.texts.push_back(	_model->data(ind).toString());
+		into.cells.active.push_back(_model->data(ind, _roleNameToRole["active"]).toBool());
+		into.cells.lines.push_back(	_model->data(ind, _roleNameToRole["lines"]).toInt());
+	}
+}
+
+///Draws the texts of the chunk the way the default delegate (a Text with itemText, grey when not itemActive) used to
+void DataSetView::layoutChunk(int, int col, DataSetViewChunk & into)
+{
+	qreal	pixelRatio	= window() != NULL ? window()->effectiveDevicePixelRatio() : 1;
+	float	width		= _dataColsMaxWidth[col];
+
+	QImage image(qCeil(width * pixelRatio), qCeil(into.cells.size() * _dataRowsMaxHeight * pixelRatio), QImage::Format_ARGB32_Premultiplied);
+	image.setDevicePixelRatio(pixelRatio);
+	image.fill(Qt::transparent);
+
+	QPainter painter(&image);
+	painter.setFont(_font);
+
+	for(size_t row=0; row<into.cells.size(); row++)
+	{
+		painter.setPen(into.cells.active[row] ? QColor(Qt::black) : QColor(128, 128, 128));
+		painter.drawText(QRectF(_itemHorizontalPadding, -2 + _itemVerticalPadding + row * _dataRowsMaxHeight, width - _itemHorizontalPadding, _dataRowsMaxHeight), Qt::AlignLeft | Qt::AlignTop | Qt::TextSingleLine, into.cells.texts[row]);
+	}
+
+	painter.end();
+
+	into.image = image;
+}
+
+///Chunks out of view give up their image right away, as that is where the memory goes and laying out the texts again is cheap. Their texts are only dropped once more than _maxCachedChunks are kept.
+void DataSetView::dropChunksOutOfView()
+{
+	int chunkMin = _currentViewportRowMin / _chunkRows,
+		chunkMax = _currentViewportRowMax / _chunkRows;
+
+	auto inView = [&](int col, int chunk) { return col >= _currentViewportColMin && col < _currentViewportColMax && chunk >= chunkMin && chunk <= chunkMax; };
+
+	size_t cached = 0;
+	for(auto & col : _chunks)
+		for(auto & chunk : col.second)
+		{
+			cached++;
+
+			if(!inView(col.first, chunk.first))
+				chunk.second.image = QImage();
+		}
+
+	if(cached <= size_t(_maxCachedChunks))
+		return;
+
+	for(auto col = _chunks.begin(); col != _chunks.end();)
+	{
+		for(auto chunk = col->second.begin(); chunk != col->second.end();)
+			if(inView(col->first, chunk->first))	chunk++;
+			else									chunk = col->second.erase(chunk);
+
+		if(col->second.size() == 0)	col = _chunks.erase(col);
+		else						col++;
+	}
+}
+
+///Called by _textLayer while rendering, every chunk in view gets a texture node that is kept as long as its image does not change
+QSGNode * DataSetView::updateTextPaintNode(QSGNode * oldNode)
+{
+	if(oldNode == NULL)
+	{
+		oldNode = new QSGNode();
+		_chunkNodes.clear(); //They went with the previous node
+	}
+
+	std::map<std::pair<int, int>, std::pair<qint64, QSGSimpleTextureNode*>> shown;
+
+	if(drawsCellsItself() && _model != NULL)
+		for(int col=_currentViewportColMin; col<_currentViewportColMax; col++)
+			for(int chunk=_currentViewportRowMin / _chunkRows; chunk * _chunkRows < _currentViewportRowMax; chunk++)
+			{
+				if(_chunks.count(col) == 0 || _chunks[col].count(chunk) == 0 || _chunks[col][chunk].image.isNull())
+					continue;
+
+				const QImage	&	image	= _chunks[col][chunk].image;
+				auto				key		= std::make_pair(col, chunk);
+				auto				node	= _chunkNodes.find(key);
+
+				if(node != _chunkNodes.end() && node->second.first == image.cacheKey())
+				{
+					shown[key] = node->second;
+					_chunkNodes.erase(node);
+					continue;
+				}
+
+				QSGSimpleTextureNode * textureNode = new QSGSimpleTextureNode();
+				textureNode->setOwnsTexture(true);
+				textureNode->setTexture(window()->createTextureFromImage(image));
+				textureNode->setRect(QRectF(_colXPositions[col], (1 + chunk * _chunkRows) * _dataRowsMaxHeight, image.width() / image.devicePixelRatio(), image.height() / image.devicePixelRatio()));
+
+				oldNode->appendChildNode(textureNode);
+				shown[key] = std::make_pair(image.cacheKey(), textureNode);
+			}
+
+	for(auto & outOfView : _chunkNodes) //Either scrolled away or outdated
+		delete outOfView.second.second;
+
+	_chunkNodes.swap(shown);
+
+	return oldNode;
+}
+
 void DataSetView::storeTextItem(int row, int col, bool cleanUp)
 {
 #ifdef DATASETVIEW_DEBUG_CREATION
@@ -10,8 +10,10 @@
 #include <iostream>
 #include <map>
 #include <QFontMetricsF>
+#include <QImage>
 #include <QtQml>
 #include "utilities/qutils.h"
+#include "data/datasettablemodel.h"
 
 //#define DATASETVIEW_DEBUG_VIEWPORT
 //#define DATASETVIEW_DEBUG_CREATION
@@ -24,6 +26,28 @@ struct ItemContextualized
 	QQmlContext * context;
 };
 
+///A piece of a column as it was fetched from the model, without an itemDelegate the texts are also laid out in image while it is in view
+struct DataSetViewChunk
+{
+	DataSetCellBlock	cells;
+	QImage				image;
+};
+
+class DataSetView;
+class QSGSimpleTextureNode;
+
+///Draws the cells of DataSetView when there is no itemDelegate, it sits below the row numbers and column headers just like the items would.
+class DataSetViewTextLayer : public QQuickItem
+{
+public:
+	DataSetViewTextLayer(DataSetView * view);
+
+protected:
+	QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+
+private:
+	DataSetView * _view;
+};
 
 
 class DataSetView : public QQuickItem
@@ -130,7 +154,7 @@ public slots:
 
 	void modelDataChanged(const QModelIndex &, const QModelIndex &, const QVector<int> &)	{ calculateCellSizes(); }
 	void modelHeaderDataChanged(Qt::Orientation, int, int)									{ calculateCellSizes(); }
-	void modelAboutToBeReset()																{}
+	void modelAboutToBeReset()																{ _chunks.clear(); }
 	void modelWasReset()																	{ setRolenames(); calculateCellSizes(); }
 
 protected:
@@ -145,6 +169,15 @@ protected:
 	QQuickItem * createTextItem(int row, int col);
 	void storeTextItem(int row, int col, bool cleanUp = true);
 
+	DataSetViewChunk &	chunkFor(int row, int col);
+	void				fetchChunk(int chunk, int col, DataSetViewChunk & into);
+	void				layoutChunk(int chunk, int col, DataSetViewChunk & into);
+	void				dropChunksOutOfView();
+	bool				drawsCellsItself() const { return _itemDelegate == NULL; }
+
+	friend class DataSetViewTextLayer;
+	QSGNode *			updateTextPaintNode(QSGNode *oldNode);
+
 	QQuickItem * createRowNumber(int row);
 	void storeRowNumber(int row);
 
@@ -171,6 +204,11 @@ protected:
 	std::stack<ItemContextualized*>						_columnHeaderStorage;
 	std::map<int, ItemContextualized *>					_columnHeaderItems;
 	std::map<int, std::map<int, ItemContextualized *>>	_cellTextItems;			//[col][row]
+	std::map<int, std::map<int, DataSetViewChunk>>		_chunks;				//[col][row / _chunkRows]
+	std::map<std::pair<int, int>, std::pair<qint64, QSGSimpleTextureNode*>> _chunkNodes; //[col, chunk] -> image.cacheKey() and node showing it, only touched while rendering
+	DataSetViewTextLayer								*_textLayer;
+	static const int									_chunkRows			= 64,
+														_maxCachedChunks	= 512;
 	std::vector<std::pair<QVector2D, QVector2D>>		_lines;
 	QQuickItem											*_leftTopItem = NULL,
 														*_extraColumnItem = NULL;
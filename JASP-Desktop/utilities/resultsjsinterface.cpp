@@ -101,6 +101,11 @@ void ResultsJsInterface::resultsPageLoaded(bool succes)
 
 void ResultsJsInterface::showAnalysesMenu(QString options)
 {
+	Json::Value menuOptionsJson;
+	Json::Reader().parse(fq(options), menuOptionsJson);
+
+	_menuAnalysisId = menuOptionsJson.get("analysisId", -1).asInt(); //Copying only needs the rows of the analysis the menu was opened for
+
 	std::cout << "showAnalysesMenu must be done in QML" << std::endl;
 
 	/*
@@ -231,7 +236,7 @@ void ResultsJsInterface::editTitleSelected()
 void ResultsJsInterface::copySelected()
 {
 	TempFiles::purgeClipboard();
-	emit runJavaScript("window.copyMenuClicked();");
+	emit tablePagesNeeded(_menuAnalysisId, [this]() { emit runJavaScript("window.copyMenuClicked();"); });
 }
 
 void ResultsJsInterface::citeSelected()
@@ -243,7 +248,7 @@ void ResultsJsInterface::citeSelected()
 void ResultsJsInterface::latexCodeSelected()
 {
 	TempFiles::purgeClipboard();
-	emit runJavaScript("window.latexCodeMenuClicked();");
+	emit tablePagesNeeded(_menuAnalysisId, [this]() { emit runJavaScript("window.latexCodeMenuClicked();"); });
 }
 
 void ResultsJsInterface::getDefaultPPI()
@@ -360,6 +365,11 @@ void ResultsJsInterface::analysisImageEditedHandler(Analysis *analysis)
     return;
 }
 
+void ResultsJsInterface::tablePageReturned(int id, QString tableName, int from, QString rows)
+{
+	emit runJavaScript("window.tablePageReceived(" + QString::number(id) + ", '" + escapeJavascriptString(tableName) + "', " + QString::number(from) + ", JSON.parse('" + escapeJavascriptString(rows) + "'));");
+}
+
 void ResultsJsInterface::menuHidding()
 {
 	emit runJavaScript("window.analysisMenuHidden();");
@@ -438,11 +448,23 @@ void ResultsJsInterface::showAnalysis(int id)
 
 void ResultsJsInterface::exportSelected(const QString &filename)
 {
-	emit runJavaScript("window.exportHTML('" + filename + "');");
+	emit tablePagesNeeded(-1, [this, filename]() { emit runJavaScript("window.exportHTML('" + filename + "');"); });
 }
 
 void ResultsJsInterface::analysisChanged(Analysis *analysis)
 {
+	if(!analysis->resultsPatch().isNull()) //Only the changes need to go to the results page then
+	{
+		Json::Value patchJson		= Json::objectValue;
+		patchJson["id"]				= int(analysis->id());
+		patchJson["status"]			= Analysis::statusToString(analysis->status());
+		patchJson["progress"]		= analysis->progress();
+		patchJson["resultsPatch"]	= analysis->resultsPatch();
+
+		emit runJavaScript("window.analysisPatched(JSON.parse('" + escapeJavascriptString(tq(patchJson.toStyledString())) + "'));");
+		return;
+	}
+
 	Json::Value analysisJson	= analysis->asJSON();
 	analysisJson["userdata"]	= analysis->userData();
 	QString results				= tq(analysisJson.toStyledString());
@@ -495,14 +517,22 @@ void ResultsJsInterface::showInstruction()
 	emit runJavaScript("window.showInstructions()");
 }
 
-void ResultsJsInterface::exportPreviewHTML()
+void ResultsJsInterface::exportPreviewHTML(std::function<void()> beforeExport)
 {
-	emit runJavaScript("window.exportHTML('%PREVIEW%');");
+	emit tablePagesNeeded(-1, [this, beforeExport]()
+	{
+		beforeExport();
+		emit runJavaScript("window.exportHTML('%PREVIEW%');");
+	});
 }
 
-void ResultsJsInterface::exportHTML()
+void ResultsJsInterface::exportHTML(std::function<void()> beforeExport)
 {
-	emit runJavaScript("window.exportHTML('%EXPORT%');");
+	emit tablePagesNeeded(-1, [this, beforeExport]()
+	{
+		beforeExport();
+		emit runJavaScript("window.exportHTML('%EXPORT%');");
+	});
 }
 
 QString ResultsJsInterface::escapeJavascriptString(const QString &str)
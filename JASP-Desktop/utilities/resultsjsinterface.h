@@ -50,8 +50,8 @@ public:
 	void unselect();
 	void removeAnalysis(Analysis *analysis);
 	void showInstruction();
-	void exportPreviewHTML();
-	void exportHTML();
+	void exportPreviewHTML(std::function<void()> beforeExport = [](){});
+	void exportHTML(std::function<void()> beforeExport = [](){});
 
 	Json::Value &getResultsMeta();
 	QVariant	&getAllUserData();
@@ -79,11 +79,14 @@ signals:
 	void		openFileTab();
 	void		resultsPageLoadedPpi(bool succes, int ppi);
 	void		ppiChanged(int ppi);
+	void		requestTablePage(int id, QString tableName, int from, int count);
+	void		tablePagesNeeded(int analysisId, std::function<void()> whenFetched); ///< Before copying or exporting, the paged tables of analysisId (-1 for all) should have all their rows in the results page
 
 public slots:
 	void setExactPValuesHandler(bool exact);
 	void setFixDecimalsHandler(QString numDecimals);
 	void analysisImageEditedHandler(Analysis *analysis);
+	void tablePageReturned(int id, QString tableName, int from, QString rows);
 	void showAnalysesMenu(QString options);
 	void simulatedMouseClick(int x, int y, int count);
 	void saveTempImage(int id, QString path, QByteArray data);
@@ -129,6 +132,7 @@ private:
 	Json::Value		_resultsMeta;
 	QVariant		_allUserData;
 	QString			_resultsPageUrl = "qrc:///core/index.html";
+	int				_menuAnalysisId = -1;
 
 };
 
@@ -21,7 +21,9 @@ const Settings::Setting Settings::Values[] = {
 	{"UIScale", 0.7f},
 	{"ImageBackground", "white"},
 	{"testAnalysisQML", ""},
-	{"testAnalysisR", ""}
+	{"testAnalysisR", ""},
+	{"maxEngines", 0}, //0 means: derive it from the number of cores
+	{"engineMessageFormat", "messagePack"} //or "json", which is easier to read when debugging
 };
 
 QVariant Settings::value(Settings::Type key)
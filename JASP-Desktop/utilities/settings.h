@@ -26,7 +26,9 @@ public:
 		UI_SCALE,
 		IMAGE_BACKGROUND,
 		TEST_ANALYSIS_QML,
-		TEST_ANALYSIS_R
+		TEST_ANALYSIS_R,
+		MAX_ENGINES,
+		ENGINE_MESSAGE_FORMAT
 	};
 
 	static QVariant value(Settings::Type key);
@@ -27,6 +27,12 @@
 #include "../JASP-Common/sharedmemory.h"
 #include <csignal>
 
+#ifdef __linux__
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include "rbridge.h"
 
 void SendFunctionForJaspresults(const char * msg) { Engine::theEngine()->sendString(msg); }
@@ -113,18 +119,94 @@ void Engine::run()
 	boost::interprocess::shared_memory_object::remove(memoryName.c_str());
 }
 
+void Engine::setSlaveNo(int no)
+{
+	_slaveNo = no;
+}
+
+#ifdef __linux__
+/* The template is started by the Desktop once and does the expensive R initialization (RInside, loading the packages, initEnvironment()).
+ * After that it only listens on its own channel for {"fork": slaveNo, "request": id} and forks a worker for each,
+ * so they all share the already initialized R heap copy-on-write and are up in milliseconds.
+ * It answers with {"forked": slaveNo, "request": id, "pid": pid} and tells the Desktop when a worker exits with {"exited": slaveNo, "pid": pid, "status": status}.
+ * The workers check for their parent like any engine, so they stop when the template does.
+ * Nothing here may start a thread before forking, a forked child only keeps the thread that called fork().
+ */
+void Engine::runAsTemplate()
+{
+	std::string		memoryName	= "JASP-IPC-" + std::to_string(_parentPID) + "-Template";
+	IPCChannel	*	control		= new IPCChannel(memoryName, 0, true);
+
+	std::map<pid_t, int> workers;
+
+	while(ProcessInfo::isParentRunning())
+	{
+		Json::Value request;
+
+		if(control->receive([&](const char * message, size_t size) { JsonSerializer::parse(message, size, request); }, 100) && request.isMember("fork"))
+		{
+			int		slaveNo	= request["fork"].asInt();
+			pid_t	pid		= fork();
+
+			if(pid == 0)
+			{
+				//R keeps its own seeds, the workers shouldn't all draw the same "random" numbers or tempfile() names
+				srand(getpid());
+				jaspRCPP_evalRCode("if(exists('.Random.seed', envir=globalenv())) rm('.Random.seed', envir=globalenv())");
+
+				setSlaveNo(slaveNo);
+				run();
+
+				std::cout.flush();
+				_exit(0); //The template's exit handlers are not ours to run
+			}
+
+			Json::Value reply(Json::objectValue);
+
+			reply["forked"]		= slaveNo;
+			reply["request"]	= request.get("request", -1).asInt();
+			reply["pid"]		= pid; //-1 when fork() failed
+
+			if(pid > 0)
+				workers[pid] = slaveNo;
+			else
+				std::cout << "Engine template could not fork engine " << slaveNo << std::endl;
+
+			control->send(JsonSerializer::compact(reply));
+		}
+
+		int		status;
+		pid_t	pid;
+
+		while((pid = waitpid(-1, &status, WNOHANG)) > 0)
+		{
+			Json::Value reply(Json::objectValue);
+
+			reply["exited"]	= workers.count(pid) ? workers[pid] : -1;
+			reply["pid"]	= pid;
+			reply["status"]	= status;
+
+			workers.erase(pid);
+			control->send(JsonSerializer::compact(reply));
+		}
+	}
+}
+#endif
+
 
 
 bool Engine::receiveMessages(int timeout)
 {
-	std::string data;
+	Json::Value jsonRequest;
 
-	if (_channel->receive(data, timeout))
+	auto readRequest = [&](const char * message, size_t size)
 	{
-		Json::Value jsonRequest;
-		Json::Reader().parse(data, jsonRequest, false);
-
+		_messageFormat = JsonSerializer::formatOf(message, size); //Answer in the same format
+		JsonSerializer::parse(message, size, jsonRequest);
+	};
 
+	if (_channel->receive(readRequest, timeout))
+	{
 		engineState typeRequest = engineStateFromString(jsonRequest.get("typeRequest", Json::nullValue).asString());
 
 #ifdef PRINT_ENGINE_MESSAGES
@@ -139,6 +221,7 @@ bool Engine::receiveMessages(int timeout)
 		case engineState::paused:			pauseEngine();								break;
 		case engineState::resuming:			resumeEngine();								break;
 		case engineState::moduleRequest:	receiveModuleRequestMessage(jsonRequest);	break;
+		case engineState::tablePage:		receiveTablePageMessage(jsonRequest);		break;
 		default:							throw std::runtime_error("Engine::receiveMessages begs you to add your new engineState to it!");
 		}
 	}
@@ -183,13 +266,21 @@ void Engine::sendFilterResult(int filterRequestId, std::vector<bool> filterResul
 	Json::Value filterResponse(Json::objectValue);
 
 	filterResponse["typeRequest"]	= engineStateToString(engineState::filter);
-	filterResponse["filterResult"]	= Json::arrayValue;
 	filterResponse["requestId"]		= filterRequestId;
 
-	for(bool f : filterResult)	filterResponse["filterResult"].append(f);
+	DataSet * dataSet = provideDataSet();
+
+	if(dataSet != NULL && dataSet->setPendingFilter(filterResult, filterRequestId))
+		filterResponse["filterResultInDataSet"] = true; //Only if the size matches, otherwise we fall back to sending it all
+	else
+	{
+		filterResponse["filterResult"]	= Json::arrayValue;
+		for(bool f : filterResult)	filterResponse["filterResult"].append(f);
+	}
+
 	if(warning != "")			filterResponse["filterError"] = warning;
 
-	sendString(filterResponse.toStyledString());
+	sendJson(filterResponse);
 }
 
 void Engine::sendFilterError(int filterRequestId, std::string errorMessage)
@@ -200,7 +291,7 @@ void Engine::sendFilterError(int filterRequestId, std::string errorMessage)
 	filterResponse["filterError"]	= errorMessage;
 	filterResponse["requestId"]		= filterRequestId;
 
-	sendString(filterResponse.toStyledString());
+	sendJson(filterResponse);
 }
 
 void Engine::receiveRCodeMessage(Json::Value jsonRequest)
@@ -240,7 +331,7 @@ void Engine::sendRCodeResult(std::string rCodeResult, int rCodeRequestId)
 	rCodeResponse["requestId"]		= rCodeRequestId;
 
 
-	sendString(rCodeResponse.toStyledString());
+	sendJson(rCodeResponse);
 }
 
 void Engine::sendRCodeError(int rCodeRequestId)
@@ -253,7 +344,7 @@ void Engine::sendRCodeError(int rCodeRequestId)
 	rCodeResponse["rCodeError"]		= RError.size() == 0 ? "R Code failed for unknown reason. Check that R function returns a string." : RError;
 	rCodeResponse["requestId"]		= rCodeRequestId;
 
-	sendString(rCodeResponse.toStyledString());
+	sendJson(rCodeResponse);
 }
 
 void Engine::receiveComputeColumnMessage(Json::Value jsonRequest)
@@ -291,7 +382,7 @@ void Engine::runComputeColumn(std::string computeColumnName, std::string compute
 	computeColumnResponse["error"]			= jaspRCPP_getLastErrorMsg();
 	computeColumnResponse["columnName"]		= computeColumnName;
 
-	sendString(computeColumnResponse.toStyledString());
+	sendJson(computeColumnResponse);
 
 	_currentEngineState = engineState::idle;
 }
@@ -315,11 +406,54 @@ void Engine::receiveModuleRequestMessage(Json::Value jsonRequest)
 	jsonAnswer["error"]				= jaspRCPP_getLastErrorMsg();
 	jsonAnswer["typeRequest"]		= engineStateToString(engineState::moduleRequest);
 
-	sendString(jsonAnswer.toStyledString());
+	sendJson(jsonAnswer);
 
 	_currentEngineState = engineState::idle;
 }
 
+void Engine::receiveTablePageMessage(Json::Value jsonRequest)
+{
+	if(_currentEngineState != engineState::idle && _currentEngineState != engineState::analysis)
+		throw std::runtime_error("Unexpected table page request, current state is not idle or analysis (" + engineStateToString(_currentEngineState) + ")");
+
+	int			analysisId	= jsonRequest.get("analysisId",	-1).asInt(),
+				from		= jsonRequest.get("from",		0).asInt(),
+				count		= jsonRequest.get("count",		0).asInt();
+	std::string	tableName	= jsonRequest.get("tableName",	"").asString();
+	Json::Value rows;
+
+	if(_currentEngineState == engineState::analysis) //The desktop only sends it here while it is running this analysis, its state file isn't there yet
+	{
+		if(analysisId != _analysisId)
+			throw std::runtime_error("Table page request for analysis " + std::to_string(analysisId) + " while running analysis " + std::to_string(_analysisId));
+
+		Json::Reader().parse(jaspRCPP_getRunningTablePage(tableName.c_str(), from, count), rows, false);
+	}
+	else
+	{
+		_currentEngineState = engineState::tablePage;
+
+		std::string root, relativePath;
+
+		//The rows come from the state file jaspResults left behind for the analysis, so R does not have to be bothered
+		TempFiles::createSpecific("jaspResults.json", analysisId, root, relativePath);
+
+		Json::Reader().parse(jaspRCPP_getTablePage((root + "/" + relativePath).c_str(), tableName.c_str(), from, count), rows, false);
+
+		_currentEngineState = engineState::idle;
+	}
+
+	Json::Value tablePageResponse(Json::objectValue);
+
+	tablePageResponse["typeRequest"]	= engineStateToString(engineState::tablePage);
+	tablePageResponse["analysisId"]		= analysisId;
+	tablePageResponse["tableName"]		= tableName;
+	tablePageResponse["from"]			= from;
+	tablePageResponse["rows"]			= rows;
+
+	sendJson(tablePageResponse);
+}
+
 void Engine::receiveAnalysisMessage(Json::Value jsonRequest)
 {
 	if(_currentEngineState != engineState::idle && _currentEngineState != engineState::analysis)
@@ -354,10 +488,10 @@ void Engine::receiveAnalysisMessage(Json::Value jsonRequest)
 	{
 		_analysisName			= jsonRequest.get("name",			Json::nullValue).asString();
 		_analysisTitle			= jsonRequest.get("title",			Json::nullValue).asString();
-		_analysisDataKey		= jsonRequest.get("dataKey",		Json::nullValue).toStyledString();
-		_analysisOptions		= jsonRequest.get("options",		Json::nullValue).toStyledString();
-		_analysisResultsMeta	= jsonRequest.get("resultsMeta",	Json::nullValue).toStyledString();
-		_analysisStateKey		= jsonRequest.get("stateKey",		Json::nullValue).toStyledString();
+		_analysisDataKey		= JsonSerializer::compact(jsonRequest.get("dataKey",		Json::nullValue));
+		_analysisOptions		= JsonSerializer::compact(jsonRequest.get("options",		Json::nullValue));
+		_analysisResultsMeta	= JsonSerializer::compact(jsonRequest.get("resultsMeta",	Json::nullValue));
+		_analysisStateKey		= JsonSerializer::compact(jsonRequest.get("stateKey",		Json::nullValue));
 		_analysisRevision		= jsonRequest.get("revision",		-1).asInt();
 		_imageOptions			= jsonRequest.get("image",			Json::nullValue);
 		_analysisRFile			= jsonRequest.get("rfile",				"").asString();
@@ -499,7 +633,7 @@ void Engine::sendAnalysisResults()
 	response["results"] = _analysisResults.get("results", _analysisResults);
 	response["status"]  = analysisResultStatusToString(resultStatus);
 
-	sendString(response.toStyledString());
+	sendJson(response);
 }
 
 void Engine::removeNonKeepFiles(Json::Value filesToKeepValue)
@@ -593,7 +727,7 @@ std::string Engine::callback(const std::string &results, int progress)
 	return "{ \"status\" : \"ok\" }";
 }
 
-bool Engine::setColumnDataAsNominalOrOrdinal(bool isOrdinal, std::string columnName, std::vector<int> data, std::map<int, std::string> levels)
+bool Engine::setColumnDataAsNominalOrOrdinal(bool isOrdinal, std::string columnName, std::vector<int> & data, std::map<int, std::string> levels)
 {
 	std::map<int, int> uniqueInts;
 
@@ -616,13 +750,13 @@ bool Engine::setColumnDataAsNominalOrOrdinal(bool isOrdinal, std::string columnN
 			if(dat != INT_MIN)
 				dat = uniqueInts[dat];
 
-		if(isOrdinal)	return	provideDataSet()->columns()[columnName].overwriteDataWithOrdinal(data);
-		else			return	provideDataSet()->columns()[columnName].overwriteDataWithNominal(data);
+		if(isOrdinal)	return	provideDataSet()->columns()[columnName].overwriteDataWithOrdinal(std::move(data));
+		else			return	provideDataSet()->columns()[columnName].overwriteDataWithNominal(std::move(data));
 	}
 	else
 	{
-		if(isOrdinal)	return	provideDataSet()->columns()[columnName].overwriteDataWithOrdinal(data, levels);
-		else			return	provideDataSet()->columns()[columnName].overwriteDataWithNominal(data, levels);
+		if(isOrdinal)	return	provideDataSet()->columns()[columnName].overwriteDataWithOrdinal(std::move(data), levels);
+		else			return	provideDataSet()->columns()[columnName].overwriteDataWithNominal(std::move(data), levels);
 	}
 }
 
@@ -638,7 +772,8 @@ void Engine::pauseEngine()
 
 	_currentEngineState = engineState::paused;
 
-	freeRBridgeColumns();
+	jaspRCPP_materializeSharedColumns(); //R might still hold on to vectors that read from the dataset we are about to unload
+	freeRBridgeColumnCache();
 	SharedMemory::unloadDataSet();
 	sendEnginePaused();
 }
@@ -659,7 +794,7 @@ void Engine::sendEnginePaused()
 	Json::Value rCodeResponse		= Json::objectValue;
 	rCodeResponse["typeRequest"]	= engineStateToString(engineState::paused);
 
-	sendString(rCodeResponse.toStyledString());
+	sendJson(rCodeResponse);
 }
 
 void Engine::sendEngineResumed()
@@ -671,5 +806,5 @@ void Engine::sendEngineResumed()
 	Json::Value rCodeResponse		= Json::objectValue;
 	rCodeResponse["typeRequest"]	= engineStateToString(engineState::resuming);
 
-	sendString(rCodeResponse.toStyledString());
+	sendJson(rCodeResponse);
 }
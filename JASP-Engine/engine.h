@@ -23,6 +23,7 @@
 #include "ipcchannel.h"
 #include "processinfo.h"
 #include "jsonredirect.h"
+#include "jsonserializer.h"
 
 /* The Engine represents the background processes.
  * It's job is pretty straight forward; it reads analysis
@@ -48,21 +49,25 @@ public:
 
 
 	void run();
+#ifdef __linux__
+	void runAsTemplate();
+#endif
 	bool receiveMessages(int timeout = 0);
 	void setSlaveNo(int no);
 	void sendString(std::string message) { _channel->send(message); }
+	void sendJson(const Json::Value & json) { _channel->send(JsonSerializer::serialize(json, _messageFormat)); }
 
 	typedef enum { empty, toInit, initing, inited, toRun, running, changed, complete, error, exception, aborted, stopped, saveImg, editImg, synchingData } Status;
 	Status getStatus() { return _analysisStatus; }
 	analysisResultStatus getStatusToAnalysisStatus();
 
 	//return true if changed:
-	bool setColumnDataAsScale(std::string columnName, std::vector<double> scalarData)										{	return provideDataSet()->columns()[columnName].overwriteDataWithScale(scalarData);				}
-	bool setColumnDataAsOrdinal(std::string columnName, std::vector<int> ordinalData, std::map<int, std::string> levels)	{	return setColumnDataAsNominalOrOrdinal(true,  columnName, ordinalData, levels);					}
-	bool setColumnDataAsNominal(std::string columnName, std::vector<int> nominalData, std::map<int, std::string> levels)	{	return setColumnDataAsNominalOrOrdinal(false, columnName, nominalData, levels);					}
-	bool setColumnDataAsNominalText(std::string columnName, std::vector<std::string> nominalData)							{	return provideDataSet()->columns()[columnName].overwriteDataWithNominal(nominalData);			}
+	bool setColumnDataAsScale(std::string columnName, std::vector<double> & scalarData)										{	return provideDataSet()->columns()[columnName].overwriteDataWithScale(std::move(scalarData));	}
+	bool setColumnDataAsOrdinal(std::string columnName, std::vector<int> & ordinalData, std::map<int, std::string> levels)	{	return setColumnDataAsNominalOrOrdinal(true,  columnName, ordinalData, levels);					}
+	bool setColumnDataAsNominal(std::string columnName, std::vector<int> & nominalData, std::map<int, std::string> levels)	{	return setColumnDataAsNominalOrOrdinal(false, columnName, nominalData, levels);					}
+	bool setColumnDataAsNominalText(std::string columnName, std::vector<std::string> & nominalData)							{	return provideDataSet()->columns()[columnName].overwriteDataWithNominal(std::move(nominalData));	}
 
-	bool setColumnDataAsNominalOrOrdinal(bool isOrdinal, std::string columnName, std::vector<int> data, std::map<int, std::string> levels);
+	bool setColumnDataAsNominalOrOrdinal(bool isOrdinal, std::string columnName, std::vector<int> & data, std::map<int, std::string> levels);
 
 	int dataSetRowCount()	{ return static_cast<int>(provideDataSet()->rowCount()); }
 
@@ -75,6 +80,7 @@ private: // Methods:
 	void receiveAnalysisMessage(		Json::Value jsonRequest);
 	void receiveComputeColumnMessage(	Json::Value jsonRequest);
 	void receiveModuleRequestMessage(	Json::Value jsonRequest);
+	void receiveTablePageMessage(		Json::Value jsonRequest);
 
 	void runComputeColumn(	std::string computeColumnName, std::string computeColumnCode, Column::ColumnType computeColumnType);
 	void runAnalysis();
@@ -136,6 +142,8 @@ private: // Data:
 
 	IPCChannel *_channel = NULL;
 
+	messageFormat _messageFormat = messageFormat::json; ///< Whatever the Desktop used for its last message
+
 	unsigned long _parentPID = 0;
 
 	engineState _currentEngineState = engineState::idle;
@@ -16,6 +16,7 @@
 //
 
 #include "engine.h"
+#include <string>
 
 int main(int argc, char *argv[])
 {
@@ -26,6 +27,15 @@ int main(int argc, char *argv[])
 
 		//sleep(10000000);
 
+#ifdef __linux__
+		if(std::string(argv[1]) == "template") //Initializes R only once and forks the actual engines from that, see Engine::runAsTemplate()
+		{
+			Engine *e = new Engine(-1, parentPID);
+			e->runAsTemplate();
+			return 0;
+		}
+#endif
+
 		Engine *e = new Engine(slaveNo, parentPID);
 		e->run();
 	}
@@ -233,6 +233,104 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSetForFiltering(size_t * colMa
 static RBridgeColumn*	datasetStatic = NULL;
 static int				datasetColMax = 0;
 
+///Which version of a column (and of the filter) something was made from, storage tells columns apart that got each others names.
+struct RBridgeColumnStamp
+{
+	const void	*	storage;
+	unsigned int	columnRevision,
+					filterRevision;
+
+	bool operator==(const RBridgeColumnStamp & other) const { return storage == other.storage && columnRevision == other.columnRevision && filterRevision == other.filterRevision; }
+};
+
+///What rbridge_readDataSet made of a column before, kept for as long as the column and the filter stay the same so running an analysis again does not convert the same data all over.
+struct RBridgeCachedColumn
+{
+	RBridgeColumn		column;
+	RBridgeColumnStamp	stamp;
+};
+
+static std::map<std::string, RBridgeCachedColumn>	rbridge_columnCache;	///< By requested type, obeyFilter and name, the rownumbers are kept under "rows" and "allRows"
+static unsigned int									rbridge_columnCacheIds = 0;
+static unsigned int									rbridge_columnCacheDataSet = 0;	///< DataSet::generation() of the dataset the cache was made from
+
+static void freeRBridgeColumn(RBridgeColumn & column)
+{
+	free(column.name);
+
+	if (column.sharedValues)	{} //Those point into the shared memory
+	else if (column.isScale)	free(column.doubles);
+	else						free(column.ints);
+
+	if (column.hasLabels)
+		freeLabels(column.labels, column.nbLabels);
+}
+
+///Copies the cached column into out if it is still up to date
+static bool rbridge_fromColumnCache(const std::string & key, const RBridgeColumnStamp & stamp, RBridgeColumn & out)
+{
+	auto cached = rbridge_columnCache.find(key);
+
+	if (cached == rbridge_columnCache.end() || !(cached->second.stamp == stamp))
+		return false;
+
+	out = cached->second.column;
+	return true;
+}
+
+///The cache takes ownership of column, whatever was kept under key before is freed and jaspRCPP forgets what it made of it
+static void rbridge_toColumnCache(const std::string & key, const RBridgeColumnStamp & stamp, RBridgeColumn & column)
+{
+	auto cached = rbridge_columnCache.find(key);
+
+	if (cached != rbridge_columnCache.end())
+	{
+		jaspRCPP_forgetConvertedColumn(cached->second.column.cacheId);
+		freeRBridgeColumn(cached->second.column);
+	}
+
+	column.cacheId				= ++rbridge_columnCacheIds;
+	rbridge_columnCache[key]	= { column, stamp };
+}
+
+///Copies the values of a column into out, leaving out the rows that are filtered away if obeyFilter, and returns the number of values copied. When every row passes this is a single bulk copy.
+template<typename T> static size_t rbridge_copyFilteredValues(const T * values, size_t rowCount, T * out, size_t outRows, bool obeyFilter)
+{
+	if(!obeyFilter || outRows == rowCount)
+	{
+		size_t copied = std::min(rowCount, outRows);
+		std::copy(values, values + copied, out);
+		return copied;
+	}
+
+	const FilterBits	& filter	= rbridge_dataSet->filterVector();
+	const uint64_t		* words		= filter.words();
+	size_t				rows		= std::min(rowCount, filter.size()),
+						outRow		= 0;
+
+	//Walk the filter a word at a time: whole words that pass are copied in one go and words that pass nothing are skipped
+	for(size_t word = 0, row = 0; row < rows && outRow < outRows; word++, row += 64)
+	{
+		size_t		inWord	= std::min<size_t>(64, rows - row);
+		uint64_t	bits	= words[word];
+
+		if(bits == 0)
+			continue;
+
+		if(inWord == 64 && bits == ~uint64_t(0) && outRow + 64 <= outRows)
+		{
+			std::copy(values + row, values + row + 64, out + outRow);
+			outRow += 64;
+		}
+		else
+			for(size_t bit = 0; bit < inWord && outRow < outRows; bit++)
+				if((bits >> bit) & 1)
+					out[outRow++] = values[row + bit];
+	}
+
+	return outRow;
+}
+
 extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHeaders, size_t colMax, bool obeyFilter)
 {
 	if (colHeaders == NULL)
@@ -243,23 +341,40 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 
 	Columns &columns = rbridge_dataSet->columns();
 
+	if (rbridge_dataSet->generation() != rbridge_columnCacheDataSet)
+	{
+		//The dataset was replaced, its columns can have the same storage and revisions as the old ones but are not the same
+		jaspRCPP_materializeSharedColumns();
+		freeRBridgeColumnCache();
+		rbridge_columnCacheDataSet = rbridge_dataSet->generation();
+	}
+
 	if (datasetStatic != NULL)
 		freeRBridgeColumns();
 
 	datasetColMax = colMax;
 	datasetStatic = static_cast<RBridgeColumn*>(calloc(datasetColMax + 1, sizeof(RBridgeColumn)));
 
-	size_t filteredRowCount = obeyFilter ? rbridge_dataSet->filteredRowCount() : rbridge_dataSet->rowCount();
+	size_t				filteredRowCount	= obeyFilter ? rbridge_dataSet->filteredRowCount() : rbridge_dataSet->rowCount();
+	unsigned int		filterRevision		= obeyFilter ? rbridge_dataSet->filterRevision() : 0;
+	std::string			rowsKey				= obeyFilter ? "rows" : "allRows";
+	RBridgeColumnStamp	rowsStamp			= { NULL, static_cast<unsigned int>(rbridge_dataSet->rowCount()), filterRevision };
 
 	// lets make some rownumbers/names for R that takes into account being filtered or not!
-	datasetStatic[colMax].ints		= filteredRowCount == 0 ? NULL : static_cast<int*>(calloc(filteredRowCount, sizeof(int)));
-	datasetStatic[colMax].nbRows	= filteredRowCount;
-	int filteredRow					= 0;
+	if (!rbridge_fromColumnCache(rowsKey, rowsStamp, datasetStatic[colMax]))
+	{
+		RBridgeColumn& rowNumbers	= datasetStatic[colMax];
+		rowNumbers.ints				= filteredRowCount == 0 ? NULL : static_cast<int*>(calloc(filteredRowCount, sizeof(int)));
+		rowNumbers.nbRows			= filteredRowCount;
 
-	for(size_t i=0; i<rbridge_dataSet->rowCount() && i<datasetStatic[colMax].nbRows; i++)
-		if(!obeyFilter || (rbridge_dataSet->filterVector().size() > i && rbridge_dataSet->filterVector()[i]))
-			datasetStatic[colMax].ints[filteredRow++] = int(i + 1); //R needs 1-based index
+		if(obeyFilter)
+			rbridge_dataSet->filterVector().rowNumbers(rbridge_dataSet->rowCount(), rowNumbers.ints, rowNumbers.nbRows);
+		else
+			for(size_t i=0; i<rowNumbers.nbRows; i++)
+				rowNumbers.ints[i] = int(i + 1); //R needs 1-based index
 
+		rbridge_toColumnCache(rowsKey, rowsStamp, rowNumbers);
+	}
 
 	for (int colNo = 0; colNo < colMax; colNo++)
 	{
@@ -267,8 +382,6 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 		RBridgeColumn& resultCol		= datasetStatic[colNo];
 
 		std::string columnName			= columnInfo.name;
-		resultCol.name					= strdup(Base64::encode("X", columnName, Base64::RVarEncoding).c_str());
-
 		Column &column					= columns.get(columnName);
 		Column::ColumnType columnType	= column.columnType();
 
@@ -276,6 +389,14 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 		if (requestedType == Column::ColumnTypeUnknown)
 			requestedType = columnType;
 
+		std::string			cacheKey	= std::to_string(int(requestedType)) + (obeyFilter ? "f" : "a") + columnName;
+		RBridgeColumnStamp	stamp		= { column.AsInts.data(), column.revision(), filterRevision };
+
+		if (rbridge_fromColumnCache(cacheKey, stamp, resultCol))
+			continue;
+
+		resultCol.name					= strdup(Base64::encode("X", columnName, Base64::RVarEncoding).c_str());
+
 		//int rowCount = column.rowCount();
 		resultCol.nbRows = filteredRowCount;
 		int rowNo = 0, dataSetRowNo = 0;
@@ -284,23 +405,20 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 		{
 			if (columnType == Column::ColumnTypeScale)
 			{
-				resultCol.isScale	= true;
-				resultCol.hasLabels	= false;
-				resultCol.doubles	= (double*)calloc(filteredRowCount, sizeof(double));
-
-				for(double value : column.AsDoubles)
-					if(rowNo < filteredRowCount && (!obeyFilter || rbridge_dataSet->filterVector()[dataSetRowNo++]))
-						resultCol.doubles[rowNo++] = value;
+				//Handed to R as is, jaspRCPP reads the filtered rows through the rownumbers instead of us copying them
+				resultCol.isScale		= true;
+				resultCol.hasLabels		= false;
+				resultCol.sharedValues	= true;
+				resultCol.doubles		= column.AsDoubles.data();
+				resultCol.nbValues		= column.rowCount();
 			}
 			else if (columnType == Column::ColumnTypeOrdinal || columnType == Column::ColumnTypeNominal)
 			{
-				resultCol.isScale	= false;
-				resultCol.hasLabels	= false;
-				resultCol.ints		= filteredRowCount == 0 ? NULL : static_cast<int*>(calloc(filteredRowCount, sizeof(int)));
-
-				for(int value : column.AsInts)
-					if(rowNo < filteredRowCount && (!obeyFilter || rbridge_dataSet->filterVector()[dataSetRowNo++]))
-						resultCol.ints[rowNo++] = value;
+				resultCol.isScale		= false;
+				resultCol.hasLabels		= false;
+				resultCol.sharedValues	= true;
+				resultCol.ints			= column.AsInts.data();
+				resultCol.nbValues		= column.rowCount();
 			}
 			else // columnType == Column::ColumnTypeNominalText
 			{
@@ -309,12 +427,7 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 				resultCol.isOrdinal = false;
 				resultCol.ints		= filteredRowCount == 0 ? NULL : static_cast<int*>(calloc(filteredRowCount, sizeof(int)));
 
-				for(int value : column.AsInts)
-					if(rowNo < filteredRowCount && (!obeyFilter || rbridge_dataSet->filterVector()[dataSetRowNo++]))
-					{
-						if (value == INT_MIN)	resultCol.ints[rowNo++] = INT_MIN;
-						else					resultCol.ints[rowNo++] = value;
-					}
+				rbridge_copyFilteredValues(column.AsInts.data(), column.rowCount(), resultCol.ints, filteredRowCount, obeyFilter);
 
 				resultCol.labels = rbridge_getLabels(column.labels(), resultCol.nbLabels);
 			}
@@ -328,19 +441,19 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 
 			if (columnType != Column::ColumnTypeScale)
 			{
-				std::map<int, int> indices;
-				int i = 1; // R starts indices from 1
-
 				const Labels &labels = column.labels();
 
-				for(const Label &label : labels)
-					indices[label.value()] = i++;
+				size_t copied = rbridge_copyFilteredValues(column.AsInts.data(), column.rowCount(), resultCol.ints, filteredRowCount, obeyFilter);
 
-				for(int value : column.AsInts)
-					if(rowNo < filteredRowCount && (!obeyFilter || rbridge_dataSet->filterVector()[dataSetRowNo++]))
+				for(size_t row = 0; row < copied; row++)
+					if (resultCol.ints[row] != INT_MIN)
 					{
-						if (value == INT_MIN)	resultCol.ints[rowNo++] = INT_MIN;
-						else					resultCol.ints[rowNo++] = indices.at(value);
+						int index = labels.indexOfKey(resultCol.ints[row]);
+
+						if(index < 0)
+							throw std::out_of_range("Value without label in column " + columnName);
+
+						resultCol.ints[row] = index + 1; // R starts indices from 1
 					}
 
 				resultCol.labels = rbridge_getLabels(labels, resultCol.nbLabels);
@@ -351,7 +464,6 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 				resultCol.isScale	= false;
 				resultCol.hasLabels = true;
 				resultCol.isOrdinal = false;
-				resultCol.ints		= filteredRowCount == 0 ? NULL : static_cast<int*>(calloc(filteredRowCount, sizeof(int)));
 
 				std::set<int> uniqueValues;
 
@@ -403,6 +515,8 @@ extern "C" RBridgeColumn* STDCALL rbridge_readDataSet(RBridgeColumnType* colHead
 				resultCol.labels = rbridge_getLabels(labels, resultCol.nbLabels);
 			}
 		}
+
+		rbridge_toColumnCache(cacheKey, stamp, resultCol);
 	}
 
 	return datasetStatic;
@@ -583,23 +697,29 @@ void freeRBridgeColumns()
 	if(datasetStatic == NULL)
 		return;
 
-	for (int i = 0; i < datasetColMax; i++)
-	{
-		RBridgeColumn& column = datasetStatic[i];
-		free(column.name);
-		if (column.isScale)	free(column.doubles);
-		else				free(column.ints);
+	for (int i = 0; i <= datasetColMax; i++)
+		if (datasetStatic[i].cacheId == 0) //Otherwise it belongs to rbridge_columnCache
+			freeRBridgeColumn(datasetStatic[i]);
 
-		if (column.hasLabels)
-			freeLabels(column.labels, column.nbLabels);
-	}
-	free(datasetStatic[datasetColMax].ints); //rownames/numbers
 	free(datasetStatic);
 
 	datasetStatic = NULL;
 	datasetColMax = 0;
 }
 
+void freeRBridgeColumnCache()
+{
+	freeRBridgeColumns();
+
+	for (auto & cached : rbridge_columnCache)
+	{
+		jaspRCPP_forgetConvertedColumn(cached.second.column.cacheId);
+		freeRBridgeColumn(cached.second.column);
+	}
+
+	rbridge_columnCache.clear();
+}
+
 void freeRBridgeColumnDescription(RBridgeColumnDescription* columns, size_t colMax)
 {
 	for (int i = 0; i < colMax; i++)
@@ -82,6 +82,7 @@ extern "C" {
 	std::string rbridge_check();
 
 	void freeRBridgeColumns();
+	void freeRBridgeColumnCache(); ///< Must be called before the dataset is unloaded
 	void freeRBridgeColumnDescription(RBridgeColumnDescription* columns, size_t colMax);
 	void freeLabels(char** labels, size_t nbLabels);
 
@@ -32,21 +32,25 @@ DEFINES += QT_DEPRECATED_WARNINGS
 
 SOURCES += \
     jasprcpp.cpp \
+    jasprcpp_sharedcolumns.cpp \
     RInside/MemBuf.cpp \
     RInside/RInside.cpp \
     rinside_consolelogging.cpp \
+    jaspResults/src/jaspColumn.cpp \
     jaspResults/src/jaspHtml.cpp \
     jaspResults/src/jaspObject.cpp \
     jaspResults/src/jaspJson.cpp \
     jaspResults/src/jaspContainer.cpp \
     jaspResults/src/jaspPlot.cpp \
     jaspResults/src/jaspResults.cpp \
+    jaspResults/src/jaspSerializedObject.cpp \
     jaspResults/src/jaspTable.cpp \
     jaspResults/src/jaspState.cpp
 
 HEADERS += \
     jasprcpp_interface.h \
     jasprcpp.h \
+    jasprcpp_sharedcolumns.h \
     RInside/Callbacks.h \
     RInside/MemBuf.h \
     RInside/RInside.h \
@@ -55,6 +59,7 @@ HEADERS += \
     RInside/RInsideConfig.h \
     RInside/RInsideEnvVars.h \
     rinside_consolelogging.h \
+    jaspResults/src/jaspColumn.h \
     jaspResults/src/jaspHtml.h \
     jaspResults/src/jaspObject.h \
     jaspResults/src/jaspJson.h \
@@ -64,6 +69,7 @@ HEADERS += \
     jaspResults/src/jaspResults.h \
     jaspResults/src/jaspTable.h \
     jaspResults/src/jaspModuleRegistration.h \
+    jaspResults/src/jaspSerializedObject.h \
     jaspResults/src/jaspState.h
 
 
@@ -0,0 +1,206 @@
+#include "jaspColumn.h"
+
+Json::Value jaspColumn::at(size_t row) const
+{
+	if(row >= _rows)
+		return Json::nullValue;
+
+	if(_type == jaspColumnType::various)
+		return _cells[row];
+
+	if(_type == jaspColumnType::null || _isNA[row])
+		return Json::nullValue;
+
+	switch(_type)
+	{
+	case jaspColumnType::logical:	return Json::Value(bool(_logicals[row]));
+	case jaspColumnType::integer:	return Json::Value(_integers[row]);
+	case jaspColumnType::number:	return Json::Value(_numbers[row]);
+	case jaspColumnType::string:	return Json::Value(_strings[row]);
+	default:						return Json::nullValue;
+	}
+}
+
+Json::ValueType jaspColumn::cellType(size_t row) const
+{
+	if(row >= _rows)							return Json::nullValue;
+	if(_type == jaspColumnType::various)		return _cells[row].type();
+	if(_type == jaspColumnType::null || _isNA[row])	return Json::nullValue;
+
+	switch(_type)
+	{
+	case jaspColumnType::logical:	return Json::booleanValue;
+	case jaspColumnType::integer:	return Json::intValue;
+	case jaspColumnType::number:	return Json::realValue;
+	case jaspColumnType::string:	return Json::stringValue;
+	default:						return Json::nullValue;
+	}
+}
+
+void jaspColumn::clear()
+{
+	_type = jaspColumnType::null;
+	_rows = 0;
+
+	_isNA.clear();
+	_logicals.clear();
+	_integers.clear();
+	_numbers.clear();
+	_strings.clear();
+	_cells.clear();
+}
+
+void jaspColumn::reserve(size_t rows)
+{
+	switch(_type)
+	{
+	case jaspColumnType::various:	_cells.reserve(rows);		return;
+	case jaspColumnType::logical:	_logicals.reserve(rows);	break;
+	case jaspColumnType::integer:	_integers.reserve(rows);	break;
+	case jaspColumnType::number:	_numbers.reserve(rows);		break;
+	case jaspColumnType::string:	_strings.reserve(rows);		break;
+	case jaspColumnType::null:									break;
+	}
+
+	_isNA.reserve(rows);
+}
+
+void jaspColumn::resize(size_t rows)
+{
+	if(rows < _rows)
+	{
+		switch(_type)
+		{
+		case jaspColumnType::various:	_cells.resize(rows);	break;
+		case jaspColumnType::logical:	_logicals.resize(rows);	break;
+		case jaspColumnType::integer:	_integers.resize(rows);	break;
+		case jaspColumnType::number:	_numbers.resize(rows);	break;
+		case jaspColumnType::string:	_strings.resize(rows);	break;
+		case jaspColumnType::null:								break;
+		}
+
+		if(_type != jaspColumnType::various)
+			_isNA.resize(rows);
+
+		_rows = rows;
+	}
+
+	reserve(rows);
+
+	while(_rows < rows)
+		appendNA();
+}
+
+void jaspColumn::appendNA()
+{
+	switch(_type)
+	{
+	case jaspColumnType::various:	_cells.push_back(Json::nullValue);	break;
+	case jaspColumnType::logical:	_logicals.push_back(false);			break;
+	case jaspColumnType::integer:	_integers.push_back(0);				break;
+	case jaspColumnType::number:	_numbers.push_back(0.0);			break;
+	case jaspColumnType::string:	_strings.push_back("");				break;
+	case jaspColumnType::null:											break;
+	}
+
+	if(_type != jaspColumnType::various)
+		_isNA.push_back(true);
+
+	_rows++;
+}
+
+void jaspColumn::push_back(const Json::Value & cell)
+{
+	switch(cell.type())
+	{
+	case Json::nullValue:		appendNA();						return;
+	case Json::booleanValue:	appendLogical(cell.asBool());	return;
+	case Json::intValue:		appendInteger(cell.asInt());	return;
+	case Json::realValue:		appendNumber(cell.asDouble());	return;
+	case Json::stringValue:		appendString(cell.asString());	return;
+	default:					break;
+	}
+
+	//unsigned, arrays and objects are kept as they are
+	prepareFor(jaspColumnType::various);
+	_cells.push_back(cell);
+	_rows++;
+}
+
+void jaspColumn::append(const jaspColumn & other)
+{
+	reserve(_rows + other._rows);
+
+	for(size_t row=0; row<other._rows; row++)
+		if(other._type == jaspColumnType::various)			push_back(other._cells[row]);
+		else if(other._type == jaspColumnType::null || other._isNA[row])	appendNA();
+		else
+			switch(other._type)
+			{
+			case jaspColumnType::logical:	appendLogical(other._logicals[row]);	break;
+			case jaspColumnType::integer:	appendInteger(other._integers[row]);	break;
+			case jaspColumnType::number:	appendNumber(other._numbers[row]);		break;
+			case jaspColumnType::string:	appendString(other._strings[row]);		break;
+			default:																break;
+			}
+}
+
+void jaspColumn::appendRObject(Rcpp::RObject obj)
+{
+	if(Rcpp::is<Rcpp::NumericVector>(obj))			appendRcpp<REALSXP>((Rcpp::NumericVector)		obj);
+	else if(Rcpp::is<Rcpp::LogicalVector>(obj))		appendRcpp<LGLSXP>((Rcpp::LogicalVector)		obj);
+	else if(Rcpp::is<Rcpp::IntegerVector>(obj))		appendRcpp<INTSXP>((Rcpp::IntegerVector)		obj);
+	else if(Rcpp::is<Rcpp::StringVector>(obj))		appendRcpp<STRSXP>((Rcpp::StringVector)			obj);
+	else if(Rcpp::is<Rcpp::CharacterVector>(obj))	appendRcpp<STRSXP>((Rcpp::CharacterVector)		obj);
+	else if(Rcpp::is<Rcpp::List>(obj))
+	{
+		Rcpp::List list = (Rcpp::List)obj;
+		reserve(_rows + list.size());
+
+		for(int row=0; row<list.size(); row++)
+			push_back(jaspJson::RObject_to_JsonValue((Rcpp::RObject)list[row]));
+	}
+	else Rf_error("jaspColumn::appendRObject received an SEXP that is not a Vector of some kind.");
+}
+
+///Makes sure the next cell can be of this type, a column without any cells yet simply takes it.
+void jaspColumn::prepareFor(jaspColumnType type)
+{
+	if(type == _type || _type == jaspColumnType::various)
+		return;
+
+	if(_type != jaspColumnType::null)
+	{
+		makeVarious();
+		return;
+	}
+
+	_type = type;
+
+	switch(_type)
+	{
+	case jaspColumnType::logical:	_logicals.resize(_rows);	break;
+	case jaspColumnType::integer:	_integers.resize(_rows);	break;
+	case jaspColumnType::number:	_numbers.resize(_rows);		break;
+	case jaspColumnType::string:	_strings.resize(_rows);		break;
+	case jaspColumnType::various:	_cells.resize(_rows);		_isNA.clear();	break;
+	case jaspColumnType::null:									break;
+	}
+}
+
+void jaspColumn::makeVarious()
+{
+	std::vector<Json::Value> cells;
+	cells.reserve(_rows);
+
+	for(size_t row=0; row<_rows; row++)
+		cells.push_back(at(row));
+
+	size_t rows = _rows;
+
+	clear();
+
+	_type	= jaspColumnType::various;
+	_rows	= rows;
+	_cells.swap(cells);
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include "jaspJson.h"
+
+///The types a jaspColumn can store its cells as, various means they are kept as Json::Values
+enum class jaspColumnType { null, logical, integer, number, string, various };
+
+///A column of cells for jaspTable. As long as all cells (apart from NA/null) have the same type they are kept in one typed buffer with an NA mask next to it.
+///Once a cell of another type is added the column turns into Json::Values, so the cells always come out exactly the way they came in.
+class jaspColumn
+{
+public:
+	jaspColumn() {}
+	jaspColumn(const std::vector<Json::Value> & cells)	{ reserve(cells.size()); for(const Json::Value & cell : cells) push_back(cell); }
+
+	size_t			size()		const	{ return _rows; }
+	jaspColumnType	type()		const	{ return _type; }
+
+	Json::Value		operator[](size_t row)	const	{ return at(row); }
+	Json::Value		at(size_t row)			const;
+	Json::ValueType	cellType(size_t row)	const;
+
+	void			clear();
+	void			reserve(size_t rows);
+	void			resize(size_t rows); ///< Pads with NA
+
+	void			appendNA();
+	void			appendLogical(bool value)					{ appendValue(jaspColumnType::logical,	_logicals,	value); }
+	void			appendInteger(int value)					{ appendValue(jaspColumnType::integer,	_integers,	value); }
+	void			appendNumber(double value)					{ appendValue(jaspColumnType::number,	_numbers,	value); }
+	void			appendString(const std::string & value)		{ appendValue(jaspColumnType::string,	_strings,	value); }
+	void			push_back(const Json::Value & cell);
+	void			append(const jaspColumn & other);
+
+	///Accepts the same as jaspJson::RcppVector_to_VectorJson, so vectors and lists
+	void								appendRObject(Rcpp::RObject obj);
+	template<int RTYPE>	void			appendRcpp(Rcpp::Vector<RTYPE> vec)		{ reserve(_rows + vec.size()); for(int row=0; row<vec.size(); row++) appendNA(); }
+
+	static jaspColumn					fromCell(const Json::Value & cell)		{ jaspColumn col; col.push_back(cell);			return col; }
+	static jaspColumn					fromRObject(Rcpp::RObject obj)			{ jaspColumn col; col.appendRObject(obj);		return col; }
+	template<int RTYPE>	static jaspColumn	fromRcpp(Rcpp::Vector<RTYPE> vec)	{ jaspColumn col; col.appendRcpp<RTYPE>(vec);	return col; }
+
+	template<int RTYPE>	static std::vector<jaspColumn> fromRcppMatrix(Rcpp::Matrix<RTYPE> mat)
+	{
+		std::vector<jaspColumn> cols(mat.ncol());
+
+		for(int col=0; col<mat.ncol(); col++)
+			cols[col].appendRcpp<RTYPE>(Rcpp::Vector<RTYPE>(mat.column(col)));
+
+		return cols;
+	}
+
+private:
+	void				prepareFor(jaspColumnType type);
+	void				makeVarious();
+
+	template<typename T> void appendValue(jaspColumnType type, std::vector<T> & buffer, const T & value)
+	{
+		prepareFor(type);
+
+		if(_type == jaspColumnType::various)
+			_cells.push_back(Json::Value(value));
+		else
+		{
+			buffer.push_back(value);
+			_isNA.push_back(false);
+		}
+
+		_rows++;
+	}
+
+	jaspColumnType				_type = jaspColumnType::null;
+	size_t						_rows = 0;
+	std::vector<bool>			_isNA,			///< Not used for various
+								_logicals;
+	std::vector<int>			_integers;
+	std::vector<double>			_numbers;
+	std::vector<std::string>	_strings;
+	std::vector<Json::Value>	_cells;			///< Only used for various
+};
+
+template<> inline void jaspColumn::appendRcpp<REALSXP>(Rcpp::Vector<REALSXP> vec)
+{
+	const double * values = REAL(vec);
+	reserve(_rows + vec.size());
+
+	for(int row=0; row<vec.size(); row++)
+		if(R_IsNA(values[row]))	appendNA();
+		else					appendNumber(values[row]);
+}
+
+template<> inline void jaspColumn::appendRcpp<INTSXP>(Rcpp::Vector<INTSXP> vec)
+{
+	const int * values = INTEGER(vec);
+	reserve(_rows + vec.size());
+
+	for(int row=0; row<vec.size(); row++)
+		if(values[row] == NA_INTEGER)	appendNA();
+		else							appendInteger(values[row]);
+}
+
+template<> inline void jaspColumn::appendRcpp<LGLSXP>(Rcpp::Vector<LGLSXP> vec)
+{
+	const int * values = LOGICAL(vec);
+	reserve(_rows + vec.size());
+
+	for(int row=0; row<vec.size(); row++)
+		if(values[row] == NA_LOGICAL)	appendNA();
+		else							appendLogical(values[row] != 0);
+}
+
+template<> inline void jaspColumn::appendRcpp<STRSXP>(Rcpp::Vector<STRSXP> vec)
+{
+	reserve(_rows + vec.size());
+
+	for(int row=0; row<vec.size(); row++)
+	{
+		SEXP value = STRING_ELT(vec, row);
+
+		if(value == NA_STRING)	appendNA();
+		else					appendString(CHAR(value));
+	}
+}
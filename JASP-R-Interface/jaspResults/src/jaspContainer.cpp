@@ -164,13 +164,20 @@ Json::Value jaspContainer::metaEntry()
 	return meta;
 }
 
-Json::Value jaspContainer::dataEntry()
+Json::Value jaspContainer::dataEntryWithoutCollection()
 {
 	Json::Value dataJson(jaspObject::dataEntry());
 
 	dataJson["title"] = _title;
 	dataJson["name"] = getUniqueNestedName();
 
+	return dataJson;
+}
+
+Json::Value jaspContainer::dataEntry()
+{
+	Json::Value dataJson(dataEntryWithoutCollection());
+
 	Json::Value collection(Json::objectValue);
 
 	for(std::string field: getSortedDataFields())
@@ -202,6 +209,70 @@ void jaspContainer::childFinalizedHandler(jaspObject *child)
 
 }
 
+void jaspContainer::collectObjectsInResults(jaspSentObjects & collectHere, Json::Value path)
+{
+	for(auto keyval : _data)
+	{
+		jaspObject * obj = keyval.second;
+
+		if(!obj->shouldBePartOfResultsJson())
+			continue;
+
+		std::string name	= obj->getUniqueNestedName();
+		Json::Value objPath	= path;
+		objPath.append(name);
+
+		collectHere[name] = { obj, objPath };
+
+		if(obj->getType() == jaspObjectType::container)
+			static_cast<jaspContainer*>(obj)->collectObjectsInResults(collectHere, objPath);
+	}
+}
+
+///Objects that were not sent before, or were replaced, go into "added" with all their data. Changed containers only send their own fields because their children are checked separately.
+void jaspContainer::addChangesToPatch(Json::Value & patch, const jaspSentObjects & sent, Json::Value path)
+{
+	for(auto keyval : _data)
+	{
+		jaspObject * obj = keyval.second;
+
+		if(!obj->shouldBePartOfResultsJson())
+			continue;
+
+		std::string name	= obj->getUniqueNestedName();
+		Json::Value objPath	= path;
+		objPath.append(name);
+
+		Json::Value entry(Json::objectValue);
+		entry["path"] = objPath;
+
+		auto sentObj = sent.find(name);
+
+		if(sentObj == sent.end() || sentObj->second.object != obj)
+		{
+			entry["data"] = obj->dataEntry();
+			patch["added"].append(entry);
+		}
+		else if(obj->getType() == jaspObjectType::container)
+		{
+			jaspContainer * container = static_cast<jaspContainer*>(obj);
+
+			if(container->hasUnsentChanges())
+			{
+				entry["data"] = container->dataEntryWithoutCollection();
+				patch["changed"].append(entry);
+			}
+
+			container->addChangesToPatch(patch, sent, objPath);
+		}
+		else if(obj->hasUnsentChanges())
+		{
+			entry["data"] = obj->dataEntry();
+			patch["changed"].append(entry);
+		}
+	}
+}
+
 void jaspContainer::completeChildren()
 {
 	for(auto keyval : _data)
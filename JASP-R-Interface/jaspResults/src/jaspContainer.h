@@ -7,7 +7,14 @@
 #include "jaspHtml.h"
 #include <map>
 
+///What jaspResults remembers of an object it sent to the desktop, keyed by its nested name
+struct jaspSentObject
+{
+	jaspObject	*	object;
+	Json::Value		path; ///Nested names of the containers leading to the object, followed by its own
+};
 
+typedef std::map<std::string, jaspSentObject> jaspSentObjects;
 
 class jaspContainer : public jaspObject
 {
@@ -44,6 +51,8 @@ public:
 
 	void		completeChildren();
 
+	void		collectObjectsInResults(jaspSentObjects & collectHere, Json::Value path = Json::arrayValue);
+	void		addChangesToPatch(Json::Value & patch, const jaspSentObjects & sent, Json::Value path = Json::arrayValue);
 
 protected:
 	std::map<std::string, jaspObject*>	_data;
@@ -51,6 +60,7 @@ protected:
 	int									_order_increment = 0;
 
 	std::vector<std::string>			getSortedDataFields();
+	Json::Value							dataEntryWithoutCollection();
 
 };
 
@@ -75,6 +75,8 @@ void jaspHtml::convertFromJSON_SetFields(Json::Value in)
 
 void jaspHtml::setText(std::string newRawText) {
     _rawText 	= newRawText;
+
+	notifyParentOfChanges();
 }
 
 std::string jaspHtml::getText() {
@@ -150,6 +150,8 @@ void jaspObject::notifyParentOfChanges()
 	std::cout << "notifyParentOfChanges()! parent is " << ( parent == NULL ? "NULL" : parent->title) << "\n" << std::flush;
 #endif
 
+	_unsentChanges = true;
+
 	if(parent != NULL)
 		parent->childrenUpdatedCallback();
 }
@@ -109,6 +109,10 @@ public:
 
 	void			notifyParentOfChanges(); ///let ancestors know about updates
 
+	virtual	bool	hasUnsentChanges()	const	{ return _unsentChanges;	}
+	virtual	void	setChangesSent()			{ _unsentChanges = false;	}
+			void	setUnsentChanges()			{ _unsentChanges = true;	} ///For changes that should not trigger a send by themselves
+
 protected:
 	jaspObjectType				_type;
 	std::string					_warning = "";
@@ -138,7 +142,8 @@ protected:
 	static std::set<jaspObject*> * allocatedObjects;
 
 private:
-	bool					_finalizedAlready = false;
+	bool					_finalizedAlready	= false,
+							_unsentChanges		= true; ///Whether jaspResults should include this object in the next patch it sends
 };
 
 
@@ -19,7 +19,7 @@ std::string jaspPlot::dataToString(std::string prefix)
 		prefix << "error:       '"	<< _error << "': '" << _errorMessage << "'\n" <<
 		prefix << "filePath:    "	<< _filePathPng << "\n" <<
 		prefix << "status:      "	<< _status << "\n" <<
-		prefix << "has plot:    "	<< (_plotObjSerialized.size() > 0 ? "yes" : "no") << "\n";
+		prefix << "has plot:    "	<< (!_plotObj.empty() ? "yes" : "no") << "\n";
 
 	if(_footnotes.size() > 0)
 	{
@@ -64,6 +64,8 @@ void jaspPlot::addFootnote(std::string message, std::string symbol)
 	footnote["rows"]	= Json::nullValue;
 
 	_footnotes.append(footnote);
+
+	notifyParentOfChanges();
 }
 
 
@@ -87,17 +89,14 @@ void jaspPlot::setPlotObject(Rcpp::RObject obj)
 	}
 
 
-	Rcpp::Function serialize("serialize");
-	_plotObjSerialized = serialize(Rcpp::_["object"] = obj, Rcpp::_["connection"] = R_NilValue, Rcpp::_["ascii"] = true);
+	_plotObj.set(obj);
+
+	setUnsentChanges();
 }
 
 Rcpp::RObject jaspPlot::getPlotObject()
 {
-	if(_plotObjSerialized.size() == 0)
-		return NULL;
-
-	Rcpp::Function unserialize("unserialize");
-	return unserialize(_plotObjSerialized);
+	return _plotObj.get();
 }
 
 Json::Value jaspPlot::convertToJSON()
@@ -112,7 +111,7 @@ Json::Value jaspPlot::convertToJSON()
 	obj["errorMessage"]			= _errorMessage;
 	obj["filePathPng"]			= _filePathPng;
 	obj["footnotes"]			= _footnotes;
-	obj["plotObjSerialized"]	= std::string(_plotObjSerialized.begin(), _plotObjSerialized.end());
+	obj["plotObjPayload"]		= _plotObj.convertToJSON();
 
 
 	return obj;
@@ -131,8 +130,8 @@ void jaspPlot::convertFromJSON_SetFields(Json::Value in)
 	_filePathPng	= in.get("filePathPng",		"null").asString();
 	_footnotes		= in.get("footnotes",		Json::arrayValue);
 
-	std::string jsonPlotObjStr = in.get("plotObjSerialized", "").asString();
-	_plotObjSerialized = Rcpp::Vector<RAWSXP>(jsonPlotObjStr.begin(), jsonPlotObjStr.end());
+	if(in.isMember("plotObjPayload"))	_plotObj.convertFromJSON(in["plotObjPayload"]);
+	else								_plotObj.setSerialized(in.get("plotObjSerialized", "").asString());
 }
 
 std::string jaspPlot::toHtml()
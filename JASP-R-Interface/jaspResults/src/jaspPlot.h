@@ -1,5 +1,6 @@
 #pragma once
 #include "jaspObject.h"
+#include "jaspSerializedObject.h"
 
 class jaspPlot : public jaspObject
 {
@@ -28,7 +29,7 @@ public:
 	void		convertFromJSON_SetFields(Json::Value in) override;
 
 private:
-	Rcpp::Vector<RAWSXP> _plotObjSerialized;
+	jaspSerializedObject _plotObj;
 	Json::Value _footnotes = Json::arrayValue;
 };
 
@@ -3,14 +3,27 @@
 #include <chrono>
 #include <fstream>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
 
 sendFuncDef			jaspResults::ipccSendFunc = NULL;
 pollMessagesFuncDef jaspResults::ipccPollFunc = NULL;
 std::string			jaspResults::_saveResultsHere = "";
+jaspResults *		jaspResults::_runningResults = nullptr;
 std::string			jaspResults::_baseCitation = "";
 
 const std::string jaspResults::analysisChangedErrorMessage = "Analysis changed and will be restarted!";
 
+///The state file starts with these bytes, then the size of the index, the index as json and all the serialized R objects of jaspState and jaspPlot as they are.
+static const char stateFileMagic[8] = { 'J', 'A', 'S', 'P', 'R', 'E', 'S', 2 };
+
+///Without any indentation, the results are written (and read by the desktop) a lot faster than with toStyledString()
+static std::string compactJson(const Json::Value & json)
+{
+	return Json::FastWriter().write(json);
+}
+
 void jaspResults::setSendFunc(sendFuncDef sendFunc)
 {
 	ipccSendFunc = sendFunc;
@@ -67,13 +80,18 @@ void jaspResults::saveResults()
 		return;
 	}
 
-	std::ofstream saveHere(_saveResultsHere);
+	jaspSerializedObject::payloadsToWrite.clear();
+
+	std::string index		= compactJson(convertToJSON());
+	uint64_t	indexSize	= index.size();
 
-	Json::Value json = convertToJSON();
+	std::ofstream saveHere(_saveResultsHere, std::ios::binary);
 
-	//std::cout << "jaspResults JSON:\n\n" << json.toStyledString();
+	saveHere.write(stateFileMagic, sizeof(stateFileMagic));
+	saveHere.write(reinterpret_cast<const char*>(&indexSize), sizeof(indexSize));
+	saveHere << index << jaspSerializedObject::payloadsToWrite;
 
-	saveHere << json.toStyledString();
+	std::string().swap(jaspSerializedObject::payloadsToWrite);
 }
 
 void jaspResults::loadResults()
@@ -82,17 +100,120 @@ void jaspResults::loadResults()
 
 	if(_saveResultsHere == "") return;
 
-	std::ifstream loadThis(_saveResultsHere);
+	std::shared_ptr<const std::string>	payloads;
+	Json::Value							val = readStateFile(_saveResultsHere, &payloads);
+
+	jaspSerializedObject::payloadsRead = payloads;
+
+	if(val.isObject())
+		convertFromJSON_SetFields(val);
+
+	jaspSerializedObject::payloadsRead = nullptr;
+}
+
+///Gives the index of a state file, the payloads are only read if asked for
+Json::Value jaspResults::readStateFile(const std::string & stateFile, std::shared_ptr<const std::string> * payloadsOut)
+{
+	std::ifstream loadThis(stateFile, std::ios::binary);
 
-	if(!loadThis.is_open()) return;
+	if(!loadThis.is_open()) return Json::nullValue;
 
 	Json::Value val;
+	char		magic[sizeof(stateFileMagic)];
+
+	if(loadThis.read(magic, sizeof(magic)) && std::equal(magic, magic + sizeof(magic), stateFileMagic))
+	{
+		uint64_t indexSize = 0;
+		loadThis.read(reinterpret_cast<char*>(&indexSize), sizeof(indexSize));
+
+		std::string index(indexSize, '\0');
+		loadThis.read(&index[0], indexSize);
 
-	Json::Reader().parse(loadThis, val);
+		if(!loadThis) return Json::nullValue;
 
-	if(!val.isObject()) return;
+		if(payloadsOut != nullptr)
+		{
+			//The payloads are read as they are, they only get unserialized when jaspState::getObject() or jaspPlot::getPlotObject() asks for them
+			std::streampos payloadsStart = loadThis.tellg();
+			loadThis.seekg(0, std::ios::end);
 
-	convertFromJSON_SetFields(val);
+			auto payloads = std::make_shared<std::string>(size_t(loadThis.tellg() - payloadsStart), '\0');
+			loadThis.seekg(payloadsStart);
+			loadThis.read(&(*payloads)[0], payloads->size());
+
+			if(!loadThis) return Json::nullValue;
+
+			*payloadsOut = payloads;
+		}
+
+		Json::Reader().parse(index, val);
+	}
+	else //A state file from before the binary format, it is all json
+	{
+		loadThis.clear();
+		loadThis.seekg(0);
+		Json::Reader().parse(loadThis, val);
+	}
+
+	return val;
+}
+
+///Looks for the table with this (nested) name in a state file and gives the rows from "from" onwards as json, or null if there is no such table.
+std::string jaspResults::tablePageFromStateFile(const std::string & stateFile, const std::string & tableName, size_t from, size_t count)
+{
+	std::function<const Json::Value *(const Json::Value &, const std::string &)> findTable = [&](const Json::Value & obj, const std::string & prefix) -> const Json::Value *
+	{
+		const Json::Value & data = obj["data"];
+
+		if(!data.isObject())
+			return nullptr;
+
+		for(auto it = data.begin(); it != data.end(); ++it)
+		{
+			const Json::Value	&	child	= *it;
+			std::string				name	= prefix + child.get("name", "").asString();
+
+			if(child.get("type", "").asString() == jaspObjectTypeToString(jaspObjectType::table))
+			{
+				if(name == tableName)
+					return &child;
+			}
+			else if(const Json::Value * found = findTable(child, name == "" ? "" : name + "_"))
+				return found;
+		}
+
+		return nullptr;
+	};
+
+	Json::Value			state	= readStateFile(stateFile);
+	const Json::Value *	found	= state.isObject() ? findTable(state, "") : nullptr;
+
+	if(found == nullptr)
+		return "null";
+
+	jaspTable * table = static_cast<jaspTable*>(jaspObject::convertFromJSON(*found));
+	std::string	page  = compactJson(table->rowsJson(from, count));
+
+	delete table;
+
+	return page;
+}
+
+///Like tablePageFromStateFile() but from the jaspResults that R is filling right now
+std::string jaspResults::tablePageFromRunningResults(const std::string & tableName, size_t from, size_t count)
+{
+	if(_runningResults == nullptr)
+		return "null";
+
+	jaspSentObjects objects;
+	_runningResults->collectObjectsInResults(objects);
+
+	auto found = objects.find(tableName);
+
+	if(found == objects.end() || found->second.object->getType() != jaspObjectType::table)
+		return "null";
+
+	return compactJson(static_cast<jaspTable*>(found->second.object)->rowsJson(from, count));
 }
 
 void jaspResults::changeOptions(std::string opts)
@@ -122,8 +243,29 @@ void jaspResults::send(std::string otherMsg)
 	JASPprint("send was called!");
 #endif
 
-	if(ipccSendFunc != NULL)
-		(*ipccSendFunc)(otherMsg == "" ? constructResultJson() : otherMsg.c_str());
+	if(ipccSendFunc == NULL)
+		return;
+
+	if(otherMsg != "")
+	{
+		(*ipccSendFunc)(otherMsg.c_str());
+		return;
+	}
+
+	//While running only what changed since the previous send goes to the desktop, anything else gets the full results so the desktop always ends up with all of them
+	bool			sendPatch = _resultsSentAlready && getStatus() == "running";
+	jaspSentObjects	inResults;
+
+	collectObjectsInResults(inResults);
+
+	(*ipccSendFunc)(sendPatch ? constructResultPatchJson(inResults) : constructResultJson());
+
+	setChangesSent();
+	for(auto & sentObj : inResults)
+		sentObj.second.object->setChangesSent();
+
+	_sentObjects.swap(inResults);
+	_resultsSentAlready = true;
 }
 
 void jaspResults::checkForAnalysisChanged()
@@ -156,6 +298,7 @@ const char * jaspResults::constructResultJson()
 	response["typeRequest"]	= "analysis"; // Should correspond to engineState::analysis to string
 	response["results"]		= dataEntry();
 	response["name"]		= response["results"]["title"];
+	response.removeMember("resultsPatch");
 
 	if(errorMessage != "")
 	{
@@ -164,7 +307,7 @@ const char * jaspResults::constructResultJson()
 	}
 
 	static std::string msg;
-	msg = response.toStyledString();
+	msg = compactJson(response);
 
 #ifdef JASP_RESULTS_DEBUG_TRACES
 	std::cout << "Result JSON:\n" << msg << "\n\n" << std::flush;
@@ -173,6 +316,44 @@ const char * jaspResults::constructResultJson()
 	return msg.c_str();
 }
 
+///The patch has the fields of jaspResults itself, the objects that were added or changed with the path to them and the paths of the removed ones.
+const char * jaspResults::constructResultPatchJson(const jaspSentObjects & inResults)
+{
+	Json::Value patch(Json::objectValue), fields(jaspObject::dataEntry());
+
+	fields["title"]		= _title;
+	fields[".meta"]		= metaEntry();
+
+	patch["fields"]		= fields;
+	patch["added"]		= Json::arrayValue;
+	patch["changed"]	= Json::arrayValue;
+	patch["removed"]	= Json::arrayValue;
+
+	addChangesToPatch(patch, _sentObjects);
+
+	for(auto & sentObj : _sentObjects)
+	{
+		const Json::Value & path = sentObj.second.path;
+
+		if(inResults.count(sentObj.first) == 0 && (path.size() == 1 || inResults.count(path[path.size() - 2].asString()) > 0)) //Removing the topmost object is enough
+			patch["removed"].append(path);
+	}
+
+	response["typeRequest"]		= "analysis";
+	response["resultsPatch"]	= patch;
+	response["name"]			= _title;
+	response.removeMember("results");
+
+	static std::string msg;
+	msg = compactJson(response);
+
+#ifdef JASP_RESULTS_DEBUG_TRACES
+	std::cout << "Result patch JSON:\n" << msg << "\n\n" << std::flush;
+#endif
+
+	return msg.c_str();
+}
+
 Json::Value jaspResults::metaEntry()
 {
 	Json::Value meta(Json::arrayValue);
@@ -21,8 +21,12 @@ public:
 
 		if(_saveResultsHere != "")
 			loadResults();
+
+		_runningResults = this;
 	}
 
+	~jaspResults() { if(_runningResults == this) _runningResults = nullptr; }
+
 	//static functions to allow the values to be set before the constructor is called from R. Would be nicer to just run the constructor in C++ maybe?
 	static void setSendFunc(sendFuncDef sendFunc);
 	static void setPollMessagesFunc(pollMessagesFuncDef pollFunc);
@@ -36,6 +40,7 @@ public:
 	std::string getStatus();
 
 	const char *	constructResultJson();
+	const char *	constructResultPatchJson(const jaspSentObjects & inResults);
 	Json::Value		metaEntry() override;
 	Json::Value		dataEntry() override;
 
@@ -46,6 +51,10 @@ public:
 	void saveResults();
 
 	void loadResults();
+
+	static Json::Value	readStateFile(const std::string & stateFile, std::shared_ptr<const std::string> * payloadsOut = nullptr);
+	static std::string	tablePageFromStateFile(const std::string & stateFile, const std::string & tableName, size_t from, size_t count);
+	static std::string	tablePageFromRunningResults(const std::string & tableName, size_t from, size_t count);
 	void setErrorMessage(std::string msg);
 	void changeOptions(std::string opts);
 	void setOptions(std::string opts);
@@ -72,12 +81,16 @@ private:
 	static pollMessagesFuncDef ipccPollFunc;
 	static std::string _saveResultsHere;
 	static std::string _baseCitation;
+	static jaspResults * _runningResults; ///< The state file is only written on complete(), so while an analysis runs its pages come from here
 
 	std::string errorMessage = "";
 	static const std::string analysisChangedErrorMessage;
 	Json::Value	_currentOptions		= Json::nullValue,
 				_previousOptions	= Json::nullValue;
 
+	jaspSentObjects	_sentObjects;					///What the desktop has received, so send() only has to pass on the changes
+	bool			_resultsSentAlready = false;
+
 	void addSerializedPlotObjsForStateFromJaspObject(jaspObject * obj, Rcpp::List & pngImgObj);
 	void addPlotPathsForKeepFromJaspObject(jaspObject * obj, Rcpp::List & pngPathImgObj);
 
@@ -0,0 +1,73 @@
+#include "jaspSerializedObject.h"
+#include <cstring>
+
+std::string							jaspSerializedObject::payloadsToWrite	= "";
+std::shared_ptr<const std::string>	jaspSerializedObject::payloadsRead		= nullptr;
+
+void jaspSerializedObject::set(Rcpp::RObject obj)
+{
+	Rcpp::Function serialize("serialize");
+
+	_payloads	= nullptr;
+	_serialized	= serialize(Rcpp::_["object"] = obj, Rcpp::_["connection"] = R_NilValue, Rcpp::_["ascii"] = false);
+}
+
+Rcpp::RObject jaspSerializedObject::get()
+{
+	if(empty())
+		return NULL;
+
+	if(_payloads)
+	{
+		Rcpp::Vector<RAWSXP> serialized(_size);
+		std::memcpy(RAW(serialized), _payloads->data() + _offset, _size);
+
+		_serialized	= serialized;
+		_payloads	= nullptr;
+	}
+
+	Rcpp::Function unserialize("unserialize");
+	return unserialize(_serialized);
+}
+
+void jaspSerializedObject::clear()
+{
+	_serialized	= Rcpp::Vector<RAWSXP>();
+	_payloads	= nullptr;
+	_offset		= 0;
+	_size		= 0;
+}
+
+Json::Value jaspSerializedObject::convertToJSON() const
+{
+	Json::Value payload(Json::objectValue);
+
+	payload["offset"]	= double(payloadsToWrite.size()); //double because Json::UInt is only 32 bits
+	payload["size"]		= double(size());
+
+	if(_payloads)	payloadsToWrite.append(_payloads->data() + _offset, _size);
+	else			payloadsToWrite.append(reinterpret_cast<const char*>(RAW(_serialized)), _serialized.size());
+
+	return payload;
+}
+
+void jaspSerializedObject::convertFromJSON(Json::Value in)
+{
+	clear();
+
+	size_t	offset	= in.get("offset",	0).asDouble(),
+			size	= in.get("size",	0).asDouble();
+
+	if(size == 0 || !payloadsRead || offset + size > payloadsRead->size())
+		return;
+
+	_payloads	= payloadsRead;
+	_offset		= offset;
+	_size		= size;
+}
+
+void jaspSerializedObject::setSerialized(const std::string & serialized)
+{
+	clear();
+	_serialized = Rcpp::Vector<RAWSXP>(serialized.begin(), serialized.end());
+}
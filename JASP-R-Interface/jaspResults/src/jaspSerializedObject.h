@@ -0,0 +1,38 @@
+#pragma once
+#include <Rcpp.h>
+#include <memory>
+#include <string>
+#ifdef JASP_R_INTERFACE_LIBRARY
+#include "jsonredirect.h"
+#else
+#include "lib_json/json.h"
+#endif
+
+///A serialized R object as kept by jaspState and jaspPlot.
+///When it comes from the state file it is only a piece of the payloads read from it, it becomes an R vector when get() is actually called.
+///While jaspResults is saving or loading the state file the payloads go through payloadsToWrite and payloadsRead, the json only holds where they are.
+class jaspSerializedObject
+{
+public:
+	~jaspSerializedObject() { clear(); }
+
+	void			set(Rcpp::RObject obj);
+	Rcpp::RObject	get();
+
+	void			clear();
+	bool			empty()	const { return size() == 0; }
+	size_t			size()	const { return _payloads ? _size : _serialized.size(); }
+
+	Json::Value		convertToJSON() const;
+	void			convertFromJSON(Json::Value in);
+	void			setSerialized(const std::string & serialized); ///< For state files from before the payloads, where it was a string in the json
+
+	static std::string							payloadsToWrite;
+	static std::shared_ptr<const std::string>	payloadsRead;
+
+private:
+	Rcpp::Vector<RAWSXP>				_serialized;
+	std::shared_ptr<const std::string>	_payloads;		///< When set the object is still [_offset, _offset + _size) of these
+	size_t								_offset = 0,
+										_size	= 0;
+};
@@ -4,7 +4,7 @@ Json::Value jaspState::convertToJSON()
 {
 	Json::Value obj		= jaspObject::convertToJSON();
 
-	obj["ObjectSerialized"] = std::string(_stateObjectSerialized.begin(), _stateObjectSerialized.end());
+	obj["objectPayload"] = _stateObject.convertToJSON();
 
 	return obj;
 }
@@ -13,26 +13,19 @@ void jaspState::convertFromJSON_SetFields(Json::Value in)
 {
 	jaspObject::convertFromJSON_SetFields(in);
 
-	std::string jsonPlotObjStr = in.get("ObjectSerialized", "").asString();
-
-	_stateObjectSerialized = Rcpp::Vector<RAWSXP>(jsonPlotObjStr.begin(), jsonPlotObjStr.end());
+	if(in.isMember("objectPayload"))	_stateObject.convertFromJSON(in["objectPayload"]);
+	else								_stateObject.setSerialized(in.get("ObjectSerialized", "").asString());
 }
 
 
 void jaspState::setObject(Rcpp::RObject obj)
 {
-	Rcpp::Function serialize("serialize");
-
-	_stateObjectSerialized = serialize(Rcpp::_["object"] = obj, Rcpp::_["connection"] = R_NilValue, Rcpp::_["ascii"] = true);
+	_stateObject.set(obj);
 }
 
 Rcpp::RObject jaspState::getObject()
 {
-	if(_stateObjectSerialized.size() == 0)
-		return NULL;
-
-	Rcpp::Function unserialize("unserialize");
-	return unserialize(_stateObjectSerialized);
+	return _stateObject.get();
 }
 
 
@@ -40,7 +33,7 @@ std::string jaspState::dataToString(std::string prefix)
 {
 	std::stringstream out;
 
-	out << prefix << "object stored: "	<< ( _stateObjectSerialized.size() == 0 ? "no" : "yes") << "\n";
+	out << prefix << "object stored: "	<< ( _stateObject.empty() ? "no" : "yes") << "\n";
 
 	return out.str();
 }
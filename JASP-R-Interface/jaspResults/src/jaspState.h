@@ -1,11 +1,12 @@
 #pragma once
 #include "jaspObject.h"
+#include "jaspSerializedObject.h"
 
 class jaspState : public jaspObject
 {
 public:
 	jaspState(std::string title = "") : jaspObject(jaspObjectType::state, title) {}
-	~jaspState() { _stateObjectSerialized = Rcpp::Vector<RAWSXP>(); }
+	~jaspState() { _stateObject.clear(); }
 
 	void setObject(Rcpp::RObject obj);
 	Rcpp::RObject getObject();
@@ -15,7 +16,7 @@ public:
 	std::string dataToString(std::string prefix) override;
 
 private:
-	Rcpp::Vector<RAWSXP> _stateObjectSerialized;
+	jaspSerializedObject _stateObject;
 };
 
 
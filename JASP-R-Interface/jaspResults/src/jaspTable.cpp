@@ -1,5 +1,7 @@
 #include "jaspTable.h"
 
+const size_t jaspTable::rowsPerPage = 1000;
+
 std::string jaspColRowCombination::toString()
 {
 	bool ColumnsNotRows = colNames.size() + colOvertitles.size() > 0;
@@ -59,7 +61,7 @@ void jaspTable::setData(Rcpp::RObject newData)
 }
 
 
-void jaspTable::addOrSetColumnInData(std::vector<Json::Value> column, std::string colName)
+void jaspTable::addOrSetColumnInData(const jaspColumn & column, std::string colName)
 {
 	if(colName == "")
 		_data.push_back(column);
@@ -100,7 +102,7 @@ int jaspTable::getDesiredColumnIndexFromNameForColumnAdding(std::string colName)
 	return desiredIndex;
 }
 
-int jaspTable::pushbackToColumnInData(std::vector<Json::Value> column, std::string colName, int equalizedColumnsLength, int previouslyAddedUnnamed)
+int jaspTable::pushbackToColumnInData(const jaspColumn & column, std::string colName, int equalizedColumnsLength, int previouslyAddedUnnamed)
 {
 	int desiredColumnIndex = getDesiredColumnIndexFromNameForRowAdding(colName, previouslyAddedUnnamed);
 
@@ -114,8 +116,7 @@ int jaspTable::pushbackToColumnInData(std::vector<Json::Value> column, std::stri
 	if(_data[desiredColumnIndex].size() < equalizedColumnsLength)
 		_data[desiredColumnIndex].resize(equalizedColumnsLength);
 
-	for(auto element : column)
-		_data[desiredColumnIndex].push_back(element);
+	_data[desiredColumnIndex].append(column);
 
 	if(colName != "")
 		_colNames[desiredColumnIndex] = colName;
@@ -268,14 +269,10 @@ int jaspTable::equalizeColumnsLengths()
 
 	size_t maximumFoundColumnLength = 0;
 
-	for(auto col : _data)
+	for(const auto & col : _data)
 		maximumFoundColumnLength = std::max(maximumFoundColumnLength, col.size());
 
-	for(auto col : _data)
-		for(int row = col.size(); row < maximumFoundColumnLength; row++)
-			col.push_back(Json::Value(Json::nullValue));
-
-	return maximumFoundColumnLength;
+	return maximumFoundColumnLength; //pushbackToColumnInData pads the columns it adds to, the others are padded with nulls by getCell anyway
 }
 
 Json::Value jaspTable::getCell(size_t col, size_t row)
@@ -389,19 +386,15 @@ std::string	jaspTable::getCellFormatted(size_t col, size_t row)
 	return out.str();
 }
 
-std::vector<std::vector<std::string>> jaspTable::dataToRectangularVector(bool normalizeColLengths, bool normalizeRowLengths, bool onlySpecifiedColumns)
+std::vector<std::vector<std::string>> jaspTable::dataToRectangularVector(bool normalizeColLengths, bool normalizeRowLengths, bool onlySpecifiedColumns, size_t maxRows)
 {
-	size_t	maxRow = _expectedRowCount,
+	size_t	maxRow = std::min(rowCount(), maxRows),
 			maxCol = 0;
 
 	for(size_t col=0; col<_data.size(); col++)
-	{
 		if(!onlySpecifiedColumns || columnSpecified(col))
 			maxCol++;
 
-		maxRow = std::max(maxRow, _data[col].size());
-	}
-
 	size_t colsSpecified = maxCol;
 
 	if(!onlySpecifiedColumns && _expectedColumnCount > maxCol)
@@ -483,14 +476,11 @@ std::vector<std::string> jaspTable::getDisplayableColTitles(bool normalizeLength
 	return names;
 }
 
-std::vector<std::string> jaspTable::getDisplayableRowTitles(bool normalizeLengths)
+std::vector<std::string> jaspTable::getDisplayableRowTitles(bool normalizeLengths, size_t maxRows)
 {
 	std::vector<std::string> names;
 	size_t	maxLength	= 0,
-			rowMax		= _expectedRowCount;
-
-	for(size_t col=0; col<_data.size(); col++)
-		rowMax = std::max(rowMax, _data[col].size());
+			rowMax		= std::min(rowCount(), maxRows);
 
 	for(size_t row=0; row<rowMax; row++)
 	{
@@ -760,9 +750,9 @@ std::string jaspTable::toHtml()
 {
 	std::stringstream out;
 
-	std::vector<std::vector<std::string>>	vierkant = dataToRectangularVector(false, false, _showSpecifiedColumnsOnly);
+	std::vector<std::vector<std::string>>	vierkant = dataToRectangularVector(false, false, _showSpecifiedColumnsOnly, rowsPerPage);
 	std::vector<std::string>				colNames = getDisplayableColTitles(false, _showSpecifiedColumnsOnly),
-											rowNames = getDisplayableRowTitles(false);
+											rowNames = getDisplayableRowTitles(false, rowsPerPage);
 	out		<< "<div class=\"status " << _status << " jaspTable\">\n"
 			<< htmlTitle() << "\n";
 
@@ -777,6 +767,9 @@ std::string jaspTable::toHtml()
 	{
 		if(_transposeTable) rectangularDataWithNamesToHtml(out, vierkant,								colNames, rowNames, getOvertitlesMap(),	{});
 		else				rectangularDataWithNamesToHtml(out, transposeRectangularVector(vierkant),	rowNames, colNames,	{},						getOvertitlesMap());
+
+		if(rowCount() > rowsPerPage)
+			out << "<p>Showing the first " << rowsPerPage << " of " << rowCount() << " rows.</p>\n";
 	}
 
 
@@ -876,6 +869,8 @@ void jaspTable::addFootnote(Rcpp::RObject message, Rcpp::RObject symbol, Rcpp::R
 	note["row"]	= rowNames.size() == 0 ? Json::nullValue : jaspJson::VectorJson_to_ArrayJson(rowNames);
 
 	_footnotes.append(note);
+
+	notifyParentOfChanges();
 }
 
 /*
@@ -917,6 +912,20 @@ void jaspTable::combineCells(Rcpp::map_named_args & named_args)
 
 }
 */
+//The column and row lists are changed through their own interfaces, so their changes count as changes to the table
+bool jaspTable::hasUnsentChanges() const
+{
+	return	jaspObject::hasUnsentChanges()		|| _colNames.hasUnsentChanges()	|| _colTypes.hasUnsentChanges()		|| _colTitles.hasUnsentChanges()	||
+			_colOvertitles.hasUnsentChanges()	|| _colFormats.hasUnsentChanges()	|| _colCombines.hasUnsentChanges()	|| _rowNames.hasUnsentChanges()	||
+			_rowTitles.hasUnsentChanges();
+}
+
+void jaspTable::setChangesSent()
+{
+	for(jaspObject * list : std::vector<jaspObject*>({ this, &_colNames, &_colTypes, &_colTitles, &_colOvertitles, &_colFormats, &_colCombines, &_rowNames, &_rowTitles }))
+		list->jaspObject::setChangesSent();
+}
+
 Json::Value jaspTable::dataEntry()
 {
 	Json::Value dataJson(jaspObject::dataEntry());
@@ -926,7 +935,13 @@ Json::Value jaspTable::dataEntry()
 	dataJson["name"]				= getUniqueNestedName();
 	dataJson["schema"]				= schemaJson();
 
-	dataJson["data"]				= rowsJson();
+	dataJson["data"]				= rowsJson(0, rowsPerPage);
+
+	if(rowCount() > rowsPerPage)
+	{
+		dataJson["rowCount"]		= int(rowCount()); //The rest is requested page by page
+		dataJson["rowsPerPage"]		= int(rowsPerPage);
+	}
 	dataJson["casesAcrossColumns"]	= _transposeTable;
 	dataJson["overTitle"]			= _transposeWithOvertitle;
 
@@ -1012,7 +1027,17 @@ Json::Value	jaspTable::schemaJson()
     return schema;
 }
 
-Json::Value	jaspTable::rowsJson()
+size_t jaspTable::rowCount()
+{
+	size_t rows = _expectedRowCount;
+
+	for(const auto & col : _data)
+		rows = std::max(rows, col.size());
+
+	return rows;
+}
+
+Json::Value	jaspTable::rowsJson(size_t from, size_t count)
 {
 	Json::Value rows(Json::arrayValue);
 
@@ -1027,22 +1052,24 @@ Json::Value	jaspTable::rowsJson()
 					footnotesPerRowCol[rowName.asString()][colName.asString()].push_back(int(i));
 	}
 
-	bool keepGoing = true;
-	for(size_t row=0; keepGoing; row++)
+	std::vector<std::string> colNames;
+	for(size_t col=0; col<std::max(_data.size(), _expectedColumnCount); col++)
+		colNames.push_back(getColName(col));
+
+	size_t rowEnd = rowCount();
+
+	if(from < rowEnd && count < rowEnd - from)
+		rowEnd = from + count;
+
+	for(size_t row=from; row<rowEnd; row++)
 	{
 		Json::Value aRow(Json::objectValue);
-		bool aColumnKeepsGoing = false;
 
 		for(size_t col=0; col<_data.size(); col++)
-		{
-			if(_data[col].size() > row)
-				aColumnKeepsGoing = true;
-
-			aRow[getColName(col)] = getCell(col, row);
-		}
+			aRow[colNames[col]] = getCell(col, row);
 
 		for(size_t col=_data.size(); col<_expectedColumnCount; col++)
-			aRow[getColName(col)] = ".";
+			aRow[colNames[col]] = ".";
 
 		std::string rowName = getRowName(row);
 		if(footnotesPerRowCol.count(rowName) > 0)
@@ -1061,10 +1088,7 @@ Json::Value	jaspTable::rowsJson()
 			aRow[".footnotes"] = notes;
 		}
 
-		if(aColumnKeepsGoing || row < _expectedRowCount)
-			rows.append(aRow);
-		else
-			keepGoing = false;
+		rows.append(aRow);
 	}
 
 	return rows;
@@ -1078,35 +1102,39 @@ std::string jaspTable::deriveColumnType(int col)
 	Json::ValueType workingType = Json::nullValue;
 	const std::string variousType = "various";
 
-	for(auto & cell : _data[col])
+	for(size_t row=0; row<_data[col].size(); row++)
+	{
+		Json::ValueType cellType = _data[col].cellType(row);
+
 		switch(workingType)
 		{
 		case Json::nullValue:
-			workingType = cell.type();
+			workingType = cellType;
 			break;
 
 		case Json::stringValue:
 		case Json::booleanValue:
-			if(cell.type() != workingType)
+			if(cellType != workingType)
 				return variousType;
 			break;
 
 		case Json::intValue:
 		case Json::uintValue:
-			if(cell.type() == Json::realValue)
+			if(cellType == Json::realValue)
 				workingType = Json::realValue;
-			else if(cell.type() != workingType)
+			else if(cellType != workingType)
 				return variousType;
 			break;
 
 		case Json::realValue:
-			if(!(cell.type() == workingType || cell.type() == Json::intValue || cell.type() == Json::uintValue))
+			if(!(cellType == workingType || cellType == Json::intValue || cellType == Json::uintValue))
 				return variousType;
 			break;
 
 		default:
 			return "composite"; //arrays and objects are not really supported as cells at the moment but maybe we could add that in the future?
 		}
+	}
 
 	switch(workingType)
 	{
@@ -1177,8 +1205,8 @@ Json::Value jaspTable::convertToJSON()
 	{
 		Json::Value dataRows(Json::arrayValue);
 
-		for(auto & row : col)
-			dataRows.append(row);
+		for(size_t row=0; row<col.size(); row++)
+			dataRows.append(col[row]);
 
 		dataColumns.append(dataRows);
 	}
@@ -1226,7 +1254,7 @@ void jaspTable::convertFromJSON_SetFields(Json::Value in)
 	Json::Value dataColumns(in.get("data",	Json::arrayValue));
 	for(auto & col : dataColumns)
 	{
-		std::vector<Json::Value> newCol;
+		jaspColumn newCol;
 
 		for(auto & rowElem : col)
 			newCol.push_back(rowElem);
@@ -2,6 +2,8 @@
 #include "jaspObject.h"
 #include "jaspList.h"
 #include "jaspJson.h"
+#include "jaspColumn.h"
+#include <limits>
 
 struct jaspColRowCombination
 {
@@ -70,12 +72,15 @@ public:
 
 	std::string dataToString(std::string prefix) override;
 
-	void		complete() { if(_status == "running") _status = "complete"; }
+	void		complete() { if(_status == "running") { _status = "complete"; setUnsentChanges(); } } ///Only called right before jaspResults sends anyway
 
 	Json::Value	metaEntry() override { return constructMetaEntry("table"); }
 	Json::Value	dataEntry() override;
 	std::string	toHtml()	override;
 
+	bool		hasUnsentChanges()	const	override;
+	void		setChangesSent()			override;
+
 	std::string defaultColName(size_t col)			{ return "col"+ std::to_string(col); }
 	std::string defaultRowName(size_t row)			{ return "row"+ std::to_string(row); }
 	std::string	getRowName(size_t row)				{ return _rowNames[row] == "" ? defaultRowName(row) : _rowNames[row]; }
@@ -88,19 +93,25 @@ public:
 	Json::Value	getCell(size_t col, size_t row);
 	std::string	getCellFormatted(size_t col, size_t row);
 
+	size_t		rowCount();
+	Json::Value	rowsJson(size_t from = 0, size_t count = std::numeric_limits<size_t>::max());
+
+	///Tables with more rows than this only send the first page along with the results, the desktop asks the engine for the rest when needed.
+	static const size_t rowsPerPage;
+
 	void		setExpectedSize(size_t columns, size_t rows)	{ setExpectedRows(rows); setExpectedColumns(columns);	}
-	void		setExpectedRows(size_t rows)					{ _expectedRowCount = rows;								}
-	void		setExpectedColumns(size_t columns)				{ _expectedColumnCount = columns;						}
+	void		setExpectedRows(size_t rows)					{ _expectedRowCount = rows;			notifyParentOfChanges();	}
+	void		setExpectedColumns(size_t columns)				{ _expectedColumnCount = columns;	notifyParentOfChanges();	}
 
 private:
 	std::vector<std::string>	getDisplayableColTitles(bool normalizeLengths = true, bool onlySpecifiedColumns = true);
-	std::vector<std::string>	getDisplayableRowTitles(bool normalizeLengths = true);
+	std::vector<std::string>	getDisplayableRowTitles(bool normalizeLengths = true, size_t maxRows = std::numeric_limits<size_t>::max());
 	void						rectangularDataWithNamesToString(std::stringstream & out, std::string prefix, std::vector<std::vector<std::string>> vierkant, std::vector<std::string> sideNames, std::vector<std::string> topNames, std::map<std::string,std::string> sideOvertitles, std::map<std::string,std::string> topOvertitles);
 	void						rectangularDataWithNamesToHtml(std::stringstream & out, std::vector<std::vector<std::string>> vierkant, std::vector<std::string> sideNames, std::vector<std::string> topNames, std::map<std::string,std::string> sideOvertitles, std::map<std::string,std::string> topOvertitles);
 
 
 	std::map<std::string, std::string>				getOvertitlesMap();
-	std::vector<std::vector<std::string>>			dataToRectangularVector(bool normalizeColLengths = false, bool normalizeRowLengths = false, bool onlySpecifiedColumns = true);
+	std::vector<std::vector<std::string>>			dataToRectangularVector(bool normalizeColLengths = false, bool normalizeRowLengths = false, bool onlySpecifiedColumns = true, size_t maxRows = std::numeric_limits<size_t>::max());
 	std::vector<std::vector<std::string>>			transposeRectangularVector(const std::vector<std::vector<std::string>> & in);
 	std::map<std::string, std::map<size_t, size_t>> getOvertitleRanges(std::vector<std::string> names, std::map<std::string,std::string> overtitles);
 
@@ -108,14 +119,13 @@ private:
 	int getDesiredColumnIndexFromNameForRowAdding(std::string colName, int previouslyAddedUnnamed);
 
 	Json::Value	schemaJson();
-	Json::Value	rowsJson();
 	std::string deriveColumnType(int col);
 
 	Json::Value convertToJSON()								override;
 	void		convertFromJSON_SetFields(Json::Value in)	override;
 
-	void	addOrSetColumnInData(std::vector<Json::Value> column, std::string colName="");
-	int		pushbackToColumnInData(std::vector<Json::Value> column, std::string colName, int equalizedColumnsLength, int previouslyAddedUnnamed);
+	void	addOrSetColumnInData(const jaspColumn & column, std::string colName="");
+	int		pushbackToColumnInData(const jaspColumn & column, std::string colName, int equalizedColumnsLength, int previouslyAddedUnnamed);
 
 	template<int RTYPE>	void setDataFromVector(Rcpp::Vector<RTYPE> newData)
 	{
@@ -123,10 +133,10 @@ private:
 		extractRowNames(newData, true);
 
 		_data.clear();
-		auto cols = jaspJson::RcppVector_to_VectorJson<RTYPE>(newData);
+		jaspColumn cols = jaspColumn::fromRcpp<RTYPE>(newData);
 
 		for(int col=0; col<cols.size(); col++)
-			addOrSetColumnInData(std::vector<Json::Value>({cols[col]}), localColNames.size() > col ? localColNames[col] : "");
+			addOrSetColumnInData(jaspColumn::fromCell(cols[col]), localColNames.size() > col ? localColNames[col] : "");
 	}
 
 	void setDataFromList(Rcpp::List newData)
@@ -136,7 +146,7 @@ private:
 
 		_data.clear();
 		for(size_t col=0; col<newData.size(); col++)
-			addOrSetColumnInData(jaspJson::RcppVector_to_VectorJson((Rcpp::RObject)newData[col]), localColNames.size() > col ? localColNames[col] : "");
+			addOrSetColumnInData(jaspColumn::fromRObject((Rcpp::RObject)newData[col]), localColNames.size() > col ? localColNames[col] : "");
 	}
 
 	template<int RTYPE> void setDataFromMatrix(Rcpp::Matrix<RTYPE> newData)
@@ -144,11 +154,11 @@ private:
 		std::vector<std::string> localColNames = extractElementOrColumnNames(newData);
 		extractRowNames(newData, true);
 
-		std::vector<std::vector<Json::Value>> jsonMat = jaspJson::RcppMatrix_to_Vector2Json<RTYPE>(newData);
+		std::vector<jaspColumn> columns = jaspColumn::fromRcppMatrix<RTYPE>(newData);
 
 		_data.clear();
-		for(size_t col=0; col<jsonMat.size(); col++)
-			addOrSetColumnInData(jsonMat[col], localColNames.size() > col ? localColNames[col] : "");
+		for(size_t col=0; col<columns.size(); col++)
+			addOrSetColumnInData(columns[col], localColNames.size() > col ? localColNames[col] : "");
 	}
 
 	void addColumnsFromList(Rcpp::List newData);
@@ -157,7 +167,7 @@ private:
 	{
 		setRowNamesWhereApplicable(extractElementOrColumnNames(newData));
 
-		_data.push_back(jaspJson::RcppVector_to_VectorJson<RTYPE>(newData));
+		_data.push_back(jaspColumn::fromRcpp<RTYPE>(newData));
 	}
 
 	template<int RTYPE>	void setColumnFromVector(Rcpp::Vector<RTYPE> newData, size_t col)
@@ -166,7 +176,7 @@ private:
 
 		if(_data.size() <= col)
 			_data.resize(col+1);
-		_data[col] = jaspJson::RcppVector_to_VectorJson<RTYPE>(newData);
+		_data[col] = jaspColumn::fromRcpp<RTYPE>(newData);
 	}
 
 	void setColumnFromList(Rcpp::List column, int colIndex);
@@ -176,17 +186,17 @@ private:
 		std::vector<std::string> localColNames = extractElementOrColumnNames(newData);
 		extractRowNames(newData, true);
 
-		std::vector<std::vector<Json::Value>> jsonMat = jaspJson::RcppMatrix_to_Vector2Json<RTYPE>(newData);
+		std::vector<jaspColumn> columns = jaspColumn::fromRcppMatrix<RTYPE>(newData);
 
-		for(size_t col=0; col<jsonMat.size(); col++)
-			addOrSetColumnInData(jsonMat[col], localColNames.size() > col ? localColNames[col] : "");
+		for(size_t col=0; col<columns.size(); col++)
+			addOrSetColumnInData(columns[col], localColNames.size() > col ? localColNames[col] : "");
 	}
 
 	template<int RTYPE>	void addRowFromVector(Rcpp::Vector<RTYPE> newData, Rcpp::CharacterVector newRowNames)
 	{
 		std::vector<std::string> localColNames = extractElementOrColumnNames(newData);
 
-		auto row = jaspJson::RcppVector_to_VectorJson<RTYPE>(newData);
+		jaspColumn row = jaspColumn::fromRcpp<RTYPE>(newData);
 
 		int equalizedColumnsLength = equalizeColumnsLengths();
 		int previouslyAddedUnnamedCols = 0;
@@ -195,7 +205,7 @@ private:
 			_rowNames[row + equalizedColumnsLength] = newRowNames[row];
 
 		for(int col=0; col<row.size(); col++)
-			previouslyAddedUnnamedCols = pushbackToColumnInData(std::vector<Json::Value>({row[col]}), localColNames.size() > col ? localColNames[col] : "", equalizedColumnsLength, previouslyAddedUnnamedCols);
+			previouslyAddedUnnamedCols = pushbackToColumnInData(jaspColumn::fromCell(row[col]), localColNames.size() > col ? localColNames[col] : "", equalizedColumnsLength, previouslyAddedUnnamedCols);
 
 	}
 
@@ -245,7 +255,7 @@ private:
 			auto jsonRij = jaspJson::RcppVector_to_VectorJson(rij);
 
 			for(size_t col=0; col<jsonRij.size(); col++)
-				previouslyAddedUnnamedCols = pushbackToColumnInData(std::vector<Json::Value>({jsonRij[col]}), localColNames.size() > col ? localColNames[col] : "", equalizedColumnsLength, previouslyAddedUnnamedCols);
+				previouslyAddedUnnamedCols = pushbackToColumnInData(jaspColumn::fromCell(jsonRij[col]), localColNames.size() > col ? localColNames[col] : "", equalizedColumnsLength, previouslyAddedUnnamedCols);
 
 		}
 
@@ -262,8 +272,7 @@ private:
 		for(size_t col=0; col<newData.size(); col++)
 		{
 			Rcpp::RObject kolom			= (Rcpp::RObject)newData[col];
-			auto jsonKolom				= jaspJson::RcppVector_to_VectorJson(kolom);
-			previouslyAddedUnnamedCols	= pushbackToColumnInData(jsonKolom, localColNames.size() > col ? localColNames[col] : "", equalizedColumnsLength, previouslyAddedUnnamedCols);
+			previouslyAddedUnnamedCols	= pushbackToColumnInData(jaspColumn::fromRObject(kolom), localColNames.size() > col ? localColNames[col] : "", equalizedColumnsLength, previouslyAddedUnnamedCols);
 		}
 
 	}
@@ -279,10 +288,10 @@ private:
 		for(int row=0; row<newRowNames.size(); row++)
 			_rowNames[row + equalizedColumnsLength] = newRowNames[row];
 
-		auto jsonMatrix = jaspJson::RcppMatrix_to_Vector2Json<RTYPE>(newData);
+		std::vector<jaspColumn> columns = jaspColumn::fromRcppMatrix<RTYPE>(newData);
 
-		for(int col=0; col<jsonMatrix.size(); col++)
-			previouslyAddedUnnamedCols = pushbackToColumnInData(std::vector<Json::Value>({jsonMatrix[col]}), localColNames.size() > col ? localColNames[col] : "", equalizedColumnsLength, previouslyAddedUnnamedCols);
+		for(int col=0; col<columns.size(); col++)
+			previouslyAddedUnnamedCols = pushbackToColumnInData(columns[col], localColNames.size() > col ? localColNames[col] : "", equalizedColumnsLength, previouslyAddedUnnamedCols);
 	}
 
 	void setRowNamesWhereApplicable(std::vector<std::string> rowNamesList)
@@ -369,7 +378,7 @@ public:
 
 private:
 	Json::Value								_footnotes = Json::arrayValue;
-	std::vector<std::vector<Json::Value>>	_data;	//First columns, then rows.
+	std::vector<jaspColumn>					_data;	//First columns, then rows.
 	std::vector<jaspColRowCombination>		_colRowCombinations;
 	size_t									_expectedColumnCount	= 0,
 											_expectedRowCount		= 0;
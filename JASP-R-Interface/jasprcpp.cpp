@@ -16,9 +16,11 @@
 //
 
 #include "jasprcpp.h"
+#include "jasprcpp_sharedcolumns.h"
 #include "rinside_consolelogging.h"
 #include "jaspResults/src/jaspResults.h"
 #include <iostream>
+#include <map>
 
 using namespace std;
 
@@ -78,6 +80,8 @@ void STDCALL jaspRCPP_init(const char* buildYear, const char* version, RBridgeCa
 	dataSetColumnAsNominalText				= callbacks->dataSetColumnAsNominalText;
 	requestJaspResultsFileSourceCB			= callbacks->requestJaspResultsFileSourceCB;
 
+	jaspRCPP_initSharedColumns();
+
 	rInside[".dataSetRowCount"]				= Rcpp::InternalFunction(&jaspRCPP_dataSetRowCount);
 	rInside[".setRError"]					= Rcpp::InternalFunction(&jaspRCPP_setRError);
 	rInside[".setRWarning"]					= Rcpp::InternalFunction(&jaspRCPP_setRWarning);
@@ -339,6 +343,22 @@ const char* STDCALL jaspRCPP_editImage(const char *name, const char *type, const
 
 }
 
+const char* STDCALL jaspRCPP_getTablePage(const char * stateFile, const char * tableName, int from, int count)
+{
+	static std::string staticResult;
+	staticResult = jaspResults::tablePageFromStateFile(stateFile, tableName, from, count);
+
+	return staticResult.c_str();
+}
+
+const char* STDCALL jaspRCPP_getRunningTablePage(const char * tableName, int from, int count)
+{
+	static std::string staticResult;
+	staticResult = jaspResults::tablePageFromRunningResults(tableName, from, count);
+
+	return staticResult.c_str();
+}
+
 
 const char*	STDCALL jaspRCPP_evalRCode(const char *rCode) {
 	// Function to evaluate arbitrary R code from C++
@@ -482,6 +502,8 @@ int jaspRCPP_dataSetRowCount()
 
 bool jaspRCPP_setColumnDataAsScale(std::string columnName, Rcpp::RObject scalarData)
 {
+	jaspRCPP_materializeSharedColumns(); //The engine is about to change the dataset under them
+
 	if(Rcpp::is<Rcpp::Vector<REALSXP>>(scalarData))
 		return _jaspRCPP_setColumnDataAsScale(columnName, Rcpp::as<Rcpp::Vector<REALSXP>>(scalarData));
 
@@ -511,6 +533,8 @@ bool _jaspRCPP_setColumnDataAsScale(std::string columnName, Rcpp::Vector<REALSXP
 
 bool jaspRCPP_setColumnDataAsOrdinal(std::string columnName, Rcpp::RObject ordinalData)
 {
+	jaspRCPP_materializeSharedColumns(); //The engine is about to change the dataset under them
+
 	if(Rcpp::is<Rcpp::Vector<INTSXP>>(ordinalData))
 		return _jaspRCPP_setColumnDataAsOrdinal(columnName, Rcpp::as<Rcpp::Vector<INTSXP>>(ordinalData));
 
@@ -547,6 +571,8 @@ bool _jaspRCPP_setColumnDataAsOrdinal(std::string columnName, Rcpp::Vector<INTSX
 
 bool jaspRCPP_setColumnDataAsNominal(std::string columnName, Rcpp::RObject nominalData)
 {
+	jaspRCPP_materializeSharedColumns(); //The engine is about to change the dataset under them
+
 	if(Rcpp::is<Rcpp::Vector<INTSXP>>(nominalData))
 		return _jaspRCPP_setColumnDataAsNominal(columnName, Rcpp::as<Rcpp::Vector<INTSXP>>(nominalData));
 
@@ -583,6 +609,8 @@ bool _jaspRCPP_setColumnDataAsNominal(std::string columnName, Rcpp::Vector<INTSX
 
 bool jaspRCPP_setColumnDataAsNominalText(std::string columnName, Rcpp::RObject nominalData)
 {
+	jaspRCPP_materializeSharedColumns(); //The engine is about to change the dataset under them
+
 	if(Rf_isNull(nominalData))
 		return _jaspRCPP_setColumnDataAsNominalText(columnName, Rcpp::Vector<STRSXP>());
 
@@ -731,6 +759,44 @@ Rcpp::DataFrame jaspRCPP_readDataSetSEXP(SEXP columns, SEXP columnsAsNumeric, SE
 	return jaspRCPP_convertRBridgeColumns_to_DataFrame(colResults, colMax);
 }
 
+///What jaspRCPP_convertRBridgeColumns_to_DataFrame made of the columns rbridge keeps in its cache, by RBridgeColumn::cacheId. They stay preserved until rbridge lets us know they are outdated.
+static std::map<unsigned int, SEXP> convertedColumns;
+
+Rcpp::RObject jaspRCPP_convertedColumn(const RBridgeColumn & colResult, std::function<Rcpp::RObject()> convert)
+{
+	if (colResult.cacheId == 0)
+		return convert();
+
+	auto converted = convertedColumns.find(colResult.cacheId);
+
+	if (converted != convertedColumns.end())
+		return converted->second;
+
+	Rcpp::RObject column = convert();
+
+	//Every analysis that asks for this column gets this very same vector, so R has to copy it before changing anything in it
+#ifdef MARK_NOT_MUTABLE
+	MARK_NOT_MUTABLE(column);
+#else
+	SET_NAMED(column, 2);
+#endif
+	R_PreserveObject(column);
+	convertedColumns[colResult.cacheId] = column;
+
+	return column;
+}
+
+void STDCALL jaspRCPP_forgetConvertedColumn(unsigned int cacheId)
+{
+	auto converted = convertedColumns.find(cacheId);
+
+	if (converted == convertedColumns.end())
+		return;
+
+	R_ReleaseObject(converted->second);
+	convertedColumns.erase(converted);
+}
+
 Rcpp::DataFrame jaspRCPP_convertRBridgeColumns_to_DataFrame(const RBridgeColumn* colResults, size_t colMax)
 {
 	Rcpp::DataFrame dataFrame = Rcpp::DataFrame();
@@ -740,6 +806,9 @@ Rcpp::DataFrame jaspRCPP_convertRBridgeColumns_to_DataFrame(const RBridgeColumn*
 		Rcpp::List list(colMax);
 		Rcpp::StringVector columnNames(colMax);
 
+		const RBridgeColumn&	rowNumbers	= colResults[colMax];
+		jaspRCPP_RowNumbers		sharedRows;
+
 		for (int i = 0; i < colMax; i++)
 		{
 			const RBridgeColumn& colResult = colResults[i];
@@ -747,18 +816,27 @@ Rcpp::DataFrame jaspRCPP_convertRBridgeColumns_to_DataFrame(const RBridgeColumn*
 			colName.set_encoding(Encoding);
 			columnNames[i] = colName;
 
-			if (colResult.isScale)
-				list[i] = Rcpp::NumericVector(colResult.doubles, colResult.doubles + colResult.nbRows);
-			else if(!colResult.hasLabels)
-				list[i] = Rcpp::IntegerVector(colResult.ints, colResult.ints + colResult.nbRows);
-			else
-				list[i] = jaspRCPP_makeFactor(Rcpp::IntegerVector(colResult.ints, colResult.ints + colResult.nbRows), colResult.labels, colResult.nbLabels, colResult.isOrdinal);
-
+			list[i] = jaspRCPP_convertedColumn(colResult, [&]() -> Rcpp::RObject
+			{
+				if (colResult.sharedValues)
+				{
+					if (!sharedRows && rowNumbers.nbRows != colResult.nbValues)
+						sharedRows = std::make_shared<const std::vector<int>>(rowNumbers.ints, rowNumbers.ints + rowNumbers.nbRows);
+
+					return jaspRCPP_sharedColumnVector(colResult, rowNumbers.nbRows == colResult.nbValues ? nullptr : sharedRows);
+				}
+				else if (colResult.isScale)
+					return Rcpp::NumericVector(colResult.doubles, colResult.doubles + colResult.nbRows);
+				else if(!colResult.hasLabels)
+					return Rcpp::IntegerVector(colResult.ints, colResult.ints + colResult.nbRows);
+				else
+					return jaspRCPP_makeFactor(Rcpp::IntegerVector(colResult.ints, colResult.ints + colResult.nbRows), colResult.labels, colResult.nbLabels, colResult.isOrdinal);
+			});
 		}
 
 		list.attr("names")			= columnNames;
 		dataFrame					= Rcpp::DataFrame(list);
-		dataFrame.attr("row.names") = Rcpp::IntegerVector(colResults[colMax].ints, colResults[colMax].ints + colResults[colMax].nbRows);
+		dataFrame.attr("row.names") = jaspRCPP_convertedColumn(rowNumbers, [&]() -> Rcpp::RObject { return Rcpp::IntegerVector(rowNumbers.ints, rowNumbers.ints + rowNumbers.nbRows); });
 	}
 
 	return dataFrame;
@@ -20,6 +20,7 @@
 
 #include <RInside/RInside.h>
 #include <Rcpp.h>
+#include <functional>
 #include "jasprcpp_interface.h"
 
 // Calls From R
@@ -63,6 +64,8 @@ enum ColumnType { ColumnTypeUnknown = 0, ColumnTypeNominal = 1, ColumnTypeNomina
 
 RBridgeColumnType* jaspRCPP_marshallSEXPs(SEXP columns, SEXP columnsAsNumeric, SEXP columnsAsOrdinal, SEXP columnsAsNominal, SEXP allColumns, size_t * colMax);
 
+Rcpp::RObject jaspRCPP_convertedColumn(const RBridgeColumn & colResult, std::function<Rcpp::RObject()> convert); ///< Converts colResult with convert, unless it was converted before and is still cached by rbridge
+
 Rcpp::IntegerVector jaspRCPP_makeFactor(Rcpp::IntegerVector v, char** levels, int nbLevels, bool ordinal = false);
 void freeRBridgeColumnType(RBridgeColumnType* columnsRequested, size_t colMax);
 
@@ -44,11 +44,14 @@ struct RBridgeColumn {
   bool    isScale;
   bool    hasLabels;
   bool    isOrdinal;
+  bool    sharedValues; // doubles or ints point straight into the shared memory column, it has nbValues rows and the rownumbers select nbRows of them
   double* doubles;
   int*    ints;
   char**  labels;
   size_t  nbRows;
   size_t  nbLabels;
+  size_t  nbValues;
+  unsigned int cacheId; // Stays the same for as long as the engine hands over the very same column, so jaspRCPP can keep what it converted it into. 0 means it isn't cached
 } ;
 
 struct RBridgeColumnDescription {
@@ -111,6 +114,8 @@ RBRIDGE_TO_JASP_INTERFACE const char*	STDCALL jaspRCPP_check();
 
 RBRIDGE_TO_JASP_INTERFACE const char*	STDCALL jaspRCPP_saveImage(const char *name, const char *type, const int height, const int width, const int ppi, const char* imageBackground);
 RBRIDGE_TO_JASP_INTERFACE const char*	STDCALL jaspRCPP_editImage(const char *name, const char *type, const int height, const int width, const int ppi);
+RBRIDGE_TO_JASP_INTERFACE const char*	STDCALL jaspRCPP_getTablePage(const char * stateFile, const char * tableName, int from, int count); //rows of a jaspTable kept in the state file of an analysis, as json
+RBRIDGE_TO_JASP_INTERFACE const char*	STDCALL jaspRCPP_getRunningTablePage(const char * tableName, int from, int count); //the same but from the analysis that is running right now
 
 RBRIDGE_TO_JASP_INTERFACE const char*	STDCALL jaspRCPP_runModuleCall(const char* name, const char* title, const char* moduleCall, const char* dataKey, const char* options, const char* stateKey, const char* perform, int ppi, int analysisID, int analysisRevision, const char* imageBackground);
 
@@ -121,6 +126,8 @@ RBRIDGE_TO_JASP_INTERFACE const char*	STDCALL jaspRCPP_evalRCode(const char *rCo
 
 RBRIDGE_TO_JASP_INTERFACE int			STDCALL jaspRCPP_runFilter(const char * filtercode, bool ** arraypointer); //arraypointer points to a pointer that will contain the resulting list of filter-booleans if jaspRCPP_runFilter returns > 0
 RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_freeArrayPointer(bool ** arrayPointer);
+RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_forgetConvertedColumn(unsigned int cacheId); //The engine no longer hands over the column with this RBridgeColumn::cacheId
+RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_materializeSharedColumns(); //Gives every R vector still reading from the shared memory its own copy, must be called before the data in there changes
 RBRIDGE_TO_JASP_INTERFACE void			STDCALL jaspRCPP_runScript(const char * scriptCode);
 
 RBRIDGE_TO_JASP_INTERFACE const char*	STDCALL jaspRCPP_getLastErrorMsg();
@@ -0,0 +1,199 @@
+#include "jasprcpp_sharedcolumns.h"
+#include <Rversion.h>
+#include <algorithm>
+#include <set>
+
+#if R_VERSION >= R_Version(3, 5, 0)
+#include <R_ext/Rdynload.h>
+#include <R_ext/Altrep.h>
+#define JASP_SHARED_COLUMNS_ALTREP
+#endif
+
+namespace
+{
+
+///What a shared column vector reads from, as long as it is shared row i is values[rows[i] - 1] in the shared memory.
+struct SharedColumn
+{
+	const double	*	doubles	= nullptr;
+	const int		*	ints	= nullptr;
+	jaspRCPP_RowNumbers	rows;
+	size_t				length	= 0;
+	bool				shared	= true;
+	std::vector<double>	ownDoubles;
+	std::vector<int>	ownInts;
+
+	size_t	index(size_t row)	const { return rows ? size_t((*rows)[row] - 1) : row; }
+	void	materialize();
+};
+
+std::set<SharedColumn*> liveSharedColumns; ///< Those that still point into the shared memory
+
+void SharedColumn::materialize()
+{
+	if(!shared)
+		return;
+
+	if(doubles)
+	{
+		ownDoubles.resize(length);
+		for(size_t row=0; row<length; row++)
+			ownDoubles[row] = doubles[index(row)];
+		doubles = ownDoubles.data();
+	}
+	else
+	{
+		ownInts.resize(length);
+		for(size_t row=0; row<length; row++)
+			ownInts[row] = ints[index(row)];
+		ints = ownInts.data();
+	}
+
+	rows	= nullptr;
+	shared	= false;
+	liveSharedColumns.erase(this);
+}
+
+template<typename T> void copyRows(const T * values, const jaspRCPP_RowNumbers & rows, size_t start, size_t count, T * out)
+{
+	if(!rows)	std::copy(values + start, values + start + count, out);
+	else		for(size_t row=0; row<count; row++)
+					out[row] = values[(*rows)[start + row] - 1];
+}
+
+#ifdef JASP_SHARED_COLUMNS_ALTREP
+R_altrep_class_t sharedDoublesClass, sharedIntsClass;
+
+SharedColumn * sharedColumn(SEXP x) { return static_cast<SharedColumn*>(R_ExternalPtrAddr(R_altrep_data1(x))); }
+
+void finalizeSharedColumn(SEXP ptr)
+{
+	SharedColumn * column = static_cast<SharedColumn*>(R_ExternalPtrAddr(ptr));
+
+	if(!column)
+		return;
+
+	liveSharedColumns.erase(column);
+	delete column;
+	R_ClearExternalPtr(ptr);
+}
+
+R_xlen_t sharedLength(SEXP x) { return R_xlen_t(sharedColumn(x)->length); }
+
+///Only an unfiltered column that R just wants to read can give out the shared memory itself
+void * sharedDataptr(SEXP x, Rboolean writeable)
+{
+	SharedColumn * column = sharedColumn(x);
+
+	if(writeable || column->rows)
+		column->materialize();
+
+	return column->doubles ? (void*)column->doubles : (void*)column->ints;
+}
+
+const void * sharedDataptrOrNull(SEXP x)
+{
+	SharedColumn * column = sharedColumn(x);
+
+	if(column->rows)
+		return nullptr;
+
+	return column->doubles ? (const void*)column->doubles : (const void*)column->ints;
+}
+
+///A copy gets a normal vector and leaves this one shared
+SEXP sharedDuplicate(SEXP x, Rboolean)
+{
+	SharedColumn	* column	= sharedColumn(x);
+	SEXP			  copy		= PROTECT(Rf_allocVector(TYPEOF(x), R_xlen_t(column->length)));
+
+	if(column->doubles)	copyRows(column->doubles,	column->rows, 0, column->length, REAL(copy));
+	else				copyRows(column->ints,		column->rows, 0, column->length, INTEGER(copy));
+
+	UNPROTECT(1);
+	return copy;
+}
+
+double sharedDoubleElt(SEXP x, R_xlen_t i)	{ SharedColumn * column = sharedColumn(x); return column->doubles[column->index(i)];	}
+int sharedIntElt(SEXP x, R_xlen_t i)		{ SharedColumn * column = sharedColumn(x); return column->ints[column->index(i)];		}
+
+template<typename T> R_xlen_t sharedGetRegion(const T * values, SharedColumn * column, R_xlen_t start, R_xlen_t count, T * out)
+{
+	count = std::max<R_xlen_t>(0, std::min<R_xlen_t>(count, R_xlen_t(column->length) - start));
+	copyRows(values, column->rows, start, count, out);
+	return count;
+}
+
+R_xlen_t sharedDoubleGetRegion(SEXP x, R_xlen_t start, R_xlen_t count, double * out)	{ SharedColumn * column = sharedColumn(x); return sharedGetRegion(column->doubles,	column, start, count, out); }
+R_xlen_t sharedIntGetRegion(SEXP x, R_xlen_t start, R_xlen_t count, int * out)		{ SharedColumn * column = sharedColumn(x); return sharedGetRegion(column->ints,		column, start, count, out); }
+#endif
+
+}
+
+void jaspRCPP_initSharedColumns()
+{
+#ifdef JASP_SHARED_COLUMNS_ALTREP
+	DllInfo * dll = R_getEmbeddingDllInfo();
+
+	sharedDoublesClass	= R_make_altreal_class(		"jaspSharedDoubles",	"JASP", dll);
+	sharedIntsClass		= R_make_altinteger_class(	"jaspSharedInts",		"JASP", dll);
+
+	for(R_altrep_class_t cls : { sharedDoublesClass, sharedIntsClass })
+	{
+		R_set_altrep_Length_method(			cls, sharedLength);
+		R_set_altrep_Duplicate_method(		cls, sharedDuplicate);
+		R_set_altvec_Dataptr_method(		cls, sharedDataptr);
+		R_set_altvec_Dataptr_or_null_method(cls, sharedDataptrOrNull);
+	}
+
+	R_set_altreal_Elt_method(				sharedDoublesClass,	sharedDoubleElt);
+	R_set_altreal_Get_region_method(		sharedDoublesClass,	sharedDoubleGetRegion);
+	R_set_altinteger_Elt_method(			sharedIntsClass,	sharedIntElt);
+	R_set_altinteger_Get_region_method(		sharedIntsClass,	sharedIntGetRegion);
+#endif
+}
+
+SEXP jaspRCPP_sharedColumnVector(const RBridgeColumn & column, jaspRCPP_RowNumbers rows)
+{
+	size_t length = column.nbRows;
+
+#ifdef JASP_SHARED_COLUMNS_ALTREP
+	if(length > 0)
+	{
+		SharedColumn * shared = new SharedColumn();
+
+		shared->doubles	= column.isScale ? column.doubles	: nullptr;
+		shared->ints	= column.isScale ? nullptr			: column.ints;
+		shared->rows	= rows;
+		shared->length	= length;
+
+		SEXP ptr = PROTECT(R_MakeExternalPtr(shared, R_NilValue, R_NilValue));
+		R_RegisterCFinalizerEx(ptr, finalizeSharedColumn, TRUE);
+		liveSharedColumns.insert(shared);
+
+		SEXP vector = R_new_altrep(column.isScale ? sharedDoublesClass : sharedIntsClass, ptr, R_NilValue);
+		UNPROTECT(1);
+
+		return vector;
+	}
+#endif
+
+	if(column.isScale)
+	{
+		Rcpp::NumericVector copy(length);
+		copyRows(column.doubles, rows, 0, length, copy.begin());
+		return copy;
+	}
+
+	Rcpp::IntegerVector copy(length);
+	copyRows(column.ints, rows, 0, length, copy.begin());
+	return copy;
+}
+
+void STDCALL jaspRCPP_materializeSharedColumns()
+{
+	std::set<SharedColumn*> live(liveSharedColumns);
+
+	for(SharedColumn * column : live)
+		column->materialize();
+}
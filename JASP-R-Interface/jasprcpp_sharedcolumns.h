@@ -0,0 +1,18 @@
+#ifndef JASPRCPP_SHAREDCOLUMNS_H
+#define JASPRCPP_SHAREDCOLUMNS_H
+
+#include <Rcpp.h>
+#include <memory>
+#include <vector>
+#include "jasprcpp_interface.h"
+
+typedef std::shared_ptr<const std::vector<int>> jaspRCPP_RowNumbers; ///< 1-based rows of a filtered dataset, nullptr when all rows are there
+
+///Turns a column that rbridge shares straight from the shared memory (RBridgeColumn::sharedValues) into an R vector.
+///From R 3.5 on that is an ALTREP vector reading the shared memory through rows, it only gets its own copy once R wants to write to it or the dataset changes.
+///Older R versions simply get a copy.
+SEXP jaspRCPP_sharedColumnVector(const RBridgeColumn & column, jaspRCPP_RowNumbers rows);
+
+void jaspRCPP_initSharedColumns();
+
+#endif // JASPRCPP_SHAREDCOLUMNS_H
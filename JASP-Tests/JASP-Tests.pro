@@ -0,0 +1,46 @@
+QT += core testlib
+QT -= gui
+
+include(../JASP.pri)
+
+CONFIG += c++11
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+DESTDIR = ..
+TARGET = JASP-Tests
+TEMPLATE = app
+
+DEPENDPATH = ..
+PRE_TARGETDEPS += ../JASP-Common
+
+INCLUDEPATH += ../JASP-Common
+LIBS += -L.. -lJASP-Common
+
+windows:CONFIG(ReleaseBuild) {
+        LIBS += -llibboost_filesystem-vc141-mt-1_64 -llibboost_system-vc141-mt-1_64 -larchive.dll
+}
+
+windows:CONFIG(DebugBuild) {
+        LIBS += -llibboost_filesystem-vc141-mt-gd-1_64 -llibboost_system-vc141-mt-gd-1_64 -larchive.dll
+}
+
+macx:LIBS += -lboost_filesystem-clang-mt-1_64 -lboost_system-clang-mt-1_64 -larchive -lz
+
+linux {
+    LIBS += -larchive
+    exists(/app/lib/*)	{ LIBS += -L/app/lib }
+    LIBS += -lboost_filesystem -lboost_system -lrt
+}
+
+   macx:INCLUDEPATH += ../../boost_1_64_0
+windows:INCLUDEPATH += ../../boost_1_64_0
+
+SOURCES += \
+	main.cpp \
+	filterbitstest.cpp \
+	jsonserializertest.cpp
+
+HEADERS += \
+	filterbitstest.h \
+	jsonserializertest.h
@@ -0,0 +1,75 @@
+#include "filterbitstest.h"
+#include "dataset.h"
+
+#include <QtTest>
+#include <vector>
+
+static const char * testMemoryName = "JASP-Tests-FilterBits";
+
+void FilterBitsTest::init()
+{
+	boost::interprocess::shared_memory_object::remove(testMemoryName);
+	_mem = new boost::interprocess::managed_shared_memory(boost::interprocess::create_only, testMemoryName, 1024 * 1024);
+}
+
+void FilterBitsTest::cleanup()
+{
+	delete _mem;
+	_mem = nullptr;
+	boost::interprocess::shared_memory_object::remove(testMemoryName);
+}
+
+///A filtered column is read through the row numbers like jaspRCPP does, so a dropped first row may not leave the last row number empty
+void FilterBitsTest::rowNumbersSkipDroppedLeadingRow()
+{
+	std::vector<double>	values	= { 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 };
+	std::vector<bool>	passes(values.size(), true);
+
+	passes[0] = false;
+
+	FilterBits filter(_mem->get_segment_manager());
+	filter.reset(values.size());
+	size_t passed = filter.pack(passes);
+
+	QCOMPARE(passed, values.size() - 1);
+
+	std::vector<int>	rows(passed, 0);
+	QCOMPARE(filter.rowNumbers(values.size(), rows.data(), rows.size()), passed);
+
+	for(size_t i = 0; i < passed; i++)
+	{
+		QCOMPARE(rows[i], int(i + 2));
+		QCOMPARE(values[rows[i] - 1], values[i + 1]);
+	}
+}
+
+void FilterBitsTest::rowNumbersAcrossWords()
+{
+	const size_t		rowCount = 200;
+	std::vector<bool>	passes(rowCount);
+	std::vector<int>	expected;
+
+	for(size_t row = 0; row < rowCount; row++)
+		if((passes[row] = row % 3 != 0))
+			expected.push_back(int(row + 1));
+
+	FilterBits filter(_mem->get_segment_manager());
+	filter.reset(rowCount);
+	QCOMPARE(filter.pack(passes), expected.size());
+
+	std::vector<int> rows(expected.size(), 0);
+	QCOMPARE(filter.rowNumbers(rowCount, rows.data(), rows.size()), expected.size());
+	QVERIFY(rows == expected);
+}
+
+///Rows the filter doesn't know about don't pass
+void FilterBitsTest::rowNumbersPastFilter()
+{
+	FilterBits filter(_mem->get_segment_manager());
+	filter.reset(3);
+
+	std::vector<int> rows(5, 0);
+	QCOMPARE(filter.rowNumbers(5, rows.data(), rows.size()), size_t(3));
+	QCOMPARE(rows[2], 3);
+	QCOMPARE(rows[3], 0);
+}
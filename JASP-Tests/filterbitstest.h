@@ -0,0 +1,23 @@
+#ifndef FILTERBITSTEST_H
+#define FILTERBITSTEST_H
+
+#include <QObject>
+#include <boost/interprocess/managed_shared_memory.hpp>
+
+class FilterBitsTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void init();
+	void cleanup();
+
+	void rowNumbersSkipDroppedLeadingRow();
+	void rowNumbersAcrossWords();
+	void rowNumbersPastFilter();
+
+private:
+	boost::interprocess::managed_shared_memory * _mem = nullptr;
+};
+
+#endif // FILTERBITSTEST_H
@@ -0,0 +1,77 @@
+#include "jsonserializertest.h"
+#include "jsonserializer.h"
+
+#include <QtTest>
+#include <limits>
+
+Q_DECLARE_METATYPE(messageFormat)
+
+static Json::Value roundTrip(const Json::Value & value, messageFormat format)
+{
+	std::string		message = JsonSerializer::serialize(value, format);
+	Json::Value		out;
+
+	if(!JsonSerializer::parse(message.data(), message.size(), out))
+		return Json::Value("unparseable");
+
+	return out;
+}
+
+///NaN and Inf in a single value and in arrays long enough to go in one MessagePack ext block must come back the same from both formats
+static Json::Value nonFiniteMessage()
+{
+	Json::Value message(Json::objectValue);
+
+	message["nan"]		= std::numeric_limits<double>::quiet_NaN();
+	message["inf"]		= std::numeric_limits<double>::infinity();
+	message["values"]	= Json::arrayValue;
+
+	for(double value : { 1.5, std::numeric_limits<double>::quiet_NaN(), -2.25, -std::numeric_limits<double>::infinity(), 3.0 })
+		message["values"].append(value);
+
+	return message;
+}
+
+void JsonSerializerTest::nonFiniteRoundTripsAlike_data()
+{
+	QTest::addColumn<messageFormat>("format");
+
+	QTest::newRow("json")			<< messageFormat::json;
+	QTest::newRow("messagePack")	<< messageFormat::messagePack;
+}
+
+void JsonSerializerTest::nonFiniteRoundTripsAlike()
+{
+	QFETCH(messageFormat, format);
+
+	Json::Value out = roundTrip(nonFiniteMessage(), format);
+
+	QVERIFY(out["nan"].isNull());
+	QVERIFY(out["inf"].isNull());
+
+	const Json::Value & values = out["values"];
+
+	QCOMPARE(values.size(), Json::UInt(5));
+	QCOMPARE(values[0u].asDouble(), 1.5);
+	QVERIFY(values[1u].isNull());
+	QCOMPARE(values[2u].asDouble(), -2.25);
+	QVERIFY(values[3u].isNull());
+	QCOMPARE(values[4u].asDouble(), 3.0);
+
+	QVERIFY(out == roundTrip(nonFiniteMessage(), format == messageFormat::json ? messageFormat::messagePack : messageFormat::json));
+}
+
+void JsonSerializerTest::finiteRoundTripsAlike()
+{
+	Json::Value message(Json::objectValue);
+
+	message["typeRequest"]	= "analysis";
+	message["id"]			= 12;
+	message["values"]		= Json::arrayValue;
+
+	for(double value : { 0.1, -1e300, 2.5e-8, 42.0 })
+		message["values"].append(value);
+
+	QVERIFY(roundTrip(message, messageFormat::json)			== message);
+	QVERIFY(roundTrip(message, messageFormat::messagePack)	== message);
+}
@@ -0,0 +1,16 @@
+#ifndef JSONSERIALIZERTEST_H
+#define JSONSERIALIZERTEST_H
+
+#include <QObject>
+
+class JsonSerializerTest : public QObject
+{
+	Q_OBJECT
+
+private slots:
+	void nonFiniteRoundTripsAlike_data();
+	void nonFiniteRoundTripsAlike();
+	void finiteRoundTripsAlike();
+};
+
+#endif // JSONSERIALIZERTEST_H
@@ -0,0 +1,15 @@
+#include <QtTest>
+
+#include "filterbitstest.h"
+#include "jsonserializertest.h"
+
+///Runs every test class, the exit code is the number of tests that failed
+int main(int argc, char *argv[])
+{
+	int failures = 0;
+
+	{ FilterBitsTest test;		failures += QTest::qExec(&test, argc, argv); }
+	{ JsonSerializerTest test;	failures += QTest::qExec(&test, argc, argv); }
+
+	return failures;
+}
@@ -9,11 +9,13 @@ DESTDIR = .
 SUBDIRS += \
 	JASP-Common \
         JASP-Engine \
-        JASP-Desktop
+        JASP-Desktop \
+        JASP-Tests
 
 unix: SUBDIRS += $$JASP_R_INTERFACE_TARGET
 
 JASP-Desktop.depends = JASP-Common
 JASP-Engine.depends = JASP-Common
+JASP-Tests.depends = JASP-Common
 
 unix: JASP-Engine.depends += $$JASP_R_INTERFACE_TARGET
@@ -0,0 +1,156 @@
+//
+// Copyright (C) 2013-2018 University of Amsterdam
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+// Compares toStyledString(), JsonSerializer::compact() and JsonSerializer::messagePack() on result trees.
+// Pass it the json of some results, for instance the jaspResults.json of an analysis in the temporary folder or the analyses.json inside a .jasp file.
+// Without arguments it makes up results with a few hundred tables.
+//
+// Build from the root of the repository with:
+//   g++ -std=c++11 -O2 -DJASP_LIBJSON_STATIC -IJASP-Common Tools/benchmarks/jsonserializerbenchmark.cpp JASP-Common/jsonserializer.cpp JASP-Common/enginedefinitions.cpp JASP-Common/lib_json/json_*.cpp -o jsonserializerbenchmark
+
+#include "jsonserializer.h"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+Json::Value madeUpResults(int tables, int rows)
+{
+	Json::Value results(Json::objectValue), meta(Json::arrayValue);
+
+	results["title"] = "Made up results";
+
+	for(int t=0; t<tables; t++)
+	{
+		std::string name = "table" + std::to_string(t);
+
+		Json::Value table(Json::objectValue), schema(Json::arrayValue), data(Json::arrayValue);
+
+		for(const char * column : { "variable", "mean", "sd", "t", "df", "p" })
+		{
+			Json::Value field(Json::objectValue);
+			field["name"]	= column;
+			field["title"]	= column;
+			field["type"]	= std::string(column) == "variable" ? "string" : "number";
+			field["format"]	= "sf:4;dp:3";
+			schema.append(field);
+		}
+
+		for(int r=0; r<rows; r++)
+		{
+			Json::Value row(Json::objectValue);
+			row["variable"]	= "variable " + std::to_string(r);
+			row["mean"]		= 0.1 * r + t / 7.0;
+			row["sd"]		= 1.0 / (r + 1.5);
+			row["t"]		= (r - 12.3) / 3.1;
+			row["df"]		= r + t;
+			row["p"]		= 1.0 / (1.0 + r * r);
+			data.append(row);
+		}
+
+		table["title"]				= "Table " + std::to_string(t);
+		table["name"]				= name;
+		table["schema"]["fields"]	= schema;
+		table["data"]				= data;
+		table["status"]				= "complete";
+		table["footnotes"]			= Json::arrayValue;
+
+		Json::Value metaEntry(Json::objectValue);
+		metaEntry["name"] = name;
+		metaEntry["type"] = "table";
+		meta.append(metaEntry);
+
+		results[name] = table;
+	}
+
+	results[".meta"] = meta;
+
+	//Plots and other analyses often send whole vectors of doubles
+	Json::Value samples(Json::arrayValue);
+	for(int i=0; i<10000; i++)
+		samples.append(std::sin(i * 0.001) * 3.3);
+	results["samples"] = samples;
+
+	return results;
+}
+
+double millisecondsPerRun(std::function<void()> run, int runs)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	for(int i=0; i<runs; i++)
+		run();
+
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+}
+
+void benchmark(const std::string & name, const Json::Value & results, int runs)
+{
+	std::string styled		= results.toStyledString(),
+				compact		= JsonSerializer::compact(results),
+				messagePack	= JsonSerializer::messagePack(results);
+
+	Json::Value parsed;
+
+	double	writeStyled			= millisecondsPerRun([&]() { styled			= results.toStyledString();									}, runs),
+			writeCompact		= millisecondsPerRun([&]() { compact		= JsonSerializer::compact(results);							}, runs),
+			writeMessagePack	= millisecondsPerRun([&]() { messagePack	= JsonSerializer::messagePack(results);						}, runs),
+			readStyled			= millisecondsPerRun([&]() { JsonSerializer::parse(styled.data(),		styled.size(),		parsed);	}, runs),
+			readCompact			= millisecondsPerRun([&]() { JsonSerializer::parse(compact.data(),		compact.size(),		parsed);	}, runs),
+			readMessagePack		= millisecondsPerRun([&]() { JsonSerializer::parse(messagePack.data(),	messagePack.size(),	parsed);	}, runs);
+
+	std::cout << name << "\n"
+			  << std::setw(14) << "" << std::setw(12) << "bytes" << std::setw(12) << "write ms" << std::setw(12) << "read ms" << "\n" << std::fixed << std::setprecision(3)
+			  << std::setw(14) << "styled"		<< std::setw(12) << styled.size()		<< std::setw(12) << writeStyled			<< std::setw(12) << readStyled		<< "\n"
+			  << std::setw(14) << "compact"		<< std::setw(12) << compact.size()		<< std::setw(12) << writeCompact		<< std::setw(12) << readCompact		<< "\n"
+			  << std::setw(14) << "messagePack"	<< std::setw(12) << messagePack.size()	<< std::setw(12) << writeMessagePack	<< std::setw(12) << readMessagePack	<< "\n\n";
+}
+
+int main(int argc, char * argv[])
+{
+	const int runs = 20;
+
+	if(argc < 2)
+	{
+		benchmark("made up results, 300 tables of 25 rows", madeUpResults(300, 25), runs);
+		return 0;
+	}
+
+	for(int arg=1; arg<argc; arg++)
+	{
+		std::ifstream		file(argv[arg]);
+		std::stringstream	contents;
+		Json::Value			results;
+
+		contents << file.rdbuf();
+		std::string text = contents.str();
+
+		if(!JsonSerializer::parse(text.data(), text.size(), results))
+		{
+			std::cerr << "Could not read " << argv[arg] << " as json\n";
+			continue;
+		}
+
+		benchmark(argv[arg], results, runs);
+	}
+
+	return 0;
+}